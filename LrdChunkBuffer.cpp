@@ -0,0 +1,235 @@
+/******************************************************************************
+** Copyright (C) 2016 Laird
+**
+** Project: UwTerminalX
+**
+** Module: LrdChunkBuffer.cpp
+**
+** Notes:
+**
+** License: This program is free software: you can redistribute it and/or
+**          modify it under the terms of the GNU General Public License as
+**          published by the Free Software Foundation, version 3.
+**
+**          This program is distributed in the hope that it will be useful,
+**          but WITHOUT ANY WARRANTY; without even the implied warranty of
+**          MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+**          GNU General Public License for more details.
+**
+**          You should have received a copy of the GNU General Public License
+**          along with this program.  If not, see http://www.gnu.org/licenses/
+**
+*******************************************************************************/
+/******************************************************************************/
+// Include Files
+/******************************************************************************/
+#include "LrdChunkBuffer.h"
+#include <algorithm>
+
+/******************************************************************************/
+// Local Functions or Private Members
+/******************************************************************************/
+LrdChunkBuffer::LrdChunkBuffer(
+    )
+{
+    //Empty buffer
+    mintStart = 0;
+    mintEnd = 0;
+}
+
+//=============================================================================
+//=============================================================================
+void
+LrdChunkBuffer::Append(
+    const QByteArray &baData
+    )
+{
+    //Adds received data to the end of the buffer. Large reads are kept as their own chunk (sharing the data rather than copying it) and small reads are merged into the last chunk, data already in the buffer is never moved
+    if (baData.isEmpty())
+    {
+        return;
+    }
+    else if (!mlstChunks.isEmpty() && mlstChunks.last().length() + baData.length() <= ChunkBufferMergeSize)
+    {
+        mlstChunks.last().append(baData);
+    }
+    else
+    {
+        mlstChunks.append(baData);
+        mlstChunkStarts.append(mintEnd);
+    }
+    mintEnd += baData.length();
+}
+
+//=============================================================================
+//=============================================================================
+void
+LrdChunkBuffer::Clear(
+    )
+{
+    //Removes all data, stream positions start again from 0
+    mlstChunks.clear();
+    mlstChunkStarts.clear();
+    mintStart = 0;
+    mintEnd = 0;
+}
+
+//=============================================================================
+//=============================================================================
+void
+LrdChunkBuffer::Consume(
+    qint64 intPosition
+    )
+{
+    //Marks the data before a stream position as consumed, chunks which have been completely consumed are freed. Partly consumed chunks are kept as they are so that nothing is copied
+    mintStart = qBound(mintStart, intPosition, mintEnd);
+    while (!mlstChunks.isEmpty() && mlstChunkStarts.first() + mlstChunks.first().length() <= mintStart)
+    {
+        mlstChunks.removeFirst();
+        mlstChunkStarts.removeFirst();
+    }
+}
+
+//=============================================================================
+//=============================================================================
+qint64
+LrdChunkBuffer::Start(
+    ) const
+{
+    //Returns the stream position of the first byte which has not been consumed
+    return mintStart;
+}
+
+//=============================================================================
+//=============================================================================
+qint64
+LrdChunkBuffer::End(
+    ) const
+{
+    //Returns the stream position after the last byte received
+    return mintEnd;
+}
+
+//=============================================================================
+//=============================================================================
+qint64
+LrdChunkBuffer::Length(
+    ) const
+{
+    //Returns the number of bytes which have not been consumed
+    return mintEnd - mintStart;
+}
+
+//=============================================================================
+//=============================================================================
+int
+LrdChunkBuffer::FindChunk(
+    qint64 intPosition
+    ) const
+{
+    //Returns the index of the chunk containing a stream position
+    return (std::upper_bound(mlstChunkStarts.constBegin(), mlstChunkStarts.constEnd(), intPosition) - mlstChunkStarts.constBegin()) - 1;
+}
+
+//=============================================================================
+//=============================================================================
+int
+LrdChunkBuffer::Data(
+    qint64 intPosition,
+    const char **ppchData
+    ) const
+{
+    //Points to the data at a stream position, returns the number of bytes which follow it in the same chunk (0 at the end of the buffer)
+    if (intPosition < mintStart || intPosition >= mintEnd)
+    {
+        *ppchData = 0;
+        return 0;
+    }
+    int intChunk = FindChunk(intPosition);
+    int intOffset = intPosition - mlstChunkStarts.at(intChunk);
+    *ppchData = mlstChunks.at(intChunk).constData() + intOffset;
+    return mlstChunks.at(intChunk).length() - intOffset;
+}
+
+//=============================================================================
+//=============================================================================
+QByteArray
+LrdChunkBuffer::Mid(
+    qint64 intPosition,
+    qint64 intLength
+    ) const
+{
+    //Returns a copy of the data between two stream positions (for regular expressions and logging, which need the data in one piece)
+    QByteArray baData;
+    intPosition = qMax(intPosition, mintStart);
+    qint64 intEndPosition = qMin(intPosition + intLength, mintEnd);
+    if (intEndPosition <= intPosition)
+    {
+        return baData;
+    }
+    baData.reserve(intEndPosition - intPosition);
+    while (intPosition < intEndPosition)
+    {
+        const char *pchData;
+        int intChunkLength = qMin((qint64)Data(intPosition, &pchData), intEndPosition - intPosition);
+        baData.append(pchData, intChunkLength);
+        intPosition += intChunkLength;
+    }
+    return baData;
+}
+
+//=============================================================================
+//=============================================================================
+qint64
+LrdChunkBuffer::Search(
+    LrdStreamMatcher *pmatMatcher,
+    qint64 intPosition
+    ) const
+{
+    //Feeds the data from a stream position to the end of the buffer to a matcher one chunk at a time, returns the stream position after the end of the match or -1 if it has not been found yet
+    const char *pchData;
+    int intLength;
+    do
+    {
+        //The matcher is also given the (empty) end of the buffer so that an empty pattern matches
+        intLength = Data(intPosition, &pchData);
+        int intFound = pmatMatcher->Feed(pchData, intLength);
+        if (intFound != -1)
+        {
+            return intPosition + intFound;
+        }
+        intPosition += intLength;
+    }
+    while (intLength > 0);
+    return -1;
+}
+
+//=============================================================================
+//=============================================================================
+qint64
+LrdChunkBuffer::Search(
+    LrdMultiMatcher *pmatMatcher,
+    qint64 intPosition
+    ) const
+{
+    //Feeds the data from a stream position to the end of the buffer to an automaton one chunk at a time, returns the stream position after the end of the first match or -1 if none has been found yet
+    const char *pchData;
+    int intLength;
+    do
+    {
+        //The matcher is also given the (empty) end of the buffer so that an empty pattern matches
+        intLength = Data(intPosition, &pchData);
+        int intFound = pmatMatcher->Feed(pchData, intLength);
+        if (intFound != -1)
+        {
+            return intPosition + intFound;
+        }
+        intPosition += intLength;
+    }
+    while (intLength > 0);
+    return -1;
+}
+
+/******************************************************************************/
+// END OF FILE
+/******************************************************************************/
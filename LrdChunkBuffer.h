@@ -0,0 +1,104 @@
+/******************************************************************************
+** Copyright (C) 2016 Laird
+**
+** Project: UwTerminalX
+**
+** Module: LrdChunkBuffer.h
+**
+** Notes:
+**
+** License: This program is free software: you can redistribute it and/or
+**          modify it under the terms of the GNU General Public License as
+**          published by the Free Software Foundation, version 3.
+**
+**          This program is distributed in the hope that it will be useful,
+**          but WITHOUT ANY WARRANTY; without even the implied warranty of
+**          MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+**          GNU General Public License for more details.
+**
+**          You should have received a copy of the GNU General Public License
+**          along with this program.  If not, see http://www.gnu.org/licenses/
+**
+*******************************************************************************/
+#ifndef LRDCHUNKBUFFER_H
+#define LRDCHUNKBUFFER_H
+
+/******************************************************************************/
+// Include Files
+/******************************************************************************/
+#include <QByteArray>
+#include <QList>
+#include "LrdStreamMatcher.h"
+#include "LrdMultiMatcher.h"
+
+/******************************************************************************/
+// Defines
+/******************************************************************************/
+#define ChunkBufferMergeSize           4096  //Received data is added to the last chunk (rather than starting a new one) whilst the chunk is smaller than this, so that small reads do not create many tiny chunks
+
+/******************************************************************************/
+// Class definitions
+/******************************************************************************/
+class LrdChunkBuffer
+{
+public:
+    LrdChunkBuffer(
+        );
+    void
+    Append(
+        const QByteArray &baData
+        );
+    void
+    Clear(
+        );
+    void
+    Consume(
+        qint64 intPosition
+        );
+    qint64
+    Start(
+        ) const;
+    qint64
+    End(
+        ) const;
+    qint64
+    Length(
+        ) const;
+    int
+    Data(
+        qint64 intPosition,
+        const char **ppchData
+        ) const;
+    QByteArray
+    Mid(
+        qint64 intPosition,
+        qint64 intLength
+        ) const;
+    qint64
+    Search(
+        LrdStreamMatcher *pmatMatcher,
+        qint64 intPosition
+        ) const;
+    qint64
+    Search(
+        LrdMultiMatcher *pmatMatcher,
+        qint64 intPosition
+        ) const;
+
+private:
+    int
+    FindChunk(
+        qint64 intPosition
+        ) const;
+
+    QList<QByteArray> mlstChunks; //Received data, in the order it was received
+    QList<qint64> mlstChunkStarts; //Stream position of the first byte of each chunk
+    qint64 mintStart; //Stream position of the first byte which has not been consumed
+    qint64 mintEnd; //Stream position after the last byte received
+};
+
+#endif // LRDCHUNKBUFFER_H
+
+/******************************************************************************/
+// END OF FILE
+/******************************************************************************/
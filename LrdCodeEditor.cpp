@@ -37,6 +37,7 @@ LrdCodeEditor::LrdCodeEditor(QWidget *parent) : QPlainTextEdit(parent)
     //Connect signals to slots
     connect(this, SIGNAL(updateRequest(QRect,int)), this, SLOT(updateLineNumberArea(QRect,int)));
     connect(this, SIGNAL(cursorPositionChanged()), this, SLOT(highlightCurrentLine()));
+    connect(this, SIGNAL(blockCountChanged(int)), this, SLOT(LineCountChanged(int)));
 
     //Set the margins for the viewport
     setViewportMargins(IndicationAreaWidth, 0, 0, 0);
@@ -58,6 +59,7 @@ LrdCodeEditor::~LrdCodeEditor()
     //Disconnect all signals
     disconnect(this, SIGNAL(updateRequest(QRect,int)), this, SLOT(updateLineNumberArea(QRect,int)));
     disconnect(this, SIGNAL(cursorPositionChanged()), this, SLOT(highlightCurrentLine()));
+    disconnect(this, SIGNAL(blockCountChanged(int)), this, SLOT(LineCountChanged(int)));
 
     //Delete indication area widget
     delete mwidIndicationArea;
@@ -81,6 +83,21 @@ LrdCodeEditor::updateLineNumberArea(
     }
 }
 
+//=============================================================================
+//=============================================================================
+void
+LrdCodeEditor::LineCountChanged(
+    int
+    )
+{
+    //Lines have been added or removed so the line numbers of invalid lines from the last compile no longer apply, syntax errors are still shown from the block state
+    if (!msetInvLines.isEmpty())
+    {
+        msetInvLines.clear();
+        mwidIndicationArea->update();
+    }
+}
+
 //=============================================================================
 //=============================================================================
 void
@@ -144,7 +161,13 @@ LrdCodeEditor::lineNumberAreaPaintEvent(
     {
         if (tbTextBlock.isVisible() && intBottom >= event->rect().top())
         {
-            if (mlistInvLines.contains(intBlockNumber))
+            if (mhashLineHeat.contains(intBlockNumber))
+            {
+                //Profiled line, colour from blue (little time) to red (most time)
+                pntPainter.fillRect(0, intTop, mwidIndicationArea->width(), intBottom - intTop, QColor::fromHsvF((1.0 - mhashLineHeat.value(intBlockNumber))*0.66, 1.0, 1.0));
+            }
+
+            if (tbTextBlock.userState() == HighlighterLineInvalid || msetInvLines.contains(intBlockNumber))
             {
                 //Paint line as bad
                 pntPainter.drawEllipse(1, intTop+4, mwidIndicationArea->width()-3, fontMetrics().height()-7);
@@ -203,7 +226,7 @@ LrdCodeEditor::ClearBadLines(
     )
 {
     //Clears list of invalid lines
-    mlistInvLines.clear();
+    msetInvLines.clear();
     mbLineFail = false;
 }
 
@@ -215,7 +238,7 @@ LrdCodeEditor::AddBadLine(
     )
 {
     //Marks a line as being invalid
-    mlistInvLines.append(uintLineNumber);
+    msetInvLines.insert(uintLineNumber);
 }
 
 //=============================================================================
@@ -225,9 +248,9 @@ LrdCodeEditor::SetExecutionLine(
     int intLineNumber
     )
 {
-    //Sets the current line that is being executed and repaints the object
+    //Sets the current line that is being executed, the repaint is queued so that lines which run without waiting only cause one repaint
     mintCLine = intLineNumber;
-    this->repaint();
+    this->update();
 }
 
 //=============================================================================
@@ -242,6 +265,18 @@ LrdCodeEditor::SetExecutionLineStatus(
     this->repaint();
 }
 
+//=============================================================================
+//=============================================================================
+void
+LrdCodeEditor::SetLineHeat(
+    const QHash<int, double> &hashHeat
+    )
+{
+    //Sets the profiling heatmap (empty to clear it) and repaints the object
+    mhashLineHeat = hashHeat;
+    this->update();
+}
+
 /******************************************************************************/
 // END OF FILE
 /******************************************************************************/
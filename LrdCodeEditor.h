@@ -29,6 +29,8 @@
 #include <QPlainTextEdit>
 #include <QObject>
 #include <QtWidgets>
+#include <QSet>
+#include "LrdHighlighter.h"
 
 /******************************************************************************/
 // Defines
@@ -77,6 +79,10 @@ public:
     void SetExecutionLineStatus(
         bool bStatus
         );
+    void
+    SetLineHeat(
+        const QHash<int, double> &hashHeat
+        );
 
 protected:
     void
@@ -96,12 +102,17 @@ private slots:
     updateLineNumberArea(
         const QRect &, int
         );
+    void
+    LineCountChanged(
+        int intLineCount
+        );
 
 private:
     QWidget *mwidIndicationArea;
-    QList<unsigned int> mlistInvLines; //Contains a list of invalid lines
+    QSet<int> msetInvLines; //Invalid lines found when the script was last compiled (lines with syntax errors are also marked as they are edited using the block state)
     int mintCLine; //Current execution line (if there is one)
     bool mbLineFail; //True if the current line is where the script failed or false if it is currently executing
+    QHash<int, double> mhashLineHeat; //Proportion (0-1) of the script run time spent on each profiled line, shown as a heatmap
 };
 
 class LineNumberArea : public QWidget
@@ -0,0 +1,108 @@
+/******************************************************************************
+** Copyright (C) 2016 Laird
+**
+** Project: UwTerminalX
+**
+** Module: LrdCrc32.cpp
+**
+** Notes:
+**
+** License: This program is free software: you can redistribute it and/or
+**          modify it under the terms of the GNU General Public License as
+**          published by the Free Software Foundation, version 3.
+**
+**          This program is distributed in the hope that it will be useful,
+**          but WITHOUT ANY WARRANTY; without even the implied warranty of
+**          MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+**          GNU General Public License for more details.
+**
+**          You should have received a copy of the GNU General Public License
+**          along with this program.  If not, see http://www.gnu.org/licenses/
+**
+*******************************************************************************/
+
+/******************************************************************************/
+// Include Files
+/******************************************************************************/
+#include "LrdCrc32.h"
+
+/******************************************************************************/
+// Local Functions or Private Members
+/******************************************************************************/
+quint32 LrdCrc32::mintTables[8][256];
+bool LrdCrc32::mbTablesBuilt = false;
+
+//=============================================================================
+//=============================================================================
+quint32
+LrdCrc32::Calculate(
+    const char *pchData,
+    qint64 intLength,
+    quint32 intCrc
+    )
+{
+    //Calculates the CRC-32 of a buffer 8 bytes at a time, intCrc can be a previous result to continue a calculation
+    if (mbTablesBuilt == false)
+    {
+        BuildTables();
+    }
+
+    const uchar *pucData = (const uchar *)pchData;
+    intCrc = ~intCrc;
+    while (intLength >= 8)
+    {
+        quint32 intLow = qFromLittleEndian<quint32>(pucData) ^ intCrc;
+        quint32 intHigh = qFromLittleEndian<quint32>(pucData + 4);
+        intCrc = mintTables[7][intLow & 0xFF] ^ mintTables[6][(intLow >> 8) & 0xFF] ^ mintTables[5][(intLow >> 16) & 0xFF] ^ mintTables[4][intLow >> 24] ^
+                 mintTables[3][intHigh & 0xFF] ^ mintTables[2][(intHigh >> 8) & 0xFF] ^ mintTables[1][(intHigh >> 16) & 0xFF] ^ mintTables[0][intHigh >> 24];
+        pucData += 8;
+        intLength -= 8;
+    }
+    while (intLength > 0)
+    {
+        //Remaining bytes
+        intCrc = mintTables[0][(intCrc ^ *pucData) & 0xFF] ^ (intCrc >> 8);
+        ++pucData;
+        --intLength;
+    }
+    return ~intCrc;
+}
+
+//=============================================================================
+//=============================================================================
+void
+LrdCrc32::BuildTables(
+    )
+{
+    //Generates the lookup tables, table n is the CRC of a byte followed by n zero bytes
+    int i = 0;
+    while (i < 256)
+    {
+        quint32 intCrc = i;
+        int j = 0;
+        while (j < 8)
+        {
+            intCrc = (intCrc & 1 ? (intCrc >> 1) ^ Crc32Polynomial : intCrc >> 1);
+            ++j;
+        }
+        mintTables[0][i] = intCrc;
+        ++i;
+    }
+
+    i = 0;
+    while (i < 256)
+    {
+        int j = 1;
+        while (j < 8)
+        {
+            mintTables[j][i] = (mintTables[j-1][i] >> 8) ^ mintTables[0][mintTables[j-1][i] & 0xFF];
+            ++j;
+        }
+        ++i;
+    }
+    mbTablesBuilt = true;
+}
+
+/******************************************************************************/
+// END OF FILE
+/******************************************************************************/
@@ -0,0 +1,63 @@
+/******************************************************************************
+** Copyright (C) 2016 Laird
+**
+** Project: UwTerminalX
+**
+** Module: LrdCrc32.h
+**
+** Notes:
+**
+** License: This program is free software: you can redistribute it and/or
+**          modify it under the terms of the GNU General Public License as
+**          published by the Free Software Foundation, version 3.
+**
+**          This program is distributed in the hope that it will be useful,
+**          but WITHOUT ANY WARRANTY; without even the implied warranty of
+**          MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+**          GNU General Public License for more details.
+**
+**          You should have received a copy of the GNU General Public License
+**          along with this program.  If not, see http://www.gnu.org/licenses/
+**
+*******************************************************************************/
+#ifndef LRDCRC32_H
+#define LRDCRC32_H
+
+/******************************************************************************/
+// Include Files
+/******************************************************************************/
+#include <QtGlobal>
+#include <QtEndian>
+
+/******************************************************************************/
+// Defines
+/******************************************************************************/
+#define Crc32Polynomial                   0xEDB88320 //Reflected CRC-32 (IEEE 802.3) polynomial
+
+/******************************************************************************/
+// Class definitions
+/******************************************************************************/
+class LrdCrc32
+{
+public:
+    static quint32
+    Calculate(
+        const char *pchData,
+        qint64 intLength,
+        quint32 intCrc = 0
+        );
+
+private:
+    static void
+    BuildTables(
+        );
+
+    static quint32 mintTables[8][256]; //Slice-by-8 lookup tables
+    static bool mbTablesBuilt; //True once the lookup tables have been generated
+};
+
+#endif // LRDCRC32_H
+
+/******************************************************************************/
+// END OF FILE
+/******************************************************************************/
@@ -0,0 +1,135 @@
+/******************************************************************************
+** Copyright (C) 2016 Laird
+**
+** Project: UwTerminalX
+**
+** Module: LrdDataVerifier.cpp
+**
+** Notes:
+**
+** License: This program is free software: you can redistribute it and/or
+**          modify it under the terms of the GNU General Public License as
+**          published by the Free Software Foundation, version 3.
+**
+**          This program is distributed in the hope that it will be useful,
+**          but WITHOUT ANY WARRANTY; without even the implied warranty of
+**          MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+**          GNU General Public License for more details.
+**
+**          You should have received a copy of the GNU General Public License
+**          along with this program.  If not, see http://www.gnu.org/licenses/
+**
+*******************************************************************************/
+
+/******************************************************************************/
+// Include Files
+/******************************************************************************/
+#include "LrdDataVerifier.h"
+#include <string.h>
+
+/******************************************************************************/
+// Local Functions or Private Members
+/******************************************************************************/
+LrdDataVerifier::LrdDataVerifier(
+    )
+{
+    //Initial values
+    mintMatchIndex = 0;
+}
+
+//=============================================================================
+//=============================================================================
+void
+LrdDataVerifier::SetMatchData(
+    const QByteArray &baMatchData
+    )
+{
+    //Sets the data which is expected to be received (repeatedly) and starts matching from its beginning
+    mbaMatchData = baMatchData;
+    mintMatchIndex = 0;
+}
+
+//=============================================================================
+//=============================================================================
+void
+LrdDataVerifier::Reset(
+    )
+{
+    //Starts matching from the beginning of the match data
+    mintMatchIndex = 0;
+}
+
+//=============================================================================
+//=============================================================================
+quint64
+LrdDataVerifier::Verify(
+    const char *pchData,
+    qint64 intLength,
+    quint64 *pintMatched,
+    QList<LrdDataMismatch> *plstMismatches
+    )
+{
+    //Compares received data against the match data in place, so no received data needs to be kept between calls. The number of complete copies of the match data received is added to pintMatched and the number of mismatches is returned, details of each mismatch are added to plstMismatches if it is not NULL
+    const char *pchMatchData = mbaMatchData.constData();
+    qint64 intMatchLength = mbaMatchData.length();
+    quint64 intErrors = 0;
+    qint64 intPosition = 0;
+    if (intMatchLength == 0)
+    {
+        //Nothing to match against
+        return 0;
+    }
+
+    while (intPosition < intLength)
+    {
+        //Data to check
+        qint64 intSizeToTest = intMatchLength - mintMatchIndex;
+        if (intSizeToTest > intLength - intPosition)
+        {
+            intSizeToTest = intLength - intPosition;
+        }
+
+        if (memcmp(&pchData[intPosition], &pchMatchData[mintMatchIndex], intSizeToTest) == 0)
+        {
+            //Good
+            intPosition += intSizeToTest;
+            mintMatchIndex += intSizeToTest;
+            if (mintMatchIndex >= intMatchLength)
+            {
+                ++*pintMatched;
+                mintMatchIndex = 0;
+            }
+        }
+        else
+        {
+            //Bad
+            ++intErrors;
+            if (plstMismatches != NULL)
+            {
+                LrdDataMismatch dmMismatch;
+                dmMismatch.baExpected = QByteArray(&pchMatchData[mintMatchIndex], intSizeToTest);
+                dmMismatch.baReceived = QByteArray(&pchData[intPosition], intSizeToTest);
+                plstMismatches->append(dmMismatch);
+            }
+
+            //Search for start character (ignoring first character) and resynchronise from there
+            const char *pchStart = (const char *)memchr(&pchData[intPosition + 1], pchMatchData[0], intLength - intPosition - 1);
+            if (pchStart == NULL)
+            {
+                //Not found, discard the rest of the received data
+                intPosition = intLength;
+            }
+            else
+            {
+                //Found, skip to this character
+                intPosition = pchStart - pchData;
+            }
+            mintMatchIndex = 0;
+        }
+    }
+    return intErrors;
+}
+
+/******************************************************************************/
+// END OF FILE
+/******************************************************************************/
@@ -0,0 +1,74 @@
+/******************************************************************************
+** Copyright (C) 2016 Laird
+**
+** Project: UwTerminalX
+**
+** Module: LrdDataVerifier.h
+**
+** Notes:
+**
+** License: This program is free software: you can redistribute it and/or
+**          modify it under the terms of the GNU General Public License as
+**          published by the Free Software Foundation, version 3.
+**
+**          This program is distributed in the hope that it will be useful,
+**          but WITHOUT ANY WARRANTY; without even the implied warranty of
+**          MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+**          GNU General Public License for more details.
+**
+**          You should have received a copy of the GNU General Public License
+**          along with this program.  If not, see http://www.gnu.org/licenses/
+**
+*******************************************************************************/
+#ifndef LRDDATAVERIFIER_H
+#define LRDDATAVERIFIER_H
+
+/******************************************************************************/
+// Include Files
+/******************************************************************************/
+#include <QtGlobal>
+#include <QByteArray>
+#include <QList>
+
+/******************************************************************************/
+// Forward declaration of Class, Struct & Unions
+/******************************************************************************/
+struct LrdDataMismatch
+{
+    QByteArray baExpected; //Data that was expected
+    QByteArray baReceived; //Data that was received instead
+};
+
+/******************************************************************************/
+// Class definitions
+/******************************************************************************/
+class LrdDataVerifier
+{
+public:
+    LrdDataVerifier(
+        );
+    void
+    SetMatchData(
+        const QByteArray &baMatchData
+        );
+    void
+    Reset(
+        );
+    quint64
+    Verify(
+        const char *pchData,
+        qint64 intLength,
+        quint64 *pintMatched,
+        QList<LrdDataMismatch> *plstMismatches = NULL
+        );
+
+private:
+    QByteArray mbaMatchData; //Data which is expected to be received repeatedly
+    qint64 mintMatchIndex; //Position in the match data that the next received byte should match
+};
+
+#endif // LRDDATAVERIFIER_H
+
+/******************************************************************************/
+// END OF FILE
+/******************************************************************************/
@@ -25,6 +25,8 @@
 // Include Files
 /******************************************************************************/
 #include "LrdHighlighter.h"
+#include "LrdScriptCompiler.h"
+#include <QTextDocument>
 
 /******************************************************************************/
 // Local Functions or Private Members
@@ -35,18 +37,27 @@ LrdHighlighter::LrdHighlighter(QTextDocument *parent) : QSyntaxHighlighter(paren
     OutPattern.setPattern("^\\<");
     InPattern.setPattern("^\\>");
     WaitPattern.setPattern("^\\~");
+    RegexPattern.setPattern("^\\?");
+    ControlPattern.setPattern("^#[A-Za-z]+");
+    VariablePattern.setPattern("\\$\\{[A-Za-z0-9_]+\\}");
     CommentPattern.setPattern("^//[^\n|\r]*");
 
     //Set pattern options
     OutPattern.setPatternOptions(QRegularExpression::MultilineOption);
     InPattern.setPatternOptions(QRegularExpression::MultilineOption);
     WaitPattern.setPatternOptions(QRegularExpression::MultilineOption);
+    RegexPattern.setPatternOptions(QRegularExpression::MultilineOption);
+    ControlPattern.setPatternOptions(QRegularExpression::MultilineOption);
+    VariablePattern.setPatternOptions(QRegularExpression::MultilineOption);
     CommentPattern.setPatternOptions(QRegularExpression::MultilineOption);
 
     //Optimise regular expression patterns
     OutPattern.optimize();
     InPattern.optimize();
     WaitPattern.optimize();
+    RegexPattern.optimize();
+    ControlPattern.optimize();
+    VariablePattern.optimize();
     CommentPattern.optimize();
 
     //Configure formatting for lines
@@ -56,6 +67,9 @@ LrdHighlighter::LrdHighlighter(QTextDocument *parent) : QSyntaxHighlighter(paren
     //Configure formatting for comments
     CommentFormat.setFontWeight(QFont::Normal);
     CommentFormat.setForeground(Qt::darkGreen);
+
+    //Configure formatting for variables
+    VariableFormat.setForeground(Qt::darkBlue);
 }
 
 //=============================================================================
@@ -68,6 +82,19 @@ LrdHighlighter::highlightBlock(
     QRegularExpressionMatchIterator nextmatch;
     QString texta = QString(text).replace(QChar(0x2028), "\n");
 
+    if (LrdScriptCompiler::IsJavaScript(document()->firstBlock().text()) == true)
+    {
+        //JavaScript is checked by the engine when compiled, only comments are highlighted
+        nextmatch = CommentPattern.globalMatch(texta);
+        while (nextmatch.hasNext())
+        {
+            QRegularExpressionMatch ThisMatch = nextmatch.next();
+            setFormat(ThisMatch.capturedStart(), ThisMatch.capturedLength(), CommentFormat);
+        }
+        setCurrentBlockState(HighlighterLineValid);
+        return;
+    }
+
     nextmatch = OutPattern.globalMatch(texta);
     while (nextmatch.hasNext())
     {
@@ -86,13 +113,33 @@ LrdHighlighter::highlightBlock(
         QRegularExpressionMatch ThisMatch = nextmatch.next();
         setFormat(ThisMatch.capturedStart(), ThisMatch.capturedLength(), LineFormat);
     }
+    nextmatch = RegexPattern.globalMatch(texta);
+    while (nextmatch.hasNext())
+    {
+        QRegularExpressionMatch ThisMatch = nextmatch.next();
+        setFormat(ThisMatch.capturedStart(), ThisMatch.capturedLength(), LineFormat);
+    }
+    nextmatch = ControlPattern.globalMatch(texta);
+    while (nextmatch.hasNext())
+    {
+        QRegularExpressionMatch ThisMatch = nextmatch.next();
+        setFormat(ThisMatch.capturedStart(), ThisMatch.capturedLength(), LineFormat);
+    }
+    nextmatch = VariablePattern.globalMatch(texta);
+    while (nextmatch.hasNext())
+    {
+        QRegularExpressionMatch ThisMatch = nextmatch.next();
+        setFormat(ThisMatch.capturedStart(), ThisMatch.capturedLength(), VariableFormat);
+    }
     nextmatch = CommentPattern.globalMatch(texta);
     while (nextmatch.hasNext())
     {
         QRegularExpressionMatch ThisMatch = nextmatch.next();
         setFormat(ThisMatch.capturedStart(), ThisMatch.capturedLength(), CommentFormat);
     }
-    setCurrentBlockState(0);
+
+    //Only edited lines are highlighted, so check the syntax of the line here and keep the result in the block state for the editor to show
+    setCurrentBlockState(LrdScriptCompiler::CheckLine(text) == true ? HighlighterLineValid : HighlighterLineInvalid);
 }
 
 /******************************************************************************/
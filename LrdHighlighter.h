@@ -30,6 +30,12 @@
 #include <QTextCharFormat>
 #include <QRegularExpression>
 
+/******************************************************************************/
+// Defines
+/******************************************************************************/
+#define HighlighterLineValid           1     //Block state for a line with valid syntax
+#define HighlighterLineInvalid         2     //Block state for a line with a syntax error
+
 /******************************************************************************/
 // Forward declaration of Class, Struct & Unions
 /******************************************************************************/
@@ -59,9 +65,13 @@ private:
     QRegularExpression OutPattern; //Matches sending data lines
     QRegularExpression InPattern; //Matches receiving data lines
     QRegularExpression WaitPattern; //Matches time waiting lines
+    QRegularExpression RegexPattern; //Matches regular expression receiving data lines
+    QRegularExpression ControlPattern; //Matches loop, counter and condition statements
+    QRegularExpression VariablePattern; //Matches variables in sending data lines
     QRegularExpression CommentPattern; //Matches comment lines
     QTextCharFormat LineFormat; //Format for valid lines
     QTextCharFormat CommentFormat; //Format for comment lines
+    QTextCharFormat VariableFormat; //Format for variables
 };
 
 #endif // LRDHIGHLIGHTER_H
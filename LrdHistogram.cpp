@@ -0,0 +1,192 @@
+/******************************************************************************
+** Copyright (C) 2016 Laird
+**
+** Project: UwTerminalX
+**
+** Module: LrdHistogram.cpp
+**
+** Notes:
+**
+** License: This program is free software: you can redistribute it and/or
+**          modify it under the terms of the GNU General Public License as
+**          published by the Free Software Foundation, version 3.
+**
+**          This program is distributed in the hope that it will be useful,
+**          but WITHOUT ANY WARRANTY; without even the implied warranty of
+**          MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+**          GNU General Public License for more details.
+**
+**          You should have received a copy of the GNU General Public License
+**          along with this program.  If not, see http://www.gnu.org/licenses/
+**
+*******************************************************************************/
+
+/******************************************************************************/
+// Include Files
+/******************************************************************************/
+#include "LrdHistogram.h"
+
+/******************************************************************************/
+// Local Functions or Private Members
+/******************************************************************************/
+LrdHistogram::LrdHistogram(
+    )
+{
+    //Initial values
+    mvecBuckets.resize(HistogramBucketCount);
+    Reset();
+}
+
+//=============================================================================
+//=============================================================================
+void
+LrdHistogram::Reset(
+    )
+{
+    //Clears all recorded values
+    mvecBuckets.fill(0);
+    mintCount = 0;
+    mintMin = 0;
+    mintMax = 0;
+    mintTotal = 0;
+}
+
+//=============================================================================
+//=============================================================================
+void
+LrdHistogram::Record(
+    quint64 intValue
+    )
+{
+    //Adds a value to the histogram
+    ++mvecBuckets[BucketIndex(intValue)];
+    if (mintCount == 0 || intValue < mintMin)
+    {
+        mintMin = intValue;
+    }
+    if (intValue > mintMax)
+    {
+        mintMax = intValue;
+    }
+    ++mintCount;
+    mintTotal += intValue;
+}
+
+//=============================================================================
+//=============================================================================
+quint64
+LrdHistogram::Count(
+    ) const
+{
+    return mintCount;
+}
+
+//=============================================================================
+//=============================================================================
+quint64
+LrdHistogram::Min(
+    ) const
+{
+    return mintMin;
+}
+
+//=============================================================================
+//=============================================================================
+quint64
+LrdHistogram::Max(
+    ) const
+{
+    return mintMax;
+}
+
+//=============================================================================
+//=============================================================================
+double
+LrdHistogram::Mean(
+    ) const
+{
+    return (mintCount == 0 ? 0.0 : (double)mintTotal/(double)mintCount);
+}
+
+//=============================================================================
+//=============================================================================
+quint64
+LrdHistogram::Percentile(
+    double dblPercentile
+    ) const
+{
+    //Returns the value which the given percentage of recorded values are less than or equal to
+    if (mintCount == 0)
+    {
+        return 0;
+    }
+
+    quint64 intTarget = (quint64)((dblPercentile/100.0)*(double)mintCount + 0.5);
+    if (intTarget < 1)
+    {
+        intTarget = 1;
+    }
+    else if (intTarget > mintCount)
+    {
+        intTarget = mintCount;
+    }
+
+    quint64 intTotal = 0;
+    int i = 0;
+    while (i < mvecBuckets.count())
+    {
+        intTotal += mvecBuckets.at(i);
+        if (intTotal >= intTarget)
+        {
+            //Found the bucket, report the highest value it can hold (but never more than the highest recorded value)
+            quint64 intValue = BucketValue(i);
+            return (intValue > mintMax ? mintMax : intValue);
+        }
+        ++i;
+    }
+    return mintMax;
+}
+
+//=============================================================================
+//=============================================================================
+int
+LrdHistogram::BucketIndex(
+    quint64 intValue
+    )
+{
+    //Values below 2*HistogramSubBucketCount are stored exactly, larger values are split into HistogramSubBucketCount linear buckets per power of 2
+    if (intValue < (quint64)(HistogramSubBucketCount*2))
+    {
+        return (int)intValue;
+    }
+
+    int intBit = 63;
+    while ((intValue >> intBit) == 0)
+    {
+        --intBit;
+    }
+    int intShift = intBit - HistogramSubBucketBits;
+    return HistogramSubBucketCount*2 + (intShift - 1)*HistogramSubBucketCount + (int)((intValue >> intShift) - HistogramSubBucketCount);
+}
+
+//=============================================================================
+//=============================================================================
+quint64
+LrdHistogram::BucketValue(
+    int intIndex
+    )
+{
+    //Returns the highest value which is stored in a bucket
+    if (intIndex < HistogramSubBucketCount*2)
+    {
+        return (quint64)intIndex;
+    }
+
+    int intShift = (intIndex - HistogramSubBucketCount*2)/HistogramSubBucketCount + 1;
+    quint64 intTop = (quint64)((intIndex - HistogramSubBucketCount*2) % HistogramSubBucketCount + HistogramSubBucketCount);
+    return ((intTop + 1) << intShift) - 1;
+}
+
+/******************************************************************************/
+// END OF FILE
+/******************************************************************************/
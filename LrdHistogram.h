@@ -0,0 +1,92 @@
+/******************************************************************************
+** Copyright (C) 2016 Laird
+**
+** Project: UwTerminalX
+**
+** Module: LrdHistogram.h
+**
+** Notes:
+**
+** License: This program is free software: you can redistribute it and/or
+**          modify it under the terms of the GNU General Public License as
+**          published by the Free Software Foundation, version 3.
+**
+**          This program is distributed in the hope that it will be useful,
+**          but WITHOUT ANY WARRANTY; without even the implied warranty of
+**          MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+**          GNU General Public License for more details.
+**
+**          You should have received a copy of the GNU General Public License
+**          along with this program.  If not, see http://www.gnu.org/licenses/
+**
+*******************************************************************************/
+#ifndef LRDHISTOGRAM_H
+#define LRDHISTOGRAM_H
+
+/******************************************************************************/
+// Include Files
+/******************************************************************************/
+#include <QtGlobal>
+#include <QVector>
+
+/******************************************************************************/
+// Defines
+/******************************************************************************/
+#define HistogramSubBucketBits            7       //Number of bits of precision kept for each value (7 bits = worst case error of 1/128)
+#define HistogramSubBucketCount           (1 << HistogramSubBucketBits)
+#define HistogramBucketCount              (HistogramSubBucketCount*2 + (64 - HistogramSubBucketBits - 1)*HistogramSubBucketCount)
+
+/******************************************************************************/
+// Class definitions
+/******************************************************************************/
+class LrdHistogram
+{
+public:
+    LrdHistogram(
+        );
+    void
+    Reset(
+        );
+    void
+    Record(
+        quint64 intValue
+        );
+    quint64
+    Count(
+        ) const;
+    quint64
+    Min(
+        ) const;
+    quint64
+    Max(
+        ) const;
+    double
+    Mean(
+        ) const;
+    quint64
+    Percentile(
+        double dblPercentile
+        ) const;
+
+private:
+    static int
+    BucketIndex(
+        quint64 intValue
+        );
+    static quint64
+    BucketValue(
+        int intIndex
+        );
+
+    QVector<quint64> mvecBuckets; //Number of values recorded in each bucket
+    quint64 mintCount; //Total number of values recorded
+    quint64 mintMin; //Lowest value recorded
+    quint64 mintMax; //Highest value recorded
+    quint64 mintTotal; //Sum of all values recorded
+};
+
+#endif // LRDHISTOGRAM_H
+
+/******************************************************************************/
+// END OF FILE
+/******************************************************************************/
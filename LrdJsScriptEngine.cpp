@@ -0,0 +1,515 @@
+/******************************************************************************
+** Copyright (C) 2016 Laird
+**
+** Project: UwTerminalX
+**
+** Module: LrdJsScriptEngine.cpp
+**
+** Notes:
+**
+** License: This program is free software: you can redistribute it and/or
+**          modify it under the terms of the GNU General Public License as
+**          published by the Free Software Foundation, version 3.
+**
+**          This program is distributed in the hope that it will be useful,
+**          but WITHOUT ANY WARRANTY; without even the implied warranty of
+**          MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+**          GNU General Public License for more details.
+**
+**          You should have received a copy of the GNU General Public License
+**          along with this program.  If not, see http://www.gnu.org/licenses/
+**
+*******************************************************************************/
+/******************************************************************************/
+// Include Files
+/******************************************************************************/
+#include "LrdJsScriptEngine.h"
+
+/******************************************************************************/
+// Local Functions or Private Members
+/******************************************************************************/
+LrdJsScriptEngine::LrdJsScriptEngine(QObject *parent) : QObject(parent)
+{
+    //Not running
+    mjsEngine = 0;
+    mbIsRunning = false;
+    mbAwaitingResult = false;
+    mbExpecting = false;
+    mbExpectRegex = false;
+    mintRecvTimeout = 0;
+    mintRecvBufSize = 0;
+    mintRecvScanned = 0;
+
+    //Setup expect timeout timer
+    mtmrExpectTimer.setSingleShot(true);
+    connect(&mtmrExpectTimer, SIGNAL(timeout()), this, SLOT(ExpectTimeout()));
+}
+
+//=============================================================================
+//=============================================================================
+LrdJsScriptEngine::~LrdJsScriptEngine(
+    )
+{
+    //Stop any running script
+    Stop();
+    disconnect(&mtmrExpectTimer, SIGNAL(timeout()), this, SLOT(ExpectTimeout()));
+}
+
+//=============================================================================
+//=============================================================================
+bool
+LrdJsScriptEngine::Compile(
+    const QString &strSource,
+    int *pintErrorLine,
+    QString *pstrError
+    )
+{
+    //Checks the script for syntax errors by compiling it as the body of a function without calling it. The function starts on the first line of the script so line numbers are unchanged
+    QJSEngine jsEngine;
+    QJSValue jsResult = jsEngine.evaluate(QString("(function() {").append(strSource).append("\n})"), "script", 1);
+    if (jsResult.isError())
+    {
+        //Syntax error
+        *pintErrorLine = jsResult.property("lineNumber").toInt() - 1;
+        *pstrError = jsResult.toString();
+        return false;
+    }
+    return true;
+}
+
+//=============================================================================
+//=============================================================================
+void
+LrdJsScriptEngine::Run(
+    const QString &strSource,
+    int intRecvTimeout,
+    int intRecvBufSize
+    )
+{
+    //Runs a script. The script is compiled by the engine as the body of a function: if it returns a promise (e.g. a chain of expect() and sleep() calls) the script finishes when the promise settles, otherwise it finishes once it has nothing left to wait for
+    Stop();
+    mintRecvTimeout = intRecvTimeout;
+    mintRecvBufSize = intRecvBufSize;
+    mbaRecvData.clear();
+    mintRecvScanned = 0;
+    mbAwaitingResult = false;
+    mbIsRunning = true;
+
+    //Create the engine and the script API. send(), expect(), sleep() and log() are global functions, expect() and sleep() return promises
+    mjsEngine = new QJSEngine(this);
+    mjsEngine->installExtensions(QJSEngine::ConsoleExtension);
+    QJSEngine::setObjectOwnership(this, QJSEngine::CppOwnership);
+    mjsEngine->globalObject().setProperty(JsScriptApiName, mjsEngine->newQObject(this));
+    QString strPrelude = QString("var send = function(data) { ").append(JsScriptApiName).append(".Send(data); };\n");
+    strPrelude.append("var log = function(message) { ").append(JsScriptApiName).append(".Log(String(message)); };\n");
+    strPrelude.append("var sleep = function(time) { return new Promise(function(resolve) { ").append(JsScriptApiName).append(".Sleep(time, resolve); }); };\n");
+    strPrelude.append("var expect = function(pattern, timeout) { return new Promise(function(resolve, reject) { ").append(JsScriptApiName).append(".Expect((pattern instanceof RegExp ? pattern.source : String(pattern)), (pattern instanceof RegExp ? (pattern.flags !== undefined ? pattern.flags : (pattern.global ? \"g\" : \"\") + (pattern.ignoreCase ? \"i\" : \"\") + (pattern.multiline ? \"m\" : \"\")) : \"\"), (pattern instanceof RegExp), (timeout === undefined ? -1 : timeout), resolve, reject); }); };\n");
+    strPrelude.append("var ").append(JsScriptApiName).append("Watch = function(result) { result.then(function(value) { ").append(JsScriptApiName).append(".Finished(true, value); }, function(error) { ").append(JsScriptApiName).append(".Finished(false, error); }); };\n");
+    mjsEngine->evaluate(strPrelude, "prelude", 1);
+
+    if (mjsEngine->evaluate("typeof Promise").toString() != "function")
+    {
+        //Promises are only supported by the engine from Qt 5.12
+        Finish(false, QString("JavaScript scripts require Qt 5.12 or later, this version of Qt (").append(qVersion()).append(") does not support promises."), -1);
+        return;
+    }
+
+    //Compile the script
+    QJSValue jsMain = mjsEngine->evaluate(QString("(function() {").append(strSource).append("\n})"), "script", 1);
+    if (jsMain.isError())
+    {
+        //Syntax error
+        Finish(false, jsMain.toString(), jsMain.property("lineNumber").toInt() - 1);
+        return;
+    }
+
+    //Run it
+    QJSValue jsResult = jsMain.call();
+    if (mbIsRunning == false)
+    {
+        //Finished or stopped whilst running
+        return;
+    }
+    else if (jsResult.isError())
+    {
+        //Uncaught exception
+        Finish(false, jsResult.toString(), jsResult.property("lineNumber").toInt() - 1);
+        return;
+    }
+    else if (jsResult.isObject() && jsResult.property("then").isCallable())
+    {
+        //Promise returned, wait for it
+        mbAwaitingResult = true;
+        mjsEngine->globalObject().property(QString(JsScriptApiName).append("Watch")).call(QJSValueList() << jsResult);
+        return;
+    }
+
+    //Finish once nothing is pending
+    OperationDone();
+}
+
+//=============================================================================
+//=============================================================================
+void
+LrdJsScriptEngine::Stop(
+    )
+{
+    //Stops the script, pending operations are dropped and the engine is deleted so the script cannot continue
+    mbIsRunning = false;
+    mbAwaitingResult = false;
+    mbExpecting = false;
+    mtmrExpectTimer.stop();
+    mjsExpectResolve = QJSValue();
+    mjsExpectReject = QJSValue();
+    QHash<QTimer *, QJSValue>::iterator itSleep = mhashSleeps.begin();
+    while (itSleep != mhashSleeps.end())
+    {
+        itSleep.key()->stop();
+        itSleep.key()->deleteLater();
+        ++itSleep;
+    }
+    mhashSleeps.clear();
+    if (mjsEngine != 0)
+    {
+        //Deleted later as this may be called from the script
+        mjsEngine->deleteLater();
+        mjsEngine = 0;
+    }
+}
+
+//=============================================================================
+//=============================================================================
+bool
+LrdJsScriptEngine::IsRunning(
+    )
+{
+    //Returns true if a script is running
+    return mbIsRunning;
+}
+
+//=============================================================================
+//=============================================================================
+void
+LrdJsScriptEngine::DataReceived(
+    const QByteArray &baData
+    )
+{
+    //Data has been received from the device
+    if (mbIsRunning == true)
+    {
+        mbaRecvData.append(baData);
+        if (mbExpecting == true)
+        {
+            CheckExpect();
+        }
+    }
+}
+
+//=============================================================================
+//=============================================================================
+void
+LrdJsScriptEngine::Send(
+    const QJSValue &jsData
+    )
+{
+    //send(data): sends a string (as UTF-8) or an ArrayBuffer (as is), data which has not been matched by expect() is discarded as for > lines
+    if (mbIsRunning == true)
+    {
+        QVariant varData = jsData.toVariant();
+        mbaRecvData.clear();
+        mintRecvScanned = 0;
+        mmatExpect.Reset();
+        emit SendData(varData.type() == QVariant::ByteArray ? varData.toByteArray() : jsData.toString().toUtf8());
+    }
+}
+
+//=============================================================================
+//=============================================================================
+void
+LrdJsScriptEngine::Log(
+    const QString &strMessage
+    )
+{
+    //log(message): outputs a message
+    if (mbIsRunning == true)
+    {
+        emit LogMessage(strMessage);
+    }
+}
+
+//=============================================================================
+//=============================================================================
+void
+LrdJsScriptEngine::Sleep(
+    int intTime,
+    const QJSValue &jsResolve
+    )
+{
+    //sleep(time): resolves after the time (in ms) has elapsed
+    if (mbIsRunning == true)
+    {
+        QTimer *tmrSleep = new QTimer(this);
+        tmrSleep->setSingleShot(true);
+        tmrSleep->setTimerType(Qt::PreciseTimer);
+        connect(tmrSleep, SIGNAL(timeout()), this, SLOT(SleepElapsed()));
+        mhashSleeps.insert(tmrSleep, jsResolve);
+        tmrSleep->start(intTime > 0 ? intTime : 0);
+    }
+}
+
+//=============================================================================
+//=============================================================================
+void
+LrdJsScriptEngine::SleepElapsed(
+    )
+{
+    //A sleep has finished
+    QTimer *tmrSleep = qobject_cast<QTimer *>(sender());
+    if (tmrSleep != 0 && mhashSleeps.contains(tmrSleep))
+    {
+        QJSValue jsResolve = mhashSleeps.take(tmrSleep);
+        tmrSleep->deleteLater();
+        jsResolve.call();
+        OperationDone();
+    }
+}
+
+//=============================================================================
+//=============================================================================
+void
+LrdJsScriptEngine::Expect(
+    const QString &strPattern,
+    const QString &strFlags,
+    bool bRegex,
+    int intTimeout,
+    const QJSValue &jsResolve,
+    const QJSValue &jsReject
+    )
+{
+    //expect(pattern, timeout): resolves with the matched string (or an array of the match and capture groups for a RegExp) once matching data is received, data up to the end of the match is consumed. Rejects if the data is not received within the timeout (in ms)
+    if (mbIsRunning == false)
+    {
+        return;
+    }
+    else if (mbExpecting == true)
+    {
+        //Only one expect() can wait at a time
+        jsReject.call(QJSValueList() << QJSValue("expect() called whilst another expect() is waiting"));
+        return;
+    }
+
+    mbExpectRegex = bRegex;
+    if (bRegex == true)
+    {
+        //Received data is matched as Latin-1 so that offsets are byte offsets, the pattern is encoded as UTF-8 in the same way so that its text matches the same bytes as a string pattern would (. and character classes match single bytes). RegExp flags are mapped to pattern options, g has no effect as expect() only looks for one match
+        QRegularExpression::PatternOptions poOptions = QRegularExpression::NoPatternOption;
+        int i = 0;
+        while (i < strFlags.length())
+        {
+            if (strFlags.at(i) == 'i')
+            {
+                poOptions |= QRegularExpression::CaseInsensitiveOption;
+            }
+            else if (strFlags.at(i) == 'm')
+            {
+                poOptions |= QRegularExpression::MultilineOption;
+            }
+            else if (strFlags.at(i) == 's')
+            {
+                poOptions |= QRegularExpression::DotMatchesEverythingOption;
+            }
+            else if (strFlags.at(i) != 'g')
+            {
+                //Unsupported flag (e.g. y or u)
+                jsReject.call(QJSValueList() << QJSValue(QString("Unsupported regular expression flag: ").append(strFlags.at(i))));
+                return;
+            }
+            ++i;
+        }
+        mreExpect.setPattern(QString::fromLatin1(strPattern.toUtf8()));
+        mreExpect.setPatternOptions(poOptions);
+        if (mreExpect.isValid() == false)
+        {
+            jsReject.call(QJSValueList() << QJSValue(QString("Invalid regular expression: ").append(mreExpect.errorString())));
+            return;
+        }
+    }
+    else
+    {
+        mmatExpect.SetPattern(strPattern.toUtf8());
+    }
+    mintRecvScanned = 0;
+    mjsExpectResolve = jsResolve;
+    mjsExpectReject = jsReject;
+    mbExpecting = true;
+    mtmrExpectTimer.start(intTimeout >= 0 ? intTimeout : mintRecvTimeout);
+
+    //Data may already have been received, check it once the script has returned to the event loop
+    QTimer::singleShot(0, this, SLOT(CheckExpect()));
+}
+
+//=============================================================================
+//=============================================================================
+void
+LrdJsScriptEngine::CheckExpect(
+    )
+{
+    //Checks if the data expect() is waiting for has been received
+    if (mbIsRunning == false || mbExpecting == false)
+    {
+        return;
+    }
+
+    QJSValue jsMatch;
+    int intEnd = -1;
+    if (mbExpectRegex == true)
+    {
+        //Regular expression. Data before the earliest position that a match (or partial match) could start at is never searched again
+        QString strWindow = QString::fromLatin1(mbaRecvData.constData() + mintRecvScanned, mbaRecvData.length() - mintRecvScanned);
+        QRegularExpressionMatch remMatch = mreExpect.match(strWindow);
+        if (remMatch.hasMatch() == false)
+        {
+            //No complete match, find where a match could still begin once more data arrives
+            remMatch = mreExpect.match(strWindow, 0, QRegularExpression::PartialPreferFirstMatch);
+            mintRecvScanned += (remMatch.hasPartialMatch() == true ? remMatch.capturedStart(0) : strWindow.length());
+        }
+        else
+        {
+            intEnd = mintRecvScanned + remMatch.capturedEnd(0);
+            jsMatch = mjsEngine->newArray(remMatch.lastCapturedIndex() + 1);
+            int i = 0;
+            while (i <= remMatch.lastCapturedIndex())
+            {
+                jsMatch.setProperty(i, QString::fromUtf8(remMatch.captured(i).toLatin1()));
+                ++i;
+            }
+        }
+    }
+    else
+    {
+        //Only data which has not been searched yet is passed to the matcher
+        int intFound = mmatExpect.Feed(mbaRecvData.constData() + mintRecvScanned, mbaRecvData.length() - mintRecvScanned);
+        if (intFound == -1)
+        {
+            mintRecvScanned = mbaRecvData.length();
+        }
+        else
+        {
+            intEnd = mintRecvScanned + intFound;
+            jsMatch = QJSValue(QString::fromUtf8(mbaRecvData.mid(intEnd - mmatExpect.PatternLength(), mmatExpect.PatternLength())));
+        }
+    }
+
+    if (intEnd == -1)
+    {
+        //Not found yet
+        if (mbaRecvData.length() > mintRecvBufSize)
+        {
+            Reject(QString("expected data not found after ").append(QString::number(mintRecvBufSize)).append(" bytes (").append(QString::number(mbaRecvData.length())).append(" bytes in buffer)"));
+        }
+        return;
+    }
+
+    //Consume the data up to the end of the match and resolve the promise
+    mbaRecvData.remove(0, intEnd);
+    mintRecvScanned = 0;
+    mbExpecting = false;
+    mtmrExpectTimer.stop();
+    QJSValue jsResolve = mjsExpectResolve;
+    mjsExpectResolve = QJSValue();
+    mjsExpectReject = QJSValue();
+    jsResolve.call(QJSValueList() << jsMatch);
+    OperationDone();
+}
+
+//=============================================================================
+//=============================================================================
+void
+LrdJsScriptEngine::ExpectTimeout(
+    )
+{
+    //Data was not received in time
+    if (mbIsRunning == true && mbExpecting == true)
+    {
+        Reject(QString("expected data not found after ").append(QString::number(mtmrExpectTimer.interval())).append("ms (").append(QString::number(mbaRecvData.length())).append(" bytes in buffer)"));
+    }
+}
+
+//=============================================================================
+//=============================================================================
+void
+LrdJsScriptEngine::Reject(
+    const QString &strMessage
+    )
+{
+    //Rejects the promise returned by expect(). If the script did not return a promise nothing can report the failure, so the script fails
+    mbExpecting = false;
+    mtmrExpectTimer.stop();
+    QJSValue jsReject = mjsExpectReject;
+    mjsExpectResolve = QJSValue();
+    mjsExpectReject = QJSValue();
+    jsReject.call(QJSValueList() << QJSValue(strMessage));
+    if (mbIsRunning == true && mbAwaitingResult == false)
+    {
+        Finish(false, strMessage, -1);
+    }
+}
+
+//=============================================================================
+//=============================================================================
+void
+LrdJsScriptEngine::Finished(
+    bool bPassed,
+    const QJSValue &jsResult
+    )
+{
+    //The promise returned by the script has settled
+    if (mbIsRunning == true && mbAwaitingResult == true)
+    {
+        Finish(bPassed, (bPassed == true || jsResult.isUndefined() ? QString() : jsResult.toString()), (jsResult.isError() ? jsResult.property("lineNumber").toInt() - 1 : -1));
+    }
+}
+
+//=============================================================================
+//=============================================================================
+void
+LrdJsScriptEngine::OperationDone(
+    )
+{
+    //An operation has finished, scripts which did not return a promise finish once nothing is pending. This is checked later so that promise reactions to the operation (which run from the event loop) can start new operations first
+    if (mbIsRunning == true && mbAwaitingResult == false)
+    {
+        QTimer::singleShot(JsScriptIdleTime, this, SLOT(CheckIdle()));
+    }
+}
+
+//=============================================================================
+//=============================================================================
+void
+LrdJsScriptEngine::CheckIdle(
+    )
+{
+    //Finishes the script if it has nothing left to wait for
+    if (mbIsRunning == true && mbAwaitingResult == false && mbExpecting == false && mhashSleeps.isEmpty())
+    {
+        Finish(true, QString(), -1);
+    }
+}
+
+//=============================================================================
+//=============================================================================
+void
+LrdJsScriptEngine::Finish(
+    bool bPassed,
+    const QString &strMessage,
+    int intLine
+    )
+{
+    //Script has finished
+    Stop();
+    emit ScriptFinished(bPassed, strMessage, intLine);
+}
+
+/******************************************************************************/
+// END OF FILE
+/******************************************************************************/
@@ -0,0 +1,176 @@
+/******************************************************************************
+** Copyright (C) 2016 Laird
+**
+** Project: UwTerminalX
+**
+** Module: LrdJsScriptEngine.h
+**
+** Notes:
+**
+** License: This program is free software: you can redistribute it and/or
+**          modify it under the terms of the GNU General Public License as
+**          published by the Free Software Foundation, version 3.
+**
+**          This program is distributed in the hope that it will be useful,
+**          but WITHOUT ANY WARRANTY; without even the implied warranty of
+**          MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+**          GNU General Public License for more details.
+**
+**          You should have received a copy of the GNU General Public License
+**          along with this program.  If not, see http://www.gnu.org/licenses/
+**
+*******************************************************************************/
+#ifndef LRDJSSCRIPTENGINE_H
+#define LRDJSSCRIPTENGINE_H
+
+/******************************************************************************/
+// Include Files
+/******************************************************************************/
+#include <QObject>
+#include <QString>
+#include <QByteArray>
+#include <QHash>
+#include <QTimer>
+#include <QJSEngine>
+#include <QJSValue>
+#include <QRegularExpression>
+#include "LrdStreamMatcher.h"
+
+/******************************************************************************/
+// Defines
+/******************************************************************************/
+#define JsScriptApiName                "__uwx" //Name of the global object the script API functions call into
+#define JsScriptIdleTime               20    //Time (in ms) a script which did not return a promise must have nothing pending for before it finishes
+
+/******************************************************************************/
+// Class definitions
+/******************************************************************************/
+class LrdJsScriptEngine : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit LrdJsScriptEngine(
+        QObject *parent = 0
+        );
+    ~LrdJsScriptEngine(
+        );
+    static bool
+    Compile(
+        const QString &strSource,
+        int *pintErrorLine,
+        QString *pstrError
+        );
+    void
+    Run(
+        const QString &strSource,
+        int intRecvTimeout,
+        int intRecvBufSize
+        );
+    void
+    Stop(
+        );
+    bool
+    IsRunning(
+        );
+    void
+    DataReceived(
+        const QByteArray &baData
+        );
+
+    //Functions called from the script API (see the prelude in LrdJsScriptEngine.cpp)
+    Q_INVOKABLE void
+    Send(
+        const QJSValue &jsData
+        );
+    Q_INVOKABLE void
+    Log(
+        const QString &strMessage
+        );
+    Q_INVOKABLE void
+    Sleep(
+        int intTime,
+        const QJSValue &jsResolve
+        );
+    Q_INVOKABLE void
+    Expect(
+        const QString &strPattern,
+        const QString &strFlags,
+        bool bRegex,
+        int intTimeout,
+        const QJSValue &jsResolve,
+        const QJSValue &jsReject
+        );
+    Q_INVOKABLE void
+    Finished(
+        bool bPassed,
+        const QJSValue &jsResult
+        );
+
+signals:
+    void
+    SendData(
+        const QByteArray &baData
+        );
+    void
+    LogMessage(
+        const QString &strMessage
+        );
+    void
+    ScriptFinished(
+        bool bPassed,
+        const QString &strMessage,
+        int intLine
+        );
+
+private slots:
+    void
+    SleepElapsed(
+        );
+    void
+    ExpectTimeout(
+        );
+    void
+    CheckExpect(
+        );
+    void
+    CheckIdle(
+        );
+
+private:
+    void
+    Finish(
+        bool bPassed,
+        const QString &strMessage,
+        int intLine
+        );
+    void
+    Reject(
+        const QString &strMessage
+        );
+    void
+    OperationDone(
+        );
+
+    QJSEngine *mjsEngine; //Engine running the script (created for each run so a stopped script cannot continue)
+    bool mbIsRunning; //True if a script is running
+    bool mbAwaitingResult; //True if the script returned a promise, the script finishes when it settles
+    int mintRecvTimeout; //Default time (in ms) expect() waits for data
+    int mintRecvBufSize; //Number of bytes expect() searches before failing
+    QHash<QTimer *, QJSValue> mhashSleeps; //Running sleep() timers and the functions which resolve them
+    bool mbExpecting; //True if expect() is waiting for data
+    bool mbExpectRegex; //True if expect() is waiting for a regular expression match
+    LrdStreamMatcher mmatExpect; //Matcher for the data expect() is waiting for
+    QRegularExpression mreExpect; //Expression expect() is waiting for
+    QJSValue mjsExpectResolve; //Resolves the promise returned by expect()
+    QJSValue mjsExpectReject; //Rejects the promise returned by expect()
+    QTimer mtmrExpectTimer; //Rejects expect() if the data is not received in time
+    QByteArray mbaRecvData; //Data received from the device which has not been consumed by expect()
+    int mintRecvScanned; //Number of bytes of the receive buffer which have been passed to the matcher, or before which a regular expression match cannot start
+};
+
+#endif // LRDJSSCRIPTENGINE_H
+
+/******************************************************************************/
+// END OF FILE
+/******************************************************************************/
@@ -0,0 +1,802 @@
+/******************************************************************************
+** Copyright (C) 2016 Laird
+**
+** Project: UwTerminalX
+**
+** Module: LrdLogIndex.cpp
+**
+** Notes:
+**
+** License: This program is free software: you can redistribute it and/or
+**          modify it under the terms of the GNU General Public License as
+**          published by the Free Software Foundation, version 3.
+**
+**          This program is distributed in the hope that it will be useful,
+**          but WITHOUT ANY WARRANTY; without even the implied warranty of
+**          MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+**          GNU General Public License for more details.
+**
+**          You should have received a copy of the GNU General Public License
+**          along with this program.  If not, see http://www.gnu.org/licenses/
+**
+*******************************************************************************/
+
+/******************************************************************************/
+// Include Files
+/******************************************************************************/
+#include "LrdLogIndex.h"
+#include "LrdCrc32.h"
+#include <QSaveFile>
+#include <algorithm>
+
+/******************************************************************************/
+// Defines
+/******************************************************************************/
+#define LogIndexMagic 0x55574C49 //Identifier at the start of the on-disk index
+#define Trigram(a, b, c) ((((quint32)(quint8)(a)) << 16) | (((quint32)(quint8)(b)) << 8) | ((quint32)(quint8)(c)))
+
+/******************************************************************************/
+// Local Functions or Private Members
+/******************************************************************************/
+LrdLogIndex::LrdLogIndex(QObject *parent) : QObject(parent)
+{
+    //Initial values
+    mbIndexing = false;
+    mbModified = false;
+    mintUnsavedBytes = 0;
+    mtmrSaved.start();
+}
+
+//=============================================================================
+//=============================================================================
+LrdLogIndex::~LrdLogIndex(
+    )
+{
+    if (mbModified == true)
+    {
+        //Write outstanding changes to disk
+        SaveIndex();
+    }
+}
+
+//=============================================================================
+//=============================================================================
+void
+LrdLogIndex::SetDirectory(
+    QString strDirPath
+    )
+{
+    //Changes the directory which is indexed
+    strDirPath = QDir(strDirPath).absolutePath();
+    if (strDirPath != mstrDirPath)
+    {
+        if (mbModified == true)
+        {
+            //Save index of the previous directory
+            SaveIndex();
+        }
+
+        //Load the existing index of the new directory (if one exists)
+        ClearIndex();
+        mstrDirPath = strDirPath;
+        LoadIndex();
+    }
+
+    //Index any new data
+    UpdateIndex();
+}
+
+//=============================================================================
+//=============================================================================
+void
+LrdLogIndex::UpdateIndex(
+    )
+{
+    //Checks the directory for new or changed log files
+    if (mstrDirPath.isEmpty())
+    {
+        //No directory set
+        return;
+    }
+
+    QDir dirLogDir(mstrDirPath);
+    QFileInfoList filFiles = dirLogDir.entryInfoList(QStringList() << "*.log", QDir::Files);
+
+    //Check if any indexed file has been removed, truncated or replaced, only the blocks of those files are dropped (files which still exist are then indexed again as new files)
+    QVector<bool> vecRemove(mlstFiles.count(), false);
+    bool bRemove = false;
+    int i = 0;
+    while (i < mlstFiles.count())
+    {
+        QFileInfo fiFileInfo(dirLogDir, mlstFiles.at(i).strName);
+        if (!fiFileInfo.exists() || fiFileInfo.size() < mlstFiles.at(i).intIndexed)
+        {
+            //File no longer matches the index
+            vecRemove[i] = true;
+            bRemove = true;
+        }
+        else if (mlstFiles.at(i).intIndexed > 0 && fiFileInfo.lastModified() != mlstFiles.at(i).dtModified)
+        {
+            //File has changed, check that it has grown rather than been replaced by a larger file
+            if (HeadMatches(mlstFiles.at(i)) == false)
+            {
+                vecRemove[i] = true;
+                bRemove = true;
+            }
+            else
+            {
+                mlstFiles[i].dtModified = fiFileInfo.lastModified();
+            }
+        }
+        ++i;
+    }
+
+    if (bRemove == true)
+    {
+        RemoveFiles(vecRemove);
+    }
+
+    //Queue files with unindexed data
+    i = 0;
+    while (i < filFiles.count())
+    {
+        qint32 intFile = 0;
+        while (intFile < mlstFiles.count() && mlstFiles.at(intFile).strName != filFiles.at(i).fileName())
+        {
+            ++intFile;
+        }
+
+        if (intFile == mlstFiles.count())
+        {
+            //New file
+            IndexedFile ifFile;
+            ifFile.strName = filFiles.at(i).fileName();
+            ifFile.intIndexed = 0;
+            ifFile.intHeadLength = 0;
+            ifFile.intHeadCrc = 0;
+            ifFile.intLastBlock = -1;
+            mlstFiles.append(ifFile);
+        }
+
+        if (filFiles.at(i).size() > mlstFiles.at(intFile).intIndexed && !mlstPending.contains(intFile))
+        {
+            //File has grown
+            mlstPending.append(intFile);
+        }
+        ++i;
+    }
+
+    if (mlstPending.isEmpty())
+    {
+        //Nothing to index
+        if (mbIndexing == false)
+        {
+            SaveIndexIfDue();
+            emit IndexStatus(QString("Index up to date (").append(QString::number(mlstFiles.count())).append(" files)."));
+        }
+    }
+    else if (mbIndexing == false)
+    {
+        //Begin indexing in the background
+        mbIndexing = true;
+        QMetaObject::invokeMethod(this, "IndexNextSlice", Qt::QueuedConnection);
+    }
+}
+
+//=============================================================================
+//=============================================================================
+void
+LrdLogIndex::IndexNextSlice(
+    )
+{
+    //Indexes a small number of blocks then yields so queued searches can run
+    int intBlocks = 0;
+    while (!mlstPending.isEmpty() && intBlocks < LogIndexBlocksPerSlice)
+    {
+        qint32 intFile = mlstPending.first();
+        IndexedFile &ifFile = mlstFiles[intFile];
+        QFile fileLog(QString(mstrDirPath).append("/").append(ifFile.strName));
+        if (!fileLog.open(QFile::ReadOnly))
+        {
+            //File cannot be read, skip it
+            mlstPending.removeFirst();
+            continue;
+        }
+
+        qint64 intSize = fileLog.size();
+        if (ifFile.intIndexed >= intSize)
+        {
+            //File is fully indexed
+            ifFile.dtModified = QFileInfo(fileLog).lastModified();
+            fileLog.close();
+            mlstPending.removeFirst();
+            continue;
+        }
+
+        qint32 intBlock;
+        if (ifFile.intLastBlock != -1 && ifFile.intLastBlock == mvecBlocks.count()-1 && mvecBlocks.at(ifFile.intLastBlock).intLength < LogIndexBlockSize)
+        {
+            //Grow the partial last block, it is the newest block so posting lists stay sorted
+            intBlock = ifFile.intLastBlock;
+        }
+        else
+        {
+            //Start a new block
+            IndexBlock ibBlock;
+            ibBlock.intFile = intFile;
+            ibBlock.intOffset = ifFile.intIndexed;
+            ibBlock.intLength = 0;
+            ibBlock.intPrev = ifFile.intLastBlock;
+            ibBlock.intNext = -1;
+            intBlock = mvecBlocks.count();
+            if (ifFile.intLastBlock != -1)
+            {
+                //Link to the previous block of this file
+                mvecBlocks[ifFile.intLastBlock].intNext = intBlock;
+            }
+            mvecBlocks.append(ibBlock);
+            ifFile.intLastBlock = intBlock;
+        }
+
+        //Read the block along with the two bytes before it so trigrams spanning blocks are indexed
+        qint64 intStart = mvecBlocks.at(intBlock).intOffset;
+        qint64 intPrefix = (intStart < 2 ? intStart : 2);
+        qint64 intLength = intSize - intStart;
+        if (intLength > LogIndexBlockSize)
+        {
+            intLength = LogIndexBlockSize;
+        }
+        fileLog.seek(intStart - intPrefix);
+        QByteArray baData = fileLog.read(intPrefix + intLength);
+        fileLog.close();
+
+        if (baData.length() <= intPrefix)
+        {
+            //Read failed, try again on the next update
+            mlstPending.removeFirst();
+            continue;
+        }
+
+        if (intStart == 0)
+        {
+            //Remember the start of the file so that it can be told apart from a replacement file
+            ifFile.intHeadLength = (baData.length() < LogIndexHeadSize ? baData.length() : LogIndexHeadSize);
+            ifFile.intHeadCrc = LrdCrc32::Calculate(baData.constData(), ifFile.intHeadLength);
+        }
+
+        //Add the block trigrams to the index
+        mintUnsavedBytes += baData.length() - intPrefix - mvecBlocks.at(intBlock).intLength;
+        mvecBlocks[intBlock].intLength = baData.length() - intPrefix;
+        ifFile.intIndexed = intStart + mvecBlocks.at(intBlock).intLength;
+        IndexBlockData(intBlock, baData);
+        mbModified = true;
+        ++intBlocks;
+    }
+
+    //Total up indexed data
+    qint64 intIndexed = 0;
+    int i = 0;
+    while (i < mlstFiles.count())
+    {
+        intIndexed += mlstFiles.at(i).intIndexed;
+        ++i;
+    }
+
+    if (mlstPending.isEmpty())
+    {
+        //Indexing pass complete
+        mbIndexing = false;
+        SaveIndexIfDue();
+        emit IndexStatus(QString("Index up to date (").append(QString::number(mlstFiles.count())).append(" files, ").append(QString::number(intIndexed/1048576)).append("MB)."));
+    }
+    else
+    {
+        //Continue after any queued searches
+        emit IndexStatus(QString("Indexing... (").append(QString::number(intIndexed/1048576)).append("MB)"));
+        QMetaObject::invokeMethod(this, "IndexNextSlice", Qt::QueuedConnection);
+    }
+}
+
+//=============================================================================
+//=============================================================================
+void
+LrdLogIndex::IndexBlockData(
+    qint32 intBlock,
+    const QByteArray &baData
+    )
+{
+    //Adds each distinct trigram of the data to the posting lists
+    QByteArray baLower = baData;
+    LowerCase(&baLower);
+    const char *pData = baLower.constData();
+    QVector<quint32> vecTrigrams;
+    vecTrigrams.reserve(baLower.length());
+    int i = 0;
+    while (i+2 < baLower.length())
+    {
+        vecTrigrams.append(Trigram(pData[i], pData[i+1], pData[i+2]));
+        ++i;
+    }
+    std::sort(vecTrigrams.begin(), vecTrigrams.end());
+    vecTrigrams.erase(std::unique(vecTrigrams.begin(), vecTrigrams.end()), vecTrigrams.end());
+
+    i = 0;
+    while (i < vecTrigrams.count())
+    {
+        QVector<quint32> &vecPostings = mhashPostings[vecTrigrams.at(i)];
+        if (vecPostings.isEmpty() || vecPostings.last() != (quint32)intBlock)
+        {
+            //Blocks are only ever added in ascending order
+            vecPostings.append(intBlock);
+        }
+        ++i;
+    }
+}
+
+//=============================================================================
+//=============================================================================
+bool
+LrdLogIndex::BlockContains(
+    quint32 intTrigram,
+    qint32 intBlock
+    )
+{
+    //Checks if a block contains a trigram
+    QHash<quint32, QVector<quint32> >::const_iterator itPostings = mhashPostings.constFind(intTrigram);
+    if (itPostings == mhashPostings.constEnd())
+    {
+        return false;
+    }
+    return std::binary_search(itPostings.value().constBegin(), itPostings.value().constEnd(), (quint32)intBlock);
+}
+
+//=============================================================================
+//=============================================================================
+void
+LrdLogIndex::Search(
+    QString strQuery
+    )
+{
+    //Searches the indexed logs for a (case insensitive) string
+    QElapsedTimer tmrSearch;
+    tmrSearch.start();
+    QList<LrdLogIndexHit> lstHits;
+    QByteArray baQuery = strQuery.toUtf8();
+    LowerCase(&baQuery);
+
+    if (baQuery.length() < 3 || baQuery.length() > LogIndexBlockSize)
+    {
+        //Query cannot be resolved using trigrams
+        emit SearchFinished(strQuery, lstHits, tmrSearch.nsecsElapsed()/1000);
+        return;
+    }
+
+    //Get the distinct trigrams of the query
+    QVector<quint32> vecTrigrams;
+    int i = 0;
+    while (i+2 < baQuery.length())
+    {
+        vecTrigrams.append(Trigram(baQuery.at(i), baQuery.at(i+1), baQuery.at(i+2)));
+        ++i;
+    }
+    std::sort(vecTrigrams.begin(), vecTrigrams.end());
+    vecTrigrams.erase(std::unique(vecTrigrams.begin(), vecTrigrams.end()), vecTrigrams.end());
+
+    //Find the trigram with the fewest blocks
+    const QVector<quint32> *pRarest = 0;
+    i = 0;
+    while (i < vecTrigrams.count())
+    {
+        QHash<quint32, QVector<quint32> >::const_iterator itPostings = mhashPostings.constFind(vecTrigrams.at(i));
+        if (itPostings == mhashPostings.constEnd())
+        {
+            //Trigram is not present in any log
+            emit SearchFinished(strQuery, lstHits, tmrSearch.nsecsElapsed()/1000);
+            return;
+        }
+        if (pRarest == 0 || itPostings.value().count() < pRarest->count())
+        {
+            pRarest = &itPostings.value();
+        }
+        ++i;
+    }
+
+    //A match starts either in the block containing the trigram or in an earlier block of the same file, blocks of a file that grew whilst other files were indexed can be smaller than the query so all blocks the match could span are included
+    QVector<quint32> vecCandidates;
+    vecCandidates.reserve(pRarest->count()*2);
+    i = 0;
+    while (i < pRarest->count())
+    {
+        qint32 intBlock = pRarest->at(i);
+        qint64 intSpan = 0;
+        vecCandidates.append(intBlock);
+        while (mvecBlocks.at(intBlock).intPrev != -1 && intSpan < baQuery.length())
+        {
+            intBlock = mvecBlocks.at(intBlock).intPrev;
+            vecCandidates.append(intBlock);
+            intSpan += mvecBlocks.at(intBlock).intLength;
+        }
+        ++i;
+    }
+    std::sort(vecCandidates.begin(), vecCandidates.end());
+    vecCandidates.erase(std::unique(vecCandidates.begin(), vecCandidates.end()), vecCandidates.end());
+
+    QFile fileLog;
+    i = 0;
+    while (i < vecCandidates.count() && lstHits.count() < LogIndexMaxHits)
+    {
+        //Every trigram must be in this block or one of the following blocks of the same file that a match starting in this block can reach
+        qint32 intBlock = vecCandidates.at(i);
+        const IndexBlock &ibBlock = mvecBlocks.at(intBlock);
+        QVector<qint32> vecSpan;
+        vecSpan.append(intBlock);
+        qint64 intSpan = 0;
+        qint32 intNext = ibBlock.intNext;
+        while (intNext != -1 && intSpan < baQuery.length())
+        {
+            vecSpan.append(intNext);
+            intSpan += mvecBlocks.at(intNext).intLength;
+            intNext = mvecBlocks.at(intNext).intNext;
+        }
+
+        bool bCandidate = true;
+        int j = 0;
+        while (j < vecTrigrams.count() && bCandidate == true)
+        {
+            int k = 0;
+            while (k < vecSpan.count() && !BlockContains(vecTrigrams.at(j), vecSpan.at(k)))
+            {
+                ++k;
+            }
+            bCandidate = (k < vecSpan.count());
+            ++j;
+        }
+        ++i;
+
+        if (bCandidate == false)
+        {
+            continue;
+        }
+
+        //Verify the candidate against the log file
+        QString strFilename = QString(mstrDirPath).append("/").append(mlstFiles.at(ibBlock.intFile).strName);
+        if (fileLog.fileName() != strFilename || !fileLog.isOpen())
+        {
+            fileLog.close();
+            fileLog.setFileName(strFilename);
+            if (!fileLog.open(QFile::ReadOnly))
+            {
+                //Log file has gone
+                continue;
+            }
+        }
+        fileLog.seek(ibBlock.intOffset);
+        QByteArray baData = fileLog.read(ibBlock.intLength + baQuery.length() - 1);
+        QByteArray baLower = baData;
+        LowerCase(&baLower);
+
+        int intPos = baLower.indexOf(baQuery);
+        while (intPos != -1 && intPos < ibBlock.intLength && lstHits.count() < LogIndexMaxHits)
+        {
+            //Match found, extract the line it is on
+            int intLineStart = baData.lastIndexOf('\n', intPos) + 1;
+            int intLineEnd = baData.indexOf('\n', intPos);
+            if (intLineEnd == -1)
+            {
+                intLineEnd = baData.length();
+            }
+
+            LrdLogIndexHit lihHit;
+            lihHit.strFilename = mlstFiles.at(ibBlock.intFile).strName;
+            lihHit.intOffset = ibBlock.intOffset + intPos;
+            lihHit.strPreview = QString::fromUtf8(baData.mid(intLineStart, intLineEnd-intLineStart)).trimmed().left(LogIndexMaxPreview);
+            lstHits.append(lihHit);
+
+            intPos = baLower.indexOf(baQuery, intPos+1);
+        }
+    }
+    fileLog.close();
+
+    //Return the results
+    emit SearchFinished(strQuery, lstHits, tmrSearch.nsecsElapsed()/1000);
+}
+
+//=============================================================================
+//=============================================================================
+void
+LrdLogIndex::ClearIndex(
+    )
+{
+    //Empties the index
+    mlstFiles.clear();
+    mvecBlocks.clear();
+    mhashPostings.clear();
+    mlstPending.clear();
+    mbModified = false;
+    mintUnsavedBytes = 0;
+    mtmrSaved.start();
+}
+
+//=============================================================================
+//=============================================================================
+void
+LrdLogIndex::RemoveFiles(
+    const QVector<bool> &vecRemove
+    )
+{
+    //Removes files and their blocks from the index. Files and blocks are renumbered in order, so posting lists stay sorted
+    QVector<qint32> vecFileMap(mlstFiles.count());
+    QList<IndexedFile> lstFiles;
+    int i = 0;
+    while (i < mlstFiles.count())
+    {
+        if (vecRemove.at(i) == true)
+        {
+            vecFileMap[i] = -1;
+        }
+        else
+        {
+            vecFileMap[i] = lstFiles.count();
+            lstFiles.append(mlstFiles.at(i));
+        }
+        ++i;
+    }
+
+    QVector<qint32> vecBlockMap(mvecBlocks.count());
+    QVector<IndexBlock> vecBlocks;
+    vecBlocks.reserve(mvecBlocks.count());
+    i = 0;
+    while (i < mvecBlocks.count())
+    {
+        if (vecFileMap.at(mvecBlocks.at(i).intFile) == -1)
+        {
+            vecBlockMap[i] = -1;
+        }
+        else
+        {
+            vecBlockMap[i] = vecBlocks.count();
+            vecBlocks.append(mvecBlocks.at(i));
+            vecBlocks.last().intFile = vecFileMap.at(mvecBlocks.at(i).intFile);
+        }
+        ++i;
+    }
+
+    //Blocks are only linked to blocks of the same file, which are all kept
+    i = 0;
+    while (i < vecBlocks.count())
+    {
+        if (vecBlocks.at(i).intPrev != -1)
+        {
+            vecBlocks[i].intPrev = vecBlockMap.at(vecBlocks.at(i).intPrev);
+        }
+        if (vecBlocks.at(i).intNext != -1)
+        {
+            vecBlocks[i].intNext = vecBlockMap.at(vecBlocks.at(i).intNext);
+        }
+        ++i;
+    }
+    i = 0;
+    while (i < lstFiles.count())
+    {
+        if (lstFiles.at(i).intLastBlock != -1)
+        {
+            lstFiles[i].intLastBlock = vecBlockMap.at(lstFiles.at(i).intLastBlock);
+        }
+        ++i;
+    }
+
+    //Renumber the postings, trigrams which are no longer in any block are dropped
+    QHash<quint32, QVector<quint32> >::iterator itPostings = mhashPostings.begin();
+    while (itPostings != mhashPostings.end())
+    {
+        QVector<quint32> &vecPostings = itPostings.value();
+        int intKept = 0;
+        i = 0;
+        while (i < vecPostings.count())
+        {
+            if (vecBlockMap.at(vecPostings.at(i)) != -1)
+            {
+                vecPostings[intKept] = vecBlockMap.at(vecPostings.at(i));
+                ++intKept;
+            }
+            ++i;
+        }
+
+        if (intKept == 0)
+        {
+            itPostings = mhashPostings.erase(itPostings);
+        }
+        else
+        {
+            vecPostings.resize(intKept);
+            ++itPostings;
+        }
+    }
+
+    //Renumber files waiting to be indexed
+    QList<qint32> lstPending;
+    i = 0;
+    while (i < mlstPending.count())
+    {
+        if (vecFileMap.at(mlstPending.at(i)) != -1)
+        {
+            lstPending.append(vecFileMap.at(mlstPending.at(i)));
+        }
+        ++i;
+    }
+
+    mlstFiles = lstFiles;
+    mvecBlocks = vecBlocks;
+    mlstPending = lstPending;
+    mbModified = true;
+}
+
+//=============================================================================
+//=============================================================================
+bool
+LrdLogIndex::HeadMatches(
+    const IndexedFile &ifFile
+    )
+{
+    //Checks that the start of a log file is the same as when it was first indexed
+    QFile fileLog(QString(mstrDirPath).append("/").append(ifFile.strName));
+    if (!fileLog.open(QFile::ReadOnly))
+    {
+        //File cannot be read, assume it is unchanged and check it again later
+        return true;
+    }
+    QByteArray baHead = fileLog.read(ifFile.intHeadLength);
+    fileLog.close();
+    return (baHead.length() == ifFile.intHeadLength && LrdCrc32::Calculate(baHead.constData(), baHead.length()) == ifFile.intHeadCrc);
+}
+
+//=============================================================================
+//=============================================================================
+bool
+LrdLogIndex::LoadIndex(
+    )
+{
+    //Loads the on-disk index for the current directory
+    QFile fileIndex(QString(mstrDirPath).append("/").append(LogIndexFilename));
+    if (!fileIndex.open(QFile::ReadOnly))
+    {
+        //No index
+        return false;
+    }
+
+    QDataStream dsStream(&fileIndex);
+    dsStream.setVersion(QDataStream::Qt_5_0);
+    quint32 intMagic;
+    quint32 intVersion;
+    qint32 intCount;
+    dsStream >> intMagic >> intVersion;
+    if (intMagic != LogIndexMagic || intVersion != LogIndexFileVersion)
+    {
+        //Unknown format, will be rebuilt
+        fileIndex.close();
+        return false;
+    }
+
+    //Read file list
+    dsStream >> intCount;
+    while (intCount > 0 && dsStream.status() == QDataStream::Ok)
+    {
+        IndexedFile ifFile;
+        dsStream >> ifFile.strName >> ifFile.intIndexed >> ifFile.dtModified >> ifFile.intHeadLength >> ifFile.intHeadCrc >> ifFile.intLastBlock;
+        mlstFiles.append(ifFile);
+        --intCount;
+    }
+
+    //Read block list
+    dsStream >> intCount;
+    mvecBlocks.reserve(intCount);
+    while (intCount > 0 && dsStream.status() == QDataStream::Ok)
+    {
+        IndexBlock ibBlock;
+        dsStream >> ibBlock.intFile >> ibBlock.intOffset >> ibBlock.intLength >> ibBlock.intPrev >> ibBlock.intNext;
+        mvecBlocks.append(ibBlock);
+        --intCount;
+    }
+
+    //Read postings
+    dsStream >> mhashPostings;
+    fileIndex.close();
+
+    if (dsStream.status() != QDataStream::Ok)
+    {
+        //Index is corrupt, will be rebuilt
+        ClearIndex();
+        return false;
+    }
+
+    return true;
+}
+
+//=============================================================================
+//=============================================================================
+void
+LrdLogIndex::SaveIndex(
+    )
+{
+    //Writes the index to disk
+    if (mstrDirPath.isEmpty())
+    {
+        return;
+    }
+
+    QSaveFile fileIndex(QString(mstrDirPath).append("/").append(LogIndexFilename));
+    if (!fileIndex.open(QFile::WriteOnly))
+    {
+        //Directory is not writable, index is kept in memory only
+        return;
+    }
+
+    QDataStream dsStream(&fileIndex);
+    dsStream.setVersion(QDataStream::Qt_5_0);
+    dsStream << (quint32)LogIndexMagic << (quint32)LogIndexFileVersion;
+
+    //Write file list
+    dsStream << (qint32)mlstFiles.count();
+    int i = 0;
+    while (i < mlstFiles.count())
+    {
+        dsStream << mlstFiles.at(i).strName << mlstFiles.at(i).intIndexed << mlstFiles.at(i).dtModified << mlstFiles.at(i).intHeadLength << mlstFiles.at(i).intHeadCrc << mlstFiles.at(i).intLastBlock;
+        ++i;
+    }
+
+    //Write block list
+    dsStream << (qint32)mvecBlocks.count();
+    i = 0;
+    while (i < mvecBlocks.count())
+    {
+        dsStream << mvecBlocks.at(i).intFile << mvecBlocks.at(i).intOffset << mvecBlocks.at(i).intLength << mvecBlocks.at(i).intPrev << mvecBlocks.at(i).intNext;
+        ++i;
+    }
+
+    //Write postings
+    dsStream << mhashPostings;
+
+    if (fileIndex.commit())
+    {
+        mbModified = false;
+        mintUnsavedBytes = 0;
+        mtmrSaved.start();
+    }
+}
+
+//=============================================================================
+//=============================================================================
+void
+LrdLogIndex::SaveIndexIfDue(
+    )
+{
+    //Writes the index to disk once enough new data has been indexed or changes have been outstanding for long enough. The whole index is written each time so it is not saved after every update of a log that is constantly growing
+    if (mbModified == true && (mintUnsavedBytes >= LogIndexSaveBytes || mtmrSaved.hasExpired(LogIndexSaveInterval)))
+    {
+        SaveIndex();
+    }
+}
+
+//=============================================================================
+//=============================================================================
+void
+LrdLogIndex::LowerCase(
+    QByteArray *baData
+    )
+{
+    //Converts ASCII characters to lower case (other bytes are left unchanged)
+    char *pData = baData->data();
+    int i = 0;
+    while (i < baData->length())
+    {
+        if (pData[i] >= 'A' && pData[i] <= 'Z')
+        {
+            pData[i] = pData[i] + ('a' - 'A');
+        }
+        ++i;
+    }
+}
+
+/******************************************************************************/
+// END OF FILE
+/******************************************************************************/
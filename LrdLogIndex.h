@@ -0,0 +1,181 @@
+/******************************************************************************
+** Copyright (C) 2016 Laird
+**
+** Project: UwTerminalX
+**
+** Module: LrdLogIndex.h
+**
+** Notes:
+**
+** License: This program is free software: you can redistribute it and/or
+**          modify it under the terms of the GNU General Public License as
+**          published by the Free Software Foundation, version 3.
+**
+**          This program is distributed in the hope that it will be useful,
+**          but WITHOUT ANY WARRANTY; without even the implied warranty of
+**          MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+**          GNU General Public License for more details.
+**
+**          You should have received a copy of the GNU General Public License
+**          along with this program.  If not, see http://www.gnu.org/licenses/
+**
+*******************************************************************************/
+#ifndef LRDLOGINDEX_H
+#define LRDLOGINDEX_H
+
+/******************************************************************************/
+// Include Files
+/******************************************************************************/
+#include <QObject>
+#include <QString>
+#include <QStringList>
+#include <QByteArray>
+#include <QVector>
+#include <QList>
+#include <QHash>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QDateTime>
+#include <QDataStream>
+#include <QElapsedTimer>
+#include <QMetaType>
+
+/******************************************************************************/
+// Defines
+/******************************************************************************/
+#define LogIndexFilename                  "UwTerminalX.logidx" //Filename of the on-disk index (stored in the indexed directory)
+#define LogIndexFileVersion               2       //Version of the on-disk index format
+#define LogIndexBlockSize                 65536   //Maximum size (in bytes) of an indexed block of a log file
+#define LogIndexHeadSize                  256     //Number of bytes at the start of a log file which are checked to tell a replaced file from one that has grown
+#define LogIndexBlocksPerSlice            8       //Number of blocks to index before yielding to queued searches
+#define LogIndexMaxHits                   500     //Maximum number of hits returned from a search
+#define LogIndexMaxPreview                120     //Maximum number of characters in a hit preview line
+#define LogIndexSaveBytes                 67108864 //Amount of newly indexed data (in bytes) after which the index is saved to disk
+#define LogIndexSaveInterval              1800000 //Time (in ms) after which other changes to the index are saved to disk, the index is always saved when the directory changes or on exit
+
+/******************************************************************************/
+// Forward declaration of Class, Struct & Unions
+/******************************************************************************/
+struct LrdLogIndexHit
+{
+    QString strFilename; //Filename (without path) of the log file containing the hit
+    qint64 intOffset; //Byte offset of the hit in the log file
+    QString strPreview; //Line of text containing the hit
+};
+Q_DECLARE_METATYPE(LrdLogIndexHit)
+Q_DECLARE_METATYPE(QList<LrdLogIndexHit>)
+
+/******************************************************************************/
+// Class definitions
+/******************************************************************************/
+class LrdLogIndex : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit LrdLogIndex(
+        QObject *parent = 0
+        );
+    ~LrdLogIndex(
+        );
+
+public slots:
+    void
+    SetDirectory(
+        QString strDirPath
+        );
+    void
+    UpdateIndex(
+        );
+    void
+    Search(
+        QString strQuery
+        );
+
+private slots:
+    void
+    IndexNextSlice(
+        );
+
+signals:
+    void
+    IndexStatus(
+        QString strStatus
+        );
+    void
+    SearchFinished(
+        QString strQuery,
+        QList<LrdLogIndexHit> lstHits,
+        qint64 intElapsedUs
+        );
+
+private:
+    struct IndexedFile
+    {
+        QString strName; //Filename (without path)
+        qint64 intIndexed; //Number of bytes of the file which have been indexed
+        QDateTime dtModified; //Last modification time when the file was indexed or its start was checked
+        qint32 intHeadLength; //Number of bytes at the start of the file covered by intHeadCrc
+        quint32 intHeadCrc; //CRC32 of the start of the file when it was first indexed
+        qint32 intLastBlock; //Index of the last block belonging to this file (-1 if none)
+    };
+    struct IndexBlock
+    {
+        qint32 intFile; //Index of the file this block belongs to
+        qint64 intOffset; //Byte offset of the block in the file
+        qint32 intLength; //Length of the block in bytes
+        qint32 intPrev; //Previous block of the same file (-1 if none)
+        qint32 intNext; //Next block of the same file (-1 if none)
+    };
+    void
+    ClearIndex(
+        );
+    void
+    RemoveFiles(
+        const QVector<bool> &vecRemove
+        );
+    bool
+    HeadMatches(
+        const IndexedFile &ifFile
+        );
+    bool
+    LoadIndex(
+        );
+    void
+    SaveIndex(
+        );
+    void
+    SaveIndexIfDue(
+        );
+    void
+    IndexBlockData(
+        qint32 intBlock,
+        const QByteArray &baData
+        );
+    bool
+    BlockContains(
+        quint32 intTrigram,
+        qint32 intBlock
+        );
+    static void
+    LowerCase(
+        QByteArray *baData
+        );
+
+    QString mstrDirPath; //Directory being indexed
+    QList<IndexedFile> mlstFiles; //Files which are part of the index
+    QVector<IndexBlock> mvecBlocks; //Blocks which are part of the index
+    QHash<quint32, QVector<quint32> > mhashPostings; //Sorted list of blocks containing each trigram
+    QList<qint32> mlstPending; //Files that have unindexed data
+    bool mbIndexing; //True whilst a background indexing pass is in progress
+    bool mbModified; //True if the index has changed since it was last saved
+    qint64 mintUnsavedBytes; //Number of bytes indexed since the index was last saved
+    QElapsedTimer mtmrSaved; //Time since the index was last saved (or loaded)
+};
+
+#endif // LRDLOGINDEX_H
+
+/******************************************************************************/
+// END OF FILE
+/******************************************************************************/
@@ -0,0 +1,219 @@
+/******************************************************************************
+** Copyright (C) 2016 Laird
+**
+** Project: UwTerminalX
+**
+** Module: LrdMultiMatcher.cpp
+**
+** Notes:
+**
+** License: This program is free software: you can redistribute it and/or
+**          modify it under the terms of the GNU General Public License as
+**          published by the Free Software Foundation, version 3.
+**
+**          This program is distributed in the hope that it will be useful,
+**          but WITHOUT ANY WARRANTY; without even the implied warranty of
+**          MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+**          GNU General Public License for more details.
+**
+**          You should have received a copy of the GNU General Public License
+**          along with this program.  If not, see http://www.gnu.org/licenses/
+**
+*******************************************************************************/
+/******************************************************************************/
+// Include Files
+/******************************************************************************/
+#include "LrdMultiMatcher.h"
+
+/******************************************************************************/
+// Local Functions or Private Members
+/******************************************************************************/
+LrdMultiMatcher::LrdMultiMatcher(
+    )
+{
+    //Nothing to match, the automaton is built when patterns are set
+    mintState = 0;
+    mintMatched = -1;
+}
+
+//=============================================================================
+//=============================================================================
+void
+LrdMultiMatcher::SetPatterns(
+    const QList<QByteArray> &lstPatterns
+    )
+{
+    //Sets the data to search for and builds the automaton: a trie of the patterns whose missing transitions are filled in from the failure links
+    mlstPatterns = lstPatterns;
+    mvecTransitions.fill(-1, MultiMatcherAlphabetSize);
+    mvecMatch.fill(-1, 1);
+
+    //Add each pattern to the trie, state 0 is the root
+    int i = 0;
+    while (i < mlstPatterns.count())
+    {
+        const unsigned char *pchPattern = (const unsigned char *)mlstPatterns.at(i).constData();
+        int intState = 0;
+        int j = 0;
+        while (j < mlstPatterns.at(i).length())
+        {
+            int intNext = mvecTransitions.at(intState*MultiMatcherAlphabetSize + pchPattern[j]);
+            if (intNext == -1)
+            {
+                //New state
+                intNext = mvecMatch.count();
+                mvecTransitions[intState*MultiMatcherAlphabetSize + pchPattern[j]] = intNext;
+                mvecTransitions.insert(mvecTransitions.count(), MultiMatcherAlphabetSize, -1);
+                mvecMatch.append(-1);
+            }
+            intState = intNext;
+            ++j;
+        }
+        if (mvecMatch.at(intState) == -1)
+        {
+            //Duplicate patterns report the first one
+            mvecMatch[intState] = i;
+        }
+        ++i;
+    }
+
+    //Visit the states in order of depth, a state's failure link is the longest proper suffix of it that is also in the trie which is always less deep so has already been completed
+    QVector<int> vecFailure(mvecMatch.count(), 0);
+    QVector<int> vecQueue;
+    int intByte = 0;
+    while (intByte < MultiMatcherAlphabetSize)
+    {
+        int intNext = mvecTransitions.at(intByte);
+        if (intNext == -1)
+        {
+            //Bytes which do not start a pattern stay at the root
+            mvecTransitions[intByte] = 0;
+        }
+        else
+        {
+            vecQueue.append(intNext);
+        }
+        ++intByte;
+    }
+    int intHead = 0;
+    while (intHead < vecQueue.count())
+    {
+        int intState = vecQueue.at(intHead);
+        int intFailure = vecFailure.at(intState);
+        ++intHead;
+
+        if (mvecMatch.at(intFailure) != -1 && (mvecMatch.at(intState) == -1 || mvecMatch.at(intFailure) < mvecMatch.at(intState)))
+        {
+            //A shorter pattern ends here too
+            mvecMatch[intState] = mvecMatch.at(intFailure);
+        }
+
+        intByte = 0;
+        while (intByte < MultiMatcherAlphabetSize)
+        {
+            int intNext = mvecTransitions.at(intState*MultiMatcherAlphabetSize + intByte);
+            if (intNext == -1)
+            {
+                //No transition, go where the failure link goes
+                mvecTransitions[intState*MultiMatcherAlphabetSize + intByte] = mvecTransitions.at(intFailure*MultiMatcherAlphabetSize + intByte);
+            }
+            else
+            {
+                vecFailure[intNext] = mvecTransitions.at(intFailure*MultiMatcherAlphabetSize + intByte);
+                vecQueue.append(intNext);
+            }
+            ++intByte;
+        }
+    }
+    mintState = 0;
+    mintMatched = -1;
+}
+
+//=============================================================================
+//=============================================================================
+void
+LrdMultiMatcher::Reset(
+    )
+{
+    //Forgets any partial match, the patterns are kept
+    mintState = 0;
+    mintMatched = -1;
+}
+
+//=============================================================================
+//=============================================================================
+int
+LrdMultiMatcher::Feed(
+    const char *pchData,
+    int intLength
+    )
+{
+    //Searches the next part of the stream for any of the patterns. A partial match at the end of the data carries over to the next call. Returns the number of bytes of this data up to and including the end of the first match, or -1 if no pattern has been found yet
+    if (mvecMatch.isEmpty())
+    {
+        //No patterns have been set
+        return -1;
+    }
+    else if (mvecMatch.at(0) != -1)
+    {
+        //Empty pattern always matches
+        mintMatched = mvecMatch.at(0);
+        return 0;
+    }
+
+    const int *pintTransitions = mvecTransitions.constData();
+    const int *pintMatch = mvecMatch.constData();
+    const unsigned char *pchBytes = (const unsigned char *)pchData;
+    int intState = mintState;
+    int i = 0;
+    while (i < intLength)
+    {
+        intState = pintTransitions[intState*MultiMatcherAlphabetSize + pchBytes[i]];
+        if (pintMatch[intState] != -1)
+        {
+            //Match found, start afresh for the next search
+            mintMatched = pintMatch[intState];
+            mintState = 0;
+            return i + 1;
+        }
+        ++i;
+    }
+
+    //No pattern found, remember the state
+    mintState = intState;
+    return -1;
+}
+
+//=============================================================================
+//=============================================================================
+int
+LrdMultiMatcher::MatchedIndex(
+    ) const
+{
+    //Returns the index of the pattern found by the last match (-1 if none)
+    return mintMatched;
+}
+
+//=============================================================================
+//=============================================================================
+int
+LrdMultiMatcher::MatchedLength(
+    ) const
+{
+    //Returns the length of the pattern found by the last match
+    return (mintMatched == -1 ? 0 : mlstPatterns.at(mintMatched).length());
+}
+
+//=============================================================================
+//=============================================================================
+int
+LrdMultiMatcher::PatternCount(
+    ) const
+{
+    //Returns the number of patterns
+    return mlstPatterns.count();
+}
+
+/******************************************************************************/
+// END OF FILE
+/******************************************************************************/
@@ -0,0 +1,80 @@
+/******************************************************************************
+** Copyright (C) 2016 Laird
+**
+** Project: UwTerminalX
+**
+** Module: LrdMultiMatcher.h
+**
+** Notes:
+**
+** License: This program is free software: you can redistribute it and/or
+**          modify it under the terms of the GNU General Public License as
+**          published by the Free Software Foundation, version 3.
+**
+**          This program is distributed in the hope that it will be useful,
+**          but WITHOUT ANY WARRANTY; without even the implied warranty of
+**          MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+**          GNU General Public License for more details.
+**
+**          You should have received a copy of the GNU General Public License
+**          along with this program.  If not, see http://www.gnu.org/licenses/
+**
+*******************************************************************************/
+#ifndef LRDMULTIMATCHER_H
+#define LRDMULTIMATCHER_H
+
+/******************************************************************************/
+// Include Files
+/******************************************************************************/
+#include <QByteArray>
+#include <QList>
+#include <QVector>
+
+/******************************************************************************/
+// Defines
+/******************************************************************************/
+#define MultiMatcherAlphabetSize       256   //Number of transitions from each automaton state (one per byte value)
+
+/******************************************************************************/
+// Class definitions
+/******************************************************************************/
+class LrdMultiMatcher
+{
+public:
+    LrdMultiMatcher(
+        );
+    void
+    SetPatterns(
+        const QList<QByteArray> &lstPatterns
+        );
+    void
+    Reset(
+        );
+    int
+    Feed(
+        const char *pchData,
+        int intLength
+        );
+    int
+    MatchedIndex(
+        ) const;
+    int
+    MatchedLength(
+        ) const;
+    int
+    PatternCount(
+        ) const;
+
+private:
+    QList<QByteArray> mlstPatterns; //Data being searched for, any of which is a match
+    QVector<int> mvecTransitions; //Aho-Corasick automaton: next state for each state and byte value, failure links are already followed so each byte is a single lookup
+    QVector<int> mvecMatch; //Pattern which has been found when each state is reached (the first listed if more than one ends there, -1 if none)
+    int mintState; //Automaton state at the end of the data fed so far
+    int mintMatched; //Pattern found by the last match (-1 if none)
+};
+
+#endif // LRDMULTIMATCHER_H
+
+/******************************************************************************/
+// END OF FILE
+/******************************************************************************/
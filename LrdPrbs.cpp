@@ -0,0 +1,363 @@
+/******************************************************************************
+** Copyright (C) 2016 Laird
+**
+** Project: UwTerminalX
+**
+** Module: LrdPrbs.cpp
+**
+** Notes:
+**
+** License: This program is free software: you can redistribute it and/or
+**          modify it under the terms of the GNU General Public License as
+**          published by the Free Software Foundation, version 3.
+**
+**          This program is distributed in the hope that it will be useful,
+**          but WITHOUT ANY WARRANTY; without even the implied warranty of
+**          MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+**          GNU General Public License for more details.
+**
+**          You should have received a copy of the GNU General Public License
+**          along with this program.  If not, see http://www.gnu.org/licenses/
+**
+*******************************************************************************/
+
+/******************************************************************************/
+// Include Files
+/******************************************************************************/
+#include "LrdPrbs.h"
+
+/******************************************************************************/
+// Local Functions or Private Members
+/******************************************************************************/
+LrdPrbs::LrdPrbs(
+    )
+{
+    //Initial values
+    SetOrder(7);
+}
+
+//=============================================================================
+//=============================================================================
+bool
+LrdPrbs::SetOrder(
+    int intOrder
+    )
+{
+    //Selects the sequence (ITU-T O.150 polynomials) and builds the lookup tables. Sequence bits are packed least significant bit first, matching the order a UART transmits them
+    int intTap;
+    if (intOrder == 7)
+    {
+        //x^7 + x^6 + 1
+        intTap = 6;
+    }
+    else if (intOrder == 15)
+    {
+        //x^15 + x^14 + 1
+        intTap = 14;
+    }
+    else if (intOrder == 23)
+    {
+        //x^23 + x^18 + 1
+        intTap = 18;
+    }
+    else if (intOrder == 31)
+    {
+        //x^31 + x^28 + 1
+        intTap = 28;
+    }
+    else
+    {
+        //Unsupported sequence
+        return false;
+    }
+    mintOrder = intOrder;
+
+    //The shift register holds the last intOrder bits of the sequence (oldest in bit 0), each table entry is the next 32 bits produced by one byte of the register. As the sequence is linear the entries for each byte can be XORed together
+    int j = 0;
+    while (j < 4)
+    {
+        int i = 0;
+        while (i < 256)
+        {
+            quint64 intBits = ((quint64)i << (j*8)) & ((1ULL << intOrder) - 1);
+            int intBit = intOrder;
+            while (intBit < intOrder + 32)
+            {
+                intBits |= ((((intBits >> (intBit - intOrder)) ^ (intBits >> (intBit - intTap))) & 1) << intBit);
+                ++intBit;
+            }
+            mintTables[j][i] = (quint32)(intBits >> intOrder);
+            ++i;
+        }
+        ++j;
+    }
+
+    Reset();
+    return true;
+}
+
+//=============================================================================
+//=============================================================================
+void
+LrdPrbs::Reset(
+    )
+{
+    //Restarts the generator and verifier
+    mintGenState = (1UL << mintOrder) - 1;
+    mintGenWord = 0;
+    mintGenBytes = 0;
+    mintCheckState = 0;
+    mbCheckStateValid = false;
+    mbLocked = false;
+    mintLockCount = 0;
+    mintPartialWord = 0;
+    mintPartialBytes = 0;
+    mintBlockWords = 0;
+    mintBlockErrors = 0;
+    mbPendingBlock = false;
+    mintPendingErrors = 0;
+    mintBitsChecked = 0;
+    mintBitErrors = 0;
+    mintErroredSeconds = 0;
+    mintLastErroredSecond = -1;
+    mintBitSlips = 0;
+}
+
+//=============================================================================
+//=============================================================================
+quint32
+LrdPrbs::NextWord(
+    quint32 intState
+    ) const
+{
+    //Returns the next 32 bits of the sequence following a shift register state
+    return mintTables[0][intState & 0xFF] ^ mintTables[1][(intState >> 8) & 0xFF] ^ mintTables[2][(intState >> 16) & 0xFF] ^ mintTables[3][intState >> 24];
+}
+
+//=============================================================================
+//=============================================================================
+void
+LrdPrbs::Generate(
+    char *pchData,
+    qint64 intLength
+    )
+{
+    //Fills a buffer with the next part of the sequence
+    while (intLength > 0 && mintGenBytes > 0)
+    {
+        //Output bytes left over from the last call
+        *pchData = (char)(mintGenWord >> ((4 - mintGenBytes)*8));
+        ++pchData;
+        --intLength;
+        --mintGenBytes;
+    }
+
+    while (intLength >= 4)
+    {
+        //Output a word at a time
+        mintGenWord = NextWord(mintGenState);
+        mintGenState = mintGenWord >> (32 - mintOrder);
+        qToLittleEndian<quint32>(mintGenWord, (uchar *)pchData);
+        pchData += 4;
+        intLength -= 4;
+    }
+
+    if (intLength > 0)
+    {
+        //Output the start of the next word and keep the rest for the next call
+        mintGenWord = NextWord(mintGenState);
+        mintGenState = mintGenWord >> (32 - mintOrder);
+        mintGenBytes = 4;
+        while (intLength > 0)
+        {
+            *pchData = (char)(mintGenWord >> ((4 - mintGenBytes)*8));
+            ++pchData;
+            --intLength;
+            --mintGenBytes;
+        }
+    }
+}
+
+//=============================================================================
+//=============================================================================
+void
+LrdPrbs::Verify(
+    const char *pchData,
+    qint64 intLength,
+    qint64 intSecond
+    )
+{
+    //Checks received data against the sequence, intSecond is the current test time in seconds (used for counting errored seconds)
+    while (intLength > 0 && mintPartialBytes > 0)
+    {
+        //Complete the word left over from the last call
+        mintPartialWord |= ((quint32)(uchar)*pchData << (mintPartialBytes*8));
+        ++pchData;
+        --intLength;
+        ++mintPartialBytes;
+        if (mintPartialBytes == 4)
+        {
+            mintPartialBytes = 0;
+            VerifyWord(mintPartialWord, intSecond);
+        }
+    }
+
+    while (intLength >= 4)
+    {
+        //Check a word at a time
+        VerifyWord(qFromLittleEndian<quint32>((const uchar *)pchData), intSecond);
+        pchData += 4;
+        intLength -= 4;
+    }
+
+    if (intLength > 0)
+    {
+        //Keep the remaining bytes for the next call
+        mintPartialWord = 0;
+        while (intLength > 0)
+        {
+            mintPartialWord |= ((quint32)(uchar)*pchData << (mintPartialBytes*8));
+            ++pchData;
+            --intLength;
+            ++mintPartialBytes;
+        }
+    }
+}
+
+//=============================================================================
+//=============================================================================
+void
+LrdPrbs::VerifyWord(
+    quint32 intWord,
+    qint64 intSecond
+    )
+{
+    //Checks a received word against the expected word
+    if (mbLocked == true)
+    {
+        //Synchronised: compare with the predicted sequence and keep following it regardless of errors so each error is only counted once
+        quint32 intExpected = NextWord(mintCheckState);
+        mintCheckState = intExpected >> (32 - mintOrder);
+        quint32 intDifference = intExpected ^ intWord;
+        while (intDifference != 0)
+        {
+            //Count bits which differ
+            intDifference &= intDifference - 1;
+            ++mintBlockErrors;
+        }
+        ++mintBlockWords;
+
+        if (mintBlockErrors > PrbsLockLossErrors)
+        {
+            //Too many errors for random bit errors: a bit has been added or lost. Discard this block and the previous one (which may contain the start of the slip) and resynchronise
+            mbLocked = false;
+            mintLockCount = 0;
+            mintBlockWords = 0;
+            mintBlockErrors = 0;
+            mbPendingBlock = false;
+            mintCheckState = intWord >> (32 - mintOrder);
+            ++mintBitSlips;
+            ErroredSecond(intSecond);
+        }
+        else if (mintBlockWords == PrbsBlockWords)
+        {
+            //Add the previous block to the totals and hold this one back
+            if (mbPendingBlock == true)
+            {
+                mintBitsChecked += PrbsBlockWords*32;
+                mintBitErrors += mintPendingErrors;
+                if (mintPendingErrors > 0)
+                {
+                    ErroredSecond(intSecond);
+                }
+            }
+            mbPendingBlock = true;
+            mintPendingErrors = mintBlockErrors;
+            mintBlockWords = 0;
+            mintBlockErrors = 0;
+        }
+    }
+    else
+    {
+        //Synchronising: load the shift register from the received data and check that the following words are predicted correctly
+        if (mbCheckStateValid == true && mintCheckState != 0 && NextWord(mintCheckState) == intWord)
+        {
+            ++mintLockCount;
+            if (mintLockCount >= PrbsLockWords)
+            {
+                //Synchronised
+                mbLocked = true;
+            }
+        }
+        else
+        {
+            mintLockCount = 0;
+        }
+        mintCheckState = intWord >> (32 - mintOrder);
+        mbCheckStateValid = true;
+    }
+}
+
+//=============================================================================
+//=============================================================================
+void
+LrdPrbs::ErroredSecond(
+    qint64 intSecond
+    )
+{
+    //Counts a second as errored (once)
+    if (intSecond != mintLastErroredSecond)
+    {
+        mintLastErroredSecond = intSecond;
+        ++mintErroredSeconds;
+    }
+}
+
+//=============================================================================
+//=============================================================================
+bool
+LrdPrbs::IsLocked(
+    ) const
+{
+    return mbLocked;
+}
+
+//=============================================================================
+//=============================================================================
+quint64
+LrdPrbs::BitsChecked(
+    ) const
+{
+    return mintBitsChecked;
+}
+
+//=============================================================================
+//=============================================================================
+quint64
+LrdPrbs::BitErrors(
+    ) const
+{
+    return mintBitErrors;
+}
+
+//=============================================================================
+//=============================================================================
+quint64
+LrdPrbs::ErroredSeconds(
+    ) const
+{
+    return mintErroredSeconds;
+}
+
+//=============================================================================
+//=============================================================================
+quint64
+LrdPrbs::BitSlips(
+    ) const
+{
+    return mintBitSlips;
+}
+
+/******************************************************************************/
+// END OF FILE
+/******************************************************************************/
@@ -0,0 +1,122 @@
+/******************************************************************************
+** Copyright (C) 2016 Laird
+**
+** Project: UwTerminalX
+**
+** Module: LrdPrbs.h
+**
+** Notes:
+**
+** License: This program is free software: you can redistribute it and/or
+**          modify it under the terms of the GNU General Public License as
+**          published by the Free Software Foundation, version 3.
+**
+**          This program is distributed in the hope that it will be useful,
+**          but WITHOUT ANY WARRANTY; without even the implied warranty of
+**          MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+**          GNU General Public License for more details.
+**
+**          You should have received a copy of the GNU General Public License
+**          along with this program.  If not, see http://www.gnu.org/licenses/
+**
+*******************************************************************************/
+#ifndef LRDPRBS_H
+#define LRDPRBS_H
+
+/******************************************************************************/
+// Include Files
+/******************************************************************************/
+#include <QtGlobal>
+#include <QtEndian>
+
+/******************************************************************************/
+// Defines
+/******************************************************************************/
+#define PrbsBlockWords                    8       //Number of 32-bit words in a block, blocks are added to the totals once the following block has also been checked
+#define PrbsLockLossErrors                64      //Number of bit errors in a block (of 256 bits) which causes loss of synchronisation
+#define PrbsLockWords                     2       //Number of consecutive error-free words required to gain synchronisation
+
+/******************************************************************************/
+// Class definitions
+/******************************************************************************/
+class LrdPrbs
+{
+public:
+    LrdPrbs(
+        );
+    bool
+    SetOrder(
+        int intOrder
+        );
+    void
+    Reset(
+        );
+    void
+    Generate(
+        char *pchData,
+        qint64 intLength
+        );
+    void
+    Verify(
+        const char *pchData,
+        qint64 intLength,
+        qint64 intSecond
+        );
+    bool
+    IsLocked(
+        ) const;
+    quint64
+    BitsChecked(
+        ) const;
+    quint64
+    BitErrors(
+        ) const;
+    quint64
+    ErroredSeconds(
+        ) const;
+    quint64
+    BitSlips(
+        ) const;
+
+private:
+    quint32
+    NextWord(
+        quint32 intState
+        ) const;
+    void
+    VerifyWord(
+        quint32 intWord,
+        qint64 intSecond
+        );
+    void
+    ErroredSecond(
+        qint64 intSecond
+        );
+
+    int mintOrder; //Length of the shift register (7, 15, 23 or 31)
+    quint32 mintTables[4][256]; //Next 32 bits of the sequence for each byte of the shift register state
+    quint32 mintGenState; //Generator shift register state
+    quint32 mintGenWord; //Last generated word (bytes not yet output are at the top)
+    int mintGenBytes; //Number of bytes of mintGenWord not yet output
+    quint32 mintCheckState; //Verifier shift register state
+    bool mbCheckStateValid; //True once the verifier state has been loaded from received data
+    bool mbLocked; //True when the verifier is synchronised to the received sequence
+    int mintLockCount; //Consecutive error-free words whilst synchronising
+    quint32 mintPartialWord; //Received bytes which do not yet make up a full word
+    int mintPartialBytes; //Number of bytes in mintPartialWord
+    int mintBlockWords; //Number of words checked in the current block
+    quint64 mintBlockErrors; //Number of bit errors in the current block
+    bool mbPendingBlock; //True if the previous block is waiting to be added to the totals (it is discarded if the next block loses synchronisation)
+    quint64 mintPendingErrors; //Number of bit errors in the previous block
+    quint64 mintBitsChecked; //Total number of bits checked whilst synchronised
+    quint64 mintBitErrors; //Total number of bit errors whilst synchronised
+    quint64 mintErroredSeconds; //Number of seconds containing at least one bit error or loss of synchronisation
+    qint64 mintLastErroredSecond; //Last second which was counted as errored
+    quint64 mintBitSlips; //Number of times synchronisation was lost after being gained
+};
+
+#endif // LRDPRBS_H
+
+/******************************************************************************/
+// END OF FILE
+/******************************************************************************/
@@ -0,0 +1,669 @@
+/******************************************************************************
+** Copyright (C) 2016 Laird
+**
+** Project: UwTerminalX
+**
+** Module: LrdScriptCompiler.cpp
+**
+** Notes:
+**
+** License: This program is free software: you can redistribute it and/or
+**          modify it under the terms of the GNU General Public License as
+**          published by the Free Software Foundation, version 3.
+**
+**          This program is distributed in the hope that it will be useful,
+**          but WITHOUT ANY WARRANTY; without even the implied warranty of
+**          MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+**          GNU General Public License for more details.
+**
+**          You should have received a copy of the GNU General Public License
+**          along with this program.  If not, see http://www.gnu.org/licenses/
+**
+*******************************************************************************/
+
+/******************************************************************************/
+// Include Files
+/******************************************************************************/
+#include "LrdScriptCompiler.h"
+
+/******************************************************************************/
+// Local Functions or Private Members
+/******************************************************************************/
+//Set pattern to match
+QRegularExpression LrdScriptCompiler::reVariable = QRegularExpression("\\$\\{([A-Za-z0-9_]+)\\}");
+QRegularExpression LrdScriptCompiler::reName = QRegularExpression("^[A-Za-z0-9_]+$");
+QRegularExpression LrdScriptCompiler::reWaitTime = QRegularExpression("^\\s*([0-9]+)\\s*(us|ms)?\\s*$", QRegularExpression::CaseInsensitiveOption);
+QRegularExpression LrdScriptCompiler::reCondition = QRegularExpression("^(.*?)\\s*(==|!=|<=|>=|<|>)\\s*(.*)$");
+QRegularExpression LrdScriptCompiler::reWhitespace = QRegularExpression("\\s");
+
+//=============================================================================
+//=============================================================================
+bool
+LrdScriptCompiler::Compile(
+    const QStringList &lstLines,
+    QVector<LrdScriptInstruction> *pvecProgram,
+    QList<int> *plstBadLines
+    )
+{
+    //Compiles a script into a list of instructions, returns true if all lines are valid
+    pvecProgram->clear();
+    plstBadLines->clear();
+    QList<Block> lstBlocks;
+    int intLoops = 0;
+    int i = 0;
+    while (i < lstLines.count())
+    {
+        bool bValid = (lstLines.at(i).length() > 1 && lstLines.at(i).at(0) == ScriptingControl ? CompileControl(lstLines.at(i), i, pvecProgram, &lstBlocks, &intLoops) : CompileLine(lstLines.at(i), i, pvecProgram));
+        if (bValid == false)
+        {
+            //Syntax error
+            plstBadLines->append(i);
+        }
+        ++i;
+    }
+
+    i = 0;
+    while (i < lstBlocks.count())
+    {
+        //Block is missing its #ENDLOOP or #ENDIF
+        plstBadLines->append(lstBlocks.at(i).intLine);
+        ++i;
+    }
+
+    if (!plstBadLines->isEmpty())
+    {
+        //Do not return a partial program
+        pvecProgram->clear();
+        return false;
+    }
+    return true;
+}
+
+//=============================================================================
+//=============================================================================
+bool
+LrdScriptCompiler::CompileLine(
+    const QString &strLine,
+    int intLine,
+    QVector<LrdScriptInstruction> *pvecProgram
+    )
+{
+    //Compiles a single line, appending any instruction to the program. Returns false if the line is invalid
+    int intLineLength = strLine.length();
+    if (intLineLength == 0)
+    {
+        //Blank line
+        return true;
+    }
+    else if (intLineLength == 1)
+    {
+        //Command without a parameter
+        return false;
+    }
+
+    LrdScriptInstruction siInstruction;
+    siInstruction.intWaitTime = 0;
+    siInstruction.intValue = 0;
+    siInstruction.intLoop = 0;
+    siInstruction.intJump = 0;
+    siInstruction.ucCompare = 0;
+    siInstruction.intLine = intLine;
+    if (strLine.at(0) == ScriptingWaitTime)
+    {
+        //Check if the time value is valid or not, times are in ms unless they end with us
+        QRegularExpressionMatch remWaitTime = reWaitTime.match(strLine.mid(1));
+        bool bConverted = false;
+        qint64 intConv = (remWaitTime.hasMatch() ? remWaitTime.captured(1).toLongLong(&bConverted) : 0);
+        if (bConverted == false || intConv <= 0 || intConv > 0x7FFFFFFF)
+        {
+            //Invalid number or time value is 0, negative or too large
+            return false;
+        }
+        siInstruction.ucOpcode = ScriptingOpWait;
+        siInstruction.intWaitTime = (remWaitTime.captured(2).toLower() == "us" ? intConv : intConv*1000);
+    }
+    else if (strLine.at(0) == ScriptingDataOut && strLine.contains(reVariable))
+    {
+        //Send data containing variables, split it so that only the variables need to be filled in at run time
+        siInstruction.ucOpcode = ScriptingOpSend;
+        SplitVariables(strLine.mid(1), &siInstruction.lstParts);
+    }
+    else if (strLine.at(0) == ScriptingRegexIn)
+    {
+        //Regular expressions use their own escape sequences so are not escaped. Received data is matched as Latin-1 so that offsets are byte offsets
+        siInstruction.ucOpcode = ScriptingOpRegexReceive;
+        siInstruction.reExpression.setPattern(strLine.mid(1));
+        if (siInstruction.reExpression.isValid() == false)
+        {
+            //Invalid expression
+            return false;
+        }
+        siInstruction.reExpression.optimize();
+    }
+    else if (strLine.at(0) == ScriptingDataOut || strLine.at(0) == ScriptingDataIn)
+    {
+        //Escape the data once here rather than each time the line is run, text is encoded first so that escape sequences give raw bytes
+        siInstruction.ucOpcode = (strLine.at(0) == ScriptingDataOut ? ScriptingOpSend : ScriptingOpReceive);
+        siInstruction.baData = strLine.mid(1).toUtf8();
+        UwxEscape::EscapeCharacters(&siInstruction.baData);
+    }
+    else if (strLine.left(2) == ScriptingComment || QString(strLine).replace("\t", "").replace(" ", "").length() == 0)
+    {
+        //Comment or whitespace
+        return true;
+    }
+    else
+    {
+        //Text present that isn't space/tab or a valid command
+        return false;
+    }
+
+    pvecProgram->append(siInstruction);
+    return true;
+}
+
+//=============================================================================
+//=============================================================================
+bool
+LrdScriptCompiler::CheckLine(
+    const QString &strLine
+    )
+{
+    //Checks the syntax of a single line on its own (for checking lines as they are edited). Statements that end or depend on a block are checked as if they were inside a matching block, block matching is only checked when the whole script is compiled
+    QVector<LrdScriptInstruction> vecProgram;
+    if (strLine.length() <= 1 || strLine.at(0) != ScriptingControl)
+    {
+        //Not a control statement
+        return CompileLine(strLine, 0, &vecProgram);
+    }
+
+    LrdScriptInstruction siBlockStart;
+    siBlockStart.ucOpcode = ScriptingOpLoopStart;
+    siBlockStart.intWaitTime = 0;
+    siBlockStart.intValue = 1;
+    siBlockStart.intLoop = 0;
+    siBlockStart.intJump = 0;
+    siBlockStart.ucCompare = 0;
+    siBlockStart.intLine = 0;
+
+    Block blkOuter;
+    blkOuter.intInstruction = 0;
+    blkOuter.intLine = 0;
+    blkOuter.intElse = -1;
+
+    //Try the statement inside a loop and then inside an if block
+    unsigned char ucBlockType = ScriptingBlockLoop;
+    while (ucBlockType <= ScriptingBlockIf)
+    {
+        QList<Block> lstBlocks;
+        int intLoops = 1;
+        blkOuter.ucType = ucBlockType;
+        lstBlocks.append(blkOuter);
+        vecProgram.clear();
+        vecProgram.append(siBlockStart);
+        if (CompileControl(strLine, 1, &vecProgram, &lstBlocks, &intLoops) == true)
+        {
+            return true;
+        }
+        ++ucBlockType;
+    }
+    return false;
+}
+
+//=============================================================================
+//=============================================================================
+bool
+LrdScriptCompiler::IsJavaScript(
+    const QString &strFirstLine
+    )
+{
+    //Returns true if the first line of a script marks it as a JavaScript script
+    return strFirstLine.trimmed().startsWith(ScriptingJavaScript, Qt::CaseInsensitive);
+}
+
+//=============================================================================
+//=============================================================================
+bool
+LrdScriptCompiler::CompileControl(
+    const QString &strLine,
+    int intLine,
+    QVector<LrdScriptInstruction> *pvecProgram,
+    QList<Block> *plstBlocks,
+    int *pintLoops
+    )
+{
+    //Compiles a loop, counter or conditional statement into jumps, blocks are matched using the block stack. Returns false if the line is invalid
+    QString strStatement = strLine.mid(1).trimmed();
+    int intSplit = strStatement.indexOf(reWhitespace);
+    QString strKeyword = (intSplit == -1 ? strStatement : strStatement.left(intSplit)).toUpper();
+    QString strArguments = (intSplit == -1 ? QString() : strStatement.mid(intSplit).trimmed());
+    QStringList lstArguments = strArguments.split(reWhitespace, QString::SkipEmptyParts);
+
+    LrdScriptInstruction siInstruction;
+    siInstruction.intWaitTime = 0;
+    siInstruction.intValue = 0;
+    siInstruction.intLoop = 0;
+    siInstruction.intJump = 0;
+    siInstruction.ucCompare = 0;
+    siInstruction.intLine = intLine;
+
+    if (strKeyword == "LOOP")
+    {
+        //#LOOP <count> [variable]: the variable (if given) holds the iteration number, starting at 1
+        bool bConverted = false;
+        siInstruction.intValue = (lstArguments.count() > 0 ? lstArguments.at(0).toLongLong(&bConverted) : 0);
+        if (bConverted == false || siInstruction.intValue <= 0 || lstArguments.count() > 2 || (lstArguments.count() == 2 && !lstArguments.at(1).contains(reName)))
+        {
+            //Invalid count or variable name
+            return false;
+        }
+        siInstruction.ucOpcode = ScriptingOpLoopStart;
+        siInstruction.intLoop = *pintLoops;
+        siInstruction.baName = (lstArguments.count() == 2 ? lstArguments.at(1).toLatin1() : QByteArray());
+        ++*pintLoops;
+
+        Block blkLoop;
+        blkLoop.ucType = ScriptingBlockLoop;
+        blkLoop.intInstruction = pvecProgram->count();
+        blkLoop.intLine = intLine;
+        blkLoop.intElse = -1;
+        plstBlocks->append(blkLoop);
+    }
+    else if (strKeyword == "ENDLOOP")
+    {
+        //End of the innermost block, which must be a loop
+        if (!strArguments.isEmpty() || plstBlocks->isEmpty() || plstBlocks->last().ucType != ScriptingBlockLoop)
+        {
+            return false;
+        }
+        Block blkLoop = plstBlocks->takeLast();
+        const LrdScriptInstruction *siLoopStart = &pvecProgram->at(blkLoop.intInstruction);
+        siInstruction.ucOpcode = ScriptingOpLoopEnd;
+        siInstruction.intValue = siLoopStart->intValue;
+        siInstruction.intLoop = siLoopStart->intLoop;
+        siInstruction.baName = siLoopStart->baName;
+        siInstruction.intJump = blkLoop.intInstruction + 1;
+
+        //Jumps out of the loop go to the instruction after this one
+        int intExit = pvecProgram->count() + 1;
+        (*pvecProgram)[blkLoop.intInstruction].intJump = intExit;
+        int i = 0;
+        while (i < blkLoop.lstBreaks.count())
+        {
+            (*pvecProgram)[blkLoop.lstBreaks.at(i)].intJump = intExit;
+            ++i;
+        }
+    }
+    else if (strKeyword == "BREAK")
+    {
+        //Leave the innermost loop
+        int i = plstBlocks->count() - 1;
+        while (i >= 0 && plstBlocks->at(i).ucType != ScriptingBlockLoop)
+        {
+            --i;
+        }
+        if (!strArguments.isEmpty() || i < 0)
+        {
+            //Not in a loop
+            return false;
+        }
+        siInstruction.ucOpcode = ScriptingOpJump;
+        (*plstBlocks)[i].lstBreaks.append(pvecProgram->count());
+    }
+    else if (strKeyword == "IF")
+    {
+        //#IF <value> <comparison> <value>: values can contain variables, they are compared as numbers if both are numeric
+        QRegularExpressionMatch remCondition = reCondition.match(strArguments);
+        if (!remCondition.hasMatch() || remCondition.captured(1).isEmpty())
+        {
+            //Invalid comparison
+            return false;
+        }
+        QString strCompare = remCondition.captured(2);
+        siInstruction.ucOpcode = ScriptingOpJumpIfNot;
+        siInstruction.ucCompare = (strCompare == "==" ? ScriptingCompareEqual : (strCompare == "!=" ? ScriptingCompareNotEqual : (strCompare == "<" ? ScriptingCompareLess : (strCompare == "<=" ? ScriptingCompareLessEqual : (strCompare == ">" ? ScriptingCompareGreater : ScriptingCompareGreaterEqual)))));
+        SplitVariables(remCondition.captured(1), &siInstruction.lstParts);
+        SplitVariables(remCondition.captured(3), &siInstruction.lstCompareParts);
+
+        Block blkIf;
+        blkIf.ucType = ScriptingBlockIf;
+        blkIf.intInstruction = pvecProgram->count();
+        blkIf.intLine = intLine;
+        blkIf.intElse = -1;
+        plstBlocks->append(blkIf);
+    }
+    else if (strKeyword == "ELSE")
+    {
+        //Jump over the else part when the condition was true, a false condition jumps to after this instruction
+        if (!strArguments.isEmpty() || plstBlocks->isEmpty() || plstBlocks->last().ucType != ScriptingBlockIf || plstBlocks->last().intElse != -1)
+        {
+            return false;
+        }
+        siInstruction.ucOpcode = ScriptingOpJump;
+        plstBlocks->last().intElse = pvecProgram->count();
+        (*pvecProgram)[plstBlocks->last().intInstruction].intJump = pvecProgram->count() + 1;
+    }
+    else if (strKeyword == "ENDIF")
+    {
+        //End of the innermost block, which must be an if, no instruction is needed
+        if (!strArguments.isEmpty() || plstBlocks->isEmpty() || plstBlocks->last().ucType != ScriptingBlockIf)
+        {
+            return false;
+        }
+        Block blkIf = plstBlocks->takeLast();
+        (*pvecProgram)[(blkIf.intElse == -1 ? blkIf.intInstruction : blkIf.intElse)].intJump = pvecProgram->count();
+        return true;
+    }
+    else if (strKeyword == "SET")
+    {
+        //#SET <variable> <value>: value can contain variables
+        int intNameEnd = strArguments.indexOf(reWhitespace);
+        siInstruction.baName = (intNameEnd == -1 ? strArguments : strArguments.left(intNameEnd)).toLatin1();
+        if (!QString(siInstruction.baName).contains(reName))
+        {
+            //Invalid variable name
+            return false;
+        }
+        siInstruction.ucOpcode = ScriptingOpSet;
+        SplitVariables((intNameEnd == -1 ? QString() : strArguments.mid(intNameEnd).trimmed()), &siInstruction.lstParts);
+    }
+    else if (strKeyword == "PARAM")
+    {
+        //#PARAM <name> [default]: declares a parameter which is set from a parameter table row, the default (which can contain variables) is used if it is not set
+        int intNameEnd = strArguments.indexOf(reWhitespace);
+        siInstruction.baName = (intNameEnd == -1 ? strArguments : strArguments.left(intNameEnd)).toLatin1();
+        if (!QString(siInstruction.baName).contains(reName))
+        {
+            //Invalid parameter name
+            return false;
+        }
+        siInstruction.ucOpcode = ScriptingOpParam;
+        if (intNameEnd != -1)
+        {
+            //Has a default value
+            siInstruction.intValue = 1;
+            SplitVariables(strArguments.mid(intNameEnd).trimmed(), &siInstruction.lstParts);
+        }
+    }
+    else if (strKeyword == "WAITANY")
+    {
+        //#WAITANY <variable> <data>|<data>...: waits for whichever alternative is received first, the variable is set to its number (from 1). A | in the data is written as \7C
+        int intNameEnd = strArguments.indexOf(reWhitespace);
+        siInstruction.baName = (intNameEnd == -1 ? QString() : strArguments.left(intNameEnd)).toLatin1();
+        if (intNameEnd == -1 || !QString(siInstruction.baName).contains(reName))
+        {
+            //Invalid variable name or no alternatives
+            return false;
+        }
+        QStringList lstData = strArguments.mid(intNameEnd).trimmed().split(ScriptingAlternativeSeparator);
+        QList<QByteArray> lstAlternatives;
+        int i = 0;
+        while (i < lstData.count())
+        {
+            //Escape the data once here rather than each time the line is run
+            QByteArray baData = lstData.at(i).toUtf8();
+            if (baData.isEmpty())
+            {
+                //Empty alternatives (e.g. a trailing | or ||) would match immediately
+                return false;
+            }
+            UwxEscape::EscapeCharacters(&baData);
+            lstAlternatives.append(baData);
+            ++i;
+        }
+        siInstruction.ucOpcode = ScriptingOpReceiveAny;
+        siInstruction.matAlternatives.SetPatterns(lstAlternatives);
+    }
+    else if (strKeyword == "INC" || strKeyword == "DEC")
+    {
+        //#INC/#DEC <variable> [amount]: unset variables count from 0
+        bool bConverted = true;
+        siInstruction.intValue = (lstArguments.count() > 1 ? lstArguments.at(1).toLongLong(&bConverted) : 1);
+        if (lstArguments.count() < 1 || lstArguments.count() > 2 || bConverted == false || !lstArguments.at(0).contains(reName))
+        {
+            //Invalid variable name or amount
+            return false;
+        }
+        siInstruction.ucOpcode = ScriptingOpAdd;
+        siInstruction.baName = lstArguments.at(0).toLatin1();
+        if (strKeyword == "DEC")
+        {
+            siInstruction.intValue = -siInstruction.intValue;
+        }
+    }
+    else
+    {
+        //Unknown statement
+        return false;
+    }
+
+    pvecProgram->append(siInstruction);
+    return true;
+}
+
+//=============================================================================
+//=============================================================================
+void
+LrdScriptCompiler::SplitVariables(
+    const QString &strText,
+    QList<QByteArray> *plstParts
+    )
+{
+    //Splits text into alternating literal data (with escape sequences processed) and variable names so that only the variables need to be filled in at run time
+    QRegularExpressionMatchIterator remiVariableMatch = reVariable.globalMatch(strText);
+    int intLiteralStart = 0;
+    while (remiVariableMatch.hasNext())
+    {
+        QRegularExpressionMatch remThisVariableMatch = remiVariableMatch.next();
+        QByteArray baData = strText.mid(intLiteralStart, remThisVariableMatch.capturedStart(0) - intLiteralStart).toUtf8();
+        UwxEscape::EscapeCharacters(&baData);
+        plstParts->append(baData);
+        plstParts->append(remThisVariableMatch.captured(1).toLatin1());
+        intLiteralStart = remThisVariableMatch.capturedEnd(0);
+    }
+    QByteArray baData = strText.mid(intLiteralStart).toUtf8();
+    UwxEscape::EscapeCharacters(&baData);
+    plstParts->append(baData);
+}
+
+//=============================================================================
+//=============================================================================
+bool
+LrdScriptCompiler::FillVariables(
+    const QList<QByteArray> &lstParts,
+    const QHash<QByteArray, QByteArray> &hashVariables,
+    QByteArray *pbaOutput,
+    QByteArray *pbaMissing
+    )
+{
+    //Appends alternating literal data and variable values (from instructions being run) to the output. Returns false with the name of the variable if a variable has not been set
+    int i = 0;
+    while (i < lstParts.count())
+    {
+        if ((i & 1) == 0)
+        {
+            //Literal data
+            pbaOutput->append(lstParts.at(i));
+        }
+        else if (hashVariables.contains(lstParts.at(i)))
+        {
+            //Variable
+            pbaOutput->append(hashVariables.value(lstParts.at(i)));
+        }
+        else
+        {
+            //Variable has not been set
+            *pbaMissing = lstParts.at(i);
+            return false;
+        }
+        ++i;
+    }
+    return true;
+}
+
+//=============================================================================
+//=============================================================================
+bool
+LrdScriptCompiler::CompareValues(
+    const QByteArray &baLeft,
+    unsigned char ucCompare,
+    const QByteArray &baRight
+    )
+{
+    //Compares two values, numerically if both are numbers otherwise as data
+    bool bLeftNumeric = false;
+    bool bRightNumeric = false;
+    qint64 intLeft = baLeft.trimmed().toLongLong(&bLeftNumeric);
+    qint64 intRight = baRight.trimmed().toLongLong(&bRightNumeric);
+    int intResult;
+    if (bLeftNumeric == true && bRightNumeric == true)
+    {
+        intResult = (intLeft < intRight ? -1 : (intLeft > intRight ? 1 : 0));
+    }
+    else
+    {
+        intResult = (baLeft < baRight ? -1 : (baLeft > baRight ? 1 : 0));
+    }
+
+    if (ucCompare == ScriptingCompareEqual)
+    {
+        return (intResult == 0);
+    }
+    else if (ucCompare == ScriptingCompareNotEqual)
+    {
+        return (intResult != 0);
+    }
+    else if (ucCompare == ScriptingCompareLess)
+    {
+        return (intResult < 0);
+    }
+    else if (ucCompare == ScriptingCompareLessEqual)
+    {
+        return (intResult <= 0);
+    }
+    else if (ucCompare == ScriptingCompareGreater)
+    {
+        return (intResult > 0);
+    }
+    return (intResult >= 0);
+}
+
+//=============================================================================
+//=============================================================================
+bool
+LrdScriptCompiler::LoadParameterTable(
+    const QString &strFilename,
+    QStringList *plstColumns,
+    QList<QStringList> *plstRows,
+    QString *pstrError
+    )
+{
+    //Loads a parameter table from a CSV file: the first row has the parameter names and each following row is a set of values for one run. Values can be quoted (with "" for a quote), quoted values can contain commas and new lines
+    plstColumns->clear();
+    plstRows->clear();
+    QFile fileTable(strFilename);
+    if (!fileTable.open(QIODevice::ReadOnly))
+    {
+        *pstrError = QString("Unable to open parameter table: ").append(fileTable.errorString());
+        return false;
+    }
+    QString strData = QString::fromUtf8(fileTable.readAll());
+    fileTable.close();
+
+    QStringList lstRow;
+    QString strValue;
+    bool bQuoted = false;
+    int intRowLine = 1;
+    int intLine = 1;
+    int i = 0;
+    while (i <= strData.length())
+    {
+        QChar chThis = (i < strData.length() ? strData.at(i) : QChar('\n'));
+        if (bQuoted == true && i == strData.length())
+        {
+            //File ended inside a quoted value
+            *pstrError = QString("Parameter table row on line ").append(QString::number(intRowLine)).append(" has an unterminated quoted value.");
+            return false;
+        }
+        else if (bQuoted == true && chThis == '"' && i + 1 < strData.length() && strData.at(i + 1) == '"')
+        {
+            //Escaped quote
+            strValue.append('"');
+            ++i;
+        }
+        else if (chThis == '"' && (bQuoted == true || strValue.isEmpty()))
+        {
+            //Start or end of a quoted value
+            bQuoted = !bQuoted;
+        }
+        else if (bQuoted == false && chThis == ',')
+        {
+            //End of value
+            lstRow.append(strValue);
+            strValue.clear();
+        }
+        else if (bQuoted == false && (chThis == '\n' || chThis == '\r'))
+        {
+            //End of row, empty rows are skipped
+            if (chThis == '\r' && i + 1 < strData.length() && strData.at(i + 1) == '\n')
+            {
+                ++i;
+            }
+            lstRow.append(strValue);
+            strValue.clear();
+            if (lstRow.count() > 1 || !lstRow.at(0).isEmpty())
+            {
+                if (plstColumns->isEmpty())
+                {
+                    //Header row, parameter names are used as variable names
+                    int j = 0;
+                    while (j < lstRow.count())
+                    {
+                        lstRow[j] = lstRow.at(j).trimmed();
+                        if (!lstRow.at(j).contains(reName) || lstRow.indexOf(lstRow.at(j)) != j)
+                        {
+                            *pstrError = QString("Parameter table column ").append(QString::number(j + 1)).append(" has an invalid or duplicate name: ").append(lstRow.at(j));
+                            return false;
+                        }
+                        ++j;
+                    }
+                    *plstColumns = lstRow;
+                }
+                else if (lstRow.count() != plstColumns->count())
+                {
+                    //Wrong number of values
+                    *pstrError = QString("Parameter table row on line ").append(QString::number(intRowLine)).append(" has ").append(QString::number(lstRow.count())).append(" values, expected ").append(QString::number(plstColumns->count())).append(".");
+                    return false;
+                }
+                else
+                {
+                    plstRows->append(lstRow);
+                }
+            }
+            lstRow.clear();
+            ++intLine;
+            intRowLine = intLine;
+        }
+        else
+        {
+            //Part of a value
+            if (chThis == '\n')
+            {
+                ++intLine;
+            }
+            strValue.append(chThis);
+        }
+        ++i;
+    }
+
+    if (plstColumns->isEmpty() || plstRows->isEmpty())
+    {
+        *pstrError = "Parameter table must have a header row of parameter names and at least one row of values.";
+        return false;
+    }
+    return true;
+}
+
+/******************************************************************************/
+// END OF FILE
+/******************************************************************************/
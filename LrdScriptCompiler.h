@@ -0,0 +1,173 @@
+/******************************************************************************
+** Copyright (C) 2016 Laird
+**
+** Project: UwTerminalX
+**
+** Module: LrdScriptCompiler.h
+**
+** Notes:
+**
+** License: This program is free software: you can redistribute it and/or
+**          modify it under the terms of the GNU General Public License as
+**          published by the Free Software Foundation, version 3.
+**
+**          This program is distributed in the hope that it will be useful,
+**          but WITHOUT ANY WARRANTY; without even the implied warranty of
+**          MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+**          GNU General Public License for more details.
+**
+**          You should have received a copy of the GNU General Public License
+**          along with this program.  If not, see http://www.gnu.org/licenses/
+**
+*******************************************************************************/
+#ifndef LRDSCRIPTCOMPILER_H
+#define LRDSCRIPTCOMPILER_H
+
+/******************************************************************************/
+// Include Files
+/******************************************************************************/
+#include <QString>
+#include <QStringList>
+#include <QByteArray>
+#include <QVector>
+#include <QList>
+#include <QRegularExpression>
+#include <QHash>
+#include <QFile>
+#include "UwxEscape.h"
+#include "LrdMultiMatcher.h"
+
+/******************************************************************************/
+// Defines
+/******************************************************************************/
+#define ScriptingDataIn                '<'   //Command that waits for data to be received
+#define ScriptingDataOut               '>'   //Command that sends data out to module
+#define ScriptingWaitTime              '~'   //Command that waits for a period of time (in ms, or in us with a us suffix)
+#define ScriptingRegexIn               '?'   //Command that waits for data matching a regular expression to be received, capture groups are stored in variables
+#define ScriptingComment               "//"  //A null-function command that is used to explain/comment code
+#define ScriptingControl               '#'   //Command prefix for loop, counter and conditional statements (#LOOP, #IF, #SET...)
+#define ScriptingJavaScript            "//javascript" //First line of scripts which are run by the JavaScript engine instead of being compiled
+#define ScriptingOpSend                1     //Instruction opcode: send the payload out
+#define ScriptingOpReceive             2     //Instruction opcode: wait for the payload to be received
+#define ScriptingOpWait                3     //Instruction opcode: wait for a period of time
+#define ScriptingOpRegexReceive        4     //Instruction opcode: wait for data matching the expression to be received
+#define ScriptingOpLoopStart           5     //Instruction opcode: start a loop (sets the loop counter)
+#define ScriptingOpLoopEnd             6     //Instruction opcode: end of a loop, jumps back to the start of the loop until the counter runs out
+#define ScriptingOpJump                7     //Instruction opcode: jump to another instruction
+#define ScriptingOpJumpIfNot           8     //Instruction opcode: jump to another instruction if the comparison is false
+#define ScriptingOpSet                 9     //Instruction opcode: set a variable
+#define ScriptingOpAdd                 10    //Instruction opcode: add a value to a numeric variable
+#define ScriptingOpParam               11    //Instruction opcode: check a parameter has been set, setting it to its default value (if it has one) otherwise
+#define ScriptingOpReceiveAny          12    //Instruction opcode: wait for any of the alternatives to be received, the variable is set to the number of the one that was
+#define ScriptingAlternativeSeparator  '|'   //Separates the alternatives of #WAITANY statements
+#define ScriptingCompareEqual          1     //Comparison: ==
+#define ScriptingCompareNotEqual       2     //Comparison: !=
+#define ScriptingCompareLess           3     //Comparison: <
+#define ScriptingCompareLessEqual      4     //Comparison: <=
+#define ScriptingCompareGreater        5     //Comparison: >
+#define ScriptingCompareGreaterEqual   6     //Comparison: >=
+#define ScriptingBlockLoop             1     //Compiler block type: #LOOP
+#define ScriptingBlockIf               2     //Compiler block type: #IF
+
+/******************************************************************************/
+// Forward declaration of Class, Struct & Unions
+/******************************************************************************/
+struct LrdScriptInstruction
+{
+    unsigned char ucOpcode; //Operation to perform (ScriptingOp*)
+    QByteArray baData; //Payload to send or match (escape sequences already processed)
+    QList<QByteArray> lstParts; //Send instructions that use variables, set instructions and the left side of comparisons: alternating literal data and variable names (empty if no variables are used)
+    QList<QByteArray> lstCompareParts; //Right side of comparisons: alternating literal data and variable names
+    QRegularExpression reExpression; //Precompiled expression for regular expression receive instructions
+    LrdMultiMatcher matAlternatives; //Prebuilt matcher for the alternatives of receive any instructions
+    qint64 intWaitTime; //Time to wait (in us) for wait instructions
+    qint64 intValue; //Number of iterations for loop instructions, amount to add for add instructions, 1 if a parameter has a default value
+    int intLoop; //Index of the loop counter used by loop instructions
+    int intJump; //Instruction to jump to for loop and jump instructions
+    unsigned char ucCompare; //Comparison for conditional jumps (ScriptingCompare*)
+    QByteArray baName; //Name of the variable for set/add/parameter/receive any instructions and the (optional) loop iteration variable
+    int intLine; //Source line (0-based) the instruction was compiled from
+};
+
+/******************************************************************************/
+// Class definitions
+/******************************************************************************/
+class LrdScriptCompiler
+{
+public:
+    static bool
+    Compile(
+        const QStringList &lstLines,
+        QVector<LrdScriptInstruction> *pvecProgram,
+        QList<int> *plstBadLines
+        );
+    static bool
+    CompileLine(
+        const QString &strLine,
+        int intLine,
+        QVector<LrdScriptInstruction> *pvecProgram
+        );
+    static bool
+    CheckLine(
+        const QString &strLine
+        );
+    static bool
+    IsJavaScript(
+        const QString &strFirstLine
+        );
+    static bool
+    FillVariables(
+        const QList<QByteArray> &lstParts,
+        const QHash<QByteArray, QByteArray> &hashVariables,
+        QByteArray *pbaOutput,
+        QByteArray *pbaMissing
+        );
+    static bool
+    CompareValues(
+        const QByteArray &baLeft,
+        unsigned char ucCompare,
+        const QByteArray &baRight
+        );
+    static bool
+    LoadParameterTable(
+        const QString &strFilename,
+        QStringList *plstColumns,
+        QList<QStringList> *plstRows,
+        QString *pstrError
+        );
+
+private:
+    struct Block
+    {
+        unsigned char ucType; //Type of block (ScriptingBlock*)
+        int intInstruction; //Instruction which started the block
+        int intLine; //Source line which started the block
+        int intElse; //Jump instruction at the #ELSE of an #IF block (-1 if none)
+        QList<int> lstBreaks; //Jump instructions at #BREAK statements inside a #LOOP block
+    };
+    static bool
+    CompileControl(
+        const QString &strLine,
+        int intLine,
+        QVector<LrdScriptInstruction> *pvecProgram,
+        QList<Block> *plstBlocks,
+        int *pintLoops
+        );
+    static void
+    SplitVariables(
+        const QString &strText,
+        QList<QByteArray> *plstParts
+        );
+
+    static QRegularExpression reVariable; //Regular expression used for finding variables (${name}) in send data
+    static QRegularExpression reName; //Regular expression used for checking variable names
+    static QRegularExpression reCondition; //Regular expression used for splitting #IF comparisons
+    static QRegularExpression reWaitTime; //Regular expression used for checking wait times
+    static QRegularExpression reWhitespace; //Regular expression used for splitting control statements into their keyword and arguments
+};
+
+#endif // LRDSCRIPTCOMPILER_H
+
+/******************************************************************************/
+// END OF FILE
+/******************************************************************************/
@@ -0,0 +1,706 @@
+/******************************************************************************
+** Copyright (C) 2016 Laird
+**
+** Project: UwTerminalX
+**
+** Module: LrdScriptExecutor.cpp
+**
+** Notes:
+**
+** License: This program is free software: you can redistribute it and/or
+**          modify it under the terms of the GNU General Public License as
+**          published by the Free Software Foundation, version 3.
+**
+**          This program is distributed in the hope that it will be useful,
+**          but WITHOUT ANY WARRANTY; without even the implied warranty of
+**          MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+**          GNU General Public License for more details.
+**
+**          You should have received a copy of the GNU General Public License
+**          along with this program.  If not, see http://www.gnu.org/licenses/
+**
+*******************************************************************************/
+/******************************************************************************/
+// Include Files
+/******************************************************************************/
+#include "LrdScriptExecutor.h"
+
+/******************************************************************************/
+// Local Functions or Private Members
+/******************************************************************************/
+LrdScriptExecutor::LrdScriptExecutor(QObject *parent) : QObject(parent)
+{
+    //Setup timers
+    mtmrPauseTimer.setSingleShot(true);
+    mtmrPauseTimer.setTimerType(Qt::PreciseTimer);
+    mtmrRecvTimer.setSingleShot(true);
+    connect(&mtmrPauseTimer, SIGNAL(timeout()), this, SLOT(PauseTimerElapsed()));
+    connect(&mtmrRecvTimer, SIGNAL(timeout()), this, SLOT(RecvTimeout()));
+
+    //Not running
+    mintProgramCounter = 0;
+    mbIsRunning = false;
+    mbPaused = false;
+    mucAction = ScriptingActionOther;
+    mintRecvTime = 1;
+    mintRecvBufSize = 1;
+    mbWaitingForReceive = false;
+    mintRecvScanned = 0;
+    mbWaitForWrite = false;
+    mbWaitingForWrite = false;
+    mintBytesWriteRemain = 0;
+    mintTimerDeadline = -1;
+    mintWaitDeadline = 0;
+    mintWaitTime = 0;
+    mbWaitScheduled = false;
+}
+
+//=============================================================================
+//=============================================================================
+LrdScriptExecutor::~LrdScriptExecutor(
+    )
+{
+    //Disconnect timers
+    disconnect(&mtmrPauseTimer, SIGNAL(timeout()), this, SLOT(PauseTimerElapsed()));
+    disconnect(&mtmrRecvTimer, SIGNAL(timeout()), this, SLOT(RecvTimeout()));
+}
+
+//=============================================================================
+//=============================================================================
+void
+LrdScriptExecutor::SetReceiveLimits(
+    int intRecvTime,
+    int intRecvBufSize
+    )
+{
+    //Sets the time (in seconds) and number of bytes a receive waits for before the script fails
+    mintRecvTime = intRecvTime;
+    mintRecvBufSize = intRecvBufSize;
+}
+
+//=============================================================================
+//=============================================================================
+void
+LrdScriptExecutor::SetWaitForWrite(
+    bool bWaitForWrite
+    )
+{
+    //Sets if sends wait for the data to be written (reported with DataWritten()) before the next instruction is run
+    mbWaitForWrite = bWaitForWrite;
+}
+
+//=============================================================================
+//=============================================================================
+void
+LrdScriptExecutor::Start(
+    const QVector<LrdScriptInstruction> &vecProgram,
+    const QHash<QByteArray, QByteArray> &hashVariables
+    )
+{
+    //Runs a compiled script from the first instruction with the initial variables (e.g. parameters)
+    Stop();
+    mvecProgram = vecProgram;
+    mintProgramCounter = 0;
+    mhashVariables = hashVariables;
+    mvecLoopCounters.clear();
+    mucAction = ScriptingActionOther;
+    mbWaitScheduled = false;
+    mintTimerDeadline = -1;
+    mhstWaitJitter.Reset();
+    mbIsRunning = true;
+    mtmrScriptTimer.start();
+
+    //Run up to the first instruction that has to wait
+    AdvanceLine();
+}
+
+//=============================================================================
+//=============================================================================
+void
+LrdScriptExecutor::Stop(
+    )
+{
+    //Stops execution and clears the receive buffer, ScriptFinished() is not emitted
+    mbIsRunning = false;
+    mtmrPauseTimer.stop();
+    mtmrRecvTimer.stop();
+    mtmrRecvElapsed.invalidate();
+    ClearRecvData();
+    mbWaitingForReceive = false;
+    mbWaitingForWrite = false;
+}
+
+//=============================================================================
+//=============================================================================
+void
+LrdScriptExecutor::SetPaused(
+    bool bPaused
+    )
+{
+    //Pauses or resumes execution. Waits and writes that are in progress carry on whilst paused, the next instruction is run once they have finished and execution is resumed
+    mbPaused = bPaused;
+    if (mbPaused == false && mbIsRunning == true && !mtmrPauseTimer.isActive() && mbWaitingForWrite == false)
+    {
+        //Continue (or re-check the data being waited for)
+        AdvanceLine();
+    }
+}
+
+//=============================================================================
+//=============================================================================
+void
+LrdScriptExecutor::DataReceived(
+    const QByteArray &baData
+    )
+{
+    //Data has been received from the device
+    if (mbIsRunning == true)
+    {
+        mbufRecvData.Append(baData);
+        if (mbWaitingForReceive == true)
+        {
+            //Check if there is a match for this line
+            AdvanceLine();
+        }
+    }
+}
+
+//=============================================================================
+//=============================================================================
+void
+LrdScriptExecutor::DataWritten(
+    qint64 intWritten
+    )
+{
+    //Data has been written to the device, runs the next instruction once all of the sent data has been written (when waiting for writes)
+    if (mbIsRunning == true && mbWaitingForWrite == true)
+    {
+        mintBytesWriteRemain -= intWritten;
+        if (mintBytesWriteRemain <= 0)
+        {
+            //Bytes have been fully written, advance to next instruction
+            mbWaitingForWrite = false;
+            ++mintProgramCounter;
+            AdvanceLine();
+        }
+    }
+}
+
+//=============================================================================
+//=============================================================================
+void
+LrdScriptExecutor::AdvanceLine(
+    )
+{
+    //Executes instructions until the script has to wait for data, a period of time or a write
+    int intInstructions = 0;
+    while (mbIsRunning == true && mintProgramCounter < mvecProgram.count())
+    {
+        const LrdScriptInstruction *siInstruction = &mvecProgram.at(mintProgramCounter);
+        if (mbPaused == true)
+        {
+            //Execution is paused
+            mbWaitScheduled = false;
+            return;
+        }
+        else if (intInstructions >= ScriptingMaxInstructionsPerSlice)
+        {
+            //Let the event loop run (to process received data, stop/pause and repaints) before continuing
+            mucAction = ScriptingActionOther;
+            mintTimerDeadline = -1;
+            mtmrPauseTimer.start(0);
+            emit StatusChanged();
+            return;
+        }
+        ++intInstructions;
+
+        if (mbWaitingForReceive == false)
+        {
+            //Instruction is starting (not re-checking a receive)
+            emit LineChanged(siInstruction->intLine);
+        }
+
+        if (siInstruction->ucOpcode == ScriptingOpLoopStart)
+        {
+            //Start of a loop, set the number of iterations
+            if (siInstruction->intLoop >= mvecLoopCounters.count())
+            {
+                mvecLoopCounters.resize(siInstruction->intLoop + 1);
+            }
+            mvecLoopCounters[siInstruction->intLoop] = siInstruction->intValue;
+            if (!siInstruction->baName.isEmpty())
+            {
+                //First iteration
+                mhashVariables.insert(siInstruction->baName, "1");
+            }
+            ++mintProgramCounter;
+        }
+        else if (siInstruction->ucOpcode == ScriptingOpLoopEnd)
+        {
+            //End of a loop, go back to the start until all iterations have been run
+            --mvecLoopCounters[siInstruction->intLoop];
+            if (mvecLoopCounters.at(siInstruction->intLoop) > 0)
+            {
+                //Next iteration
+                if (!siInstruction->baName.isEmpty())
+                {
+                    mhashVariables.insert(siInstruction->baName, QByteArray::number(siInstruction->intValue - mvecLoopCounters.at(siInstruction->intLoop) + 1));
+                }
+                mintProgramCounter = siInstruction->intJump;
+            }
+            else
+            {
+                //Loop has finished
+                ++mintProgramCounter;
+            }
+        }
+        else if (siInstruction->ucOpcode == ScriptingOpJump)
+        {
+            //#ELSE or #BREAK
+            mintProgramCounter = siInstruction->intJump;
+        }
+        else if (siInstruction->ucOpcode == ScriptingOpJumpIfNot)
+        {
+            //#IF, skip to the #ELSE/#ENDIF if the comparison is false
+            QByteArray baLeft;
+            QByteArray baRight;
+            if (FillVariables(siInstruction->lstParts, &baLeft) == false || FillVariables(siInstruction->lstCompareParts, &baRight) == false)
+            {
+                //Variable has not been set
+                return;
+            }
+            mintProgramCounter = (LrdScriptCompiler::CompareValues(baLeft, siInstruction->ucCompare, baRight) == true ? mintProgramCounter + 1 : siInstruction->intJump);
+        }
+        else if (siInstruction->ucOpcode == ScriptingOpSet)
+        {
+            //Set variable
+            QByteArray baValue;
+            if (FillVariables(siInstruction->lstParts, &baValue) == false)
+            {
+                //Variable has not been set
+                return;
+            }
+            mhashVariables.insert(siInstruction->baName, baValue);
+            ++mintProgramCounter;
+        }
+        else if (siInstruction->ucOpcode == ScriptingOpAdd)
+        {
+            //Increment or decrement variable, unset or non-numeric variables count from 0
+            mhashVariables.insert(siInstruction->baName, QByteArray::number(mhashVariables.value(siInstruction->baName).toLongLong() + siInstruction->intValue));
+            ++mintProgramCounter;
+        }
+        else if (siInstruction->ucOpcode == ScriptingOpParam)
+        {
+            //Parameter, values from a parameter table are set before the script starts so only the default value is set here
+            if (!mhashVariables.contains(siInstruction->baName))
+            {
+                QByteArray baValue;
+                if (siInstruction->intValue == 0)
+                {
+                    //No value and no default
+                    Fail(QString("parameter ${").append(siInstruction->baName).append("} has not been set and has no default value"));
+                    return;
+                }
+                else if (FillVariables(siInstruction->lstParts, &baValue) == false)
+                {
+                    //Variable has not been set
+                    return;
+                }
+                mhashVariables.insert(siInstruction->baName, baValue);
+            }
+            ++mintProgramCounter;
+        }
+        else if (siInstruction->ucOpcode == ScriptingOpSend)
+        {
+            //Clear receive buffer and send data out
+            ClearRecvData();
+            QByteArray baSendData = siInstruction->baData;
+            if (!siInstruction->lstParts.isEmpty() && FillVariables(siInstruction->lstParts, &baSendData) == false)
+            {
+                //Variable has not been set
+                return;
+            }
+
+            //The number of bytes remaining to be written is only used when waiting for writes
+            mucAction = ScriptingActionDataOut;
+            mintBytesWriteRemain = baSendData.length();
+            mbWaitingForWrite = (mbWaitForWrite == true && mintBytesWriteRemain > 0);
+            emit SendData(baSendData);
+            if (mbIsRunning == false)
+            {
+                //Stopped whilst sending (e.g. port error)
+                return;
+            }
+            emit StatusChanged();
+
+            if (mbWaitingForWrite == true)
+            {
+                //Wait for data to leave the buffer, DataWritten() runs the next instruction
+                mbWaitScheduled = false;
+                return;
+            }
+            ++mintProgramCounter;
+        }
+        else if (siInstruction->ucOpcode == ScriptingOpReceive || siInstruction->ucOpcode == ScriptingOpRegexReceive || siInstruction->ucOpcode == ScriptingOpReceiveAny)
+        {
+            //Receive
+            if (mbWaitingForReceive == false)
+            {
+                //Start searching from the first unconsumed byte
+                if (siInstruction->ucOpcode == ScriptingOpReceive)
+                {
+                    mmatRecvMatcher.SetPattern(siInstruction->baData);
+                }
+                else if (siInstruction->ucOpcode == ScriptingOpReceiveAny)
+                {
+                    //The automaton was built when compiled, only the state is reset
+                    mmatRecvAnyMatcher = siInstruction->matAlternatives;
+                    mmatRecvAnyMatcher.Reset();
+                }
+                mintRecvScanned = mbufRecvData.Start();
+                mucAction = ScriptingActionDataIn;
+                mtmrRecvElapsed.start();
+                mtmrRecvTimer.start(mintRecvTime*1000);
+            }
+
+            qint64 intStart = mbufRecvData.Start();
+            if (CheckRecvMatch(siInstruction) == false)
+            {
+                //Waiting on a match
+                if (mbufRecvData.Length() > mintRecvBufSize)
+                {
+                    //Buffer is too big, fail the script
+                    Fail(QString("expected data not found after ").append(QString::number(mintRecvBufSize)).append(" bytes, ").append(QString::number(mbufRecvData.Length())).append(" bytes in buffer"));
+                    return;
+                }
+                mbWaitingForReceive = true;
+                mbWaitScheduled = false;
+                emit StatusChanged();
+                return;
+            }
+
+            //Data found, the matched data is only copied out if it is being used (e.g. for the command line output)
+            mbWaitingForReceive = false;
+            mtmrRecvTimer.stop();
+            mtmrRecvElapsed.invalidate();
+            if (receivers(SIGNAL(DataMatched(QByteArray))) > 0)
+            {
+                emit DataMatched(mbufRecvData.Mid(intStart, mintRecvScanned - intStart));
+            }
+            mbufRecvData.Consume(mintRecvScanned);
+            emit StatusChanged();
+            ++mintProgramCounter;
+        }
+        else if (siInstruction->ucOpcode == ScriptingOpWait)
+        {
+            //Wait for a specified period of time. If nothing has waited since the last wait, the deadline follows on from the last deadline (measured from the script start) so that timing errors do not accumulate
+            mucAction = ScriptingActionWaitTime;
+            mintWaitTime = siInstruction->intWaitTime;
+            mintWaitDeadline = (mbWaitScheduled == true ? mintWaitDeadline : mtmrScriptTimer.nsecsElapsed()) + mintWaitTime*1000;
+            mintTimerDeadline = mintWaitDeadline;
+            mbWaitScheduled = true;
+            ++mintProgramCounter;
+            StartPauseTimer();
+            emit StatusChanged();
+            return;
+        }
+        else
+        {
+            //Unknown instruction
+            ++mintProgramCounter;
+        }
+    }
+
+    if (mbIsRunning == true)
+    {
+        //Script has completed
+        mbIsRunning = false;
+        mtmrPauseTimer.stop();
+        mtmrRecvTimer.stop();
+        emit ScriptFinished(true, QString());
+    }
+}
+
+//=============================================================================
+//=============================================================================
+bool
+LrdScriptExecutor::CheckRecvMatch(
+    const LrdScriptInstruction *siInstruction
+    )
+{
+    //Checks if the receive buffer contains the data being waited for, on a match the end of the match is left in mintRecvScanned
+    if (siInstruction->ucOpcode == ScriptingOpReceive)
+    {
+        //Only data which has not been searched yet is passed to the matcher
+        qint64 intEnd = mbufRecvData.Search(&mmatRecvMatcher, mintRecvScanned);
+        if (intEnd == -1)
+        {
+            //Not found yet
+            mintRecvScanned = mbufRecvData.End();
+            return false;
+        }
+        mintRecvScanned = intEnd;
+
+        //Text found after the buffer size limit is a failure
+        return (intEnd - mmatRecvMatcher.PatternLength() - mbufRecvData.Start() < mintRecvBufSize);
+    }
+    else if (siInstruction->ucOpcode == ScriptingOpReceiveAny)
+    {
+        //All of the alternatives are searched for in a single pass over data which has not been searched yet
+        qint64 intEnd = mbufRecvData.Search(&mmatRecvAnyMatcher, mintRecvScanned);
+        if (intEnd == -1)
+        {
+            //Not found yet
+            mintRecvScanned = mbufRecvData.End();
+            return false;
+        }
+        mintRecvScanned = intEnd;
+        if (intEnd - mmatRecvAnyMatcher.MatchedLength() - mbufRecvData.Start() >= mintRecvBufSize)
+        {
+            //Found but after buffer size limit
+            return false;
+        }
+
+        //Store which alternative was received
+        mhashVariables.insert(siInstruction->baName, QByteArray::number(mmatRecvAnyMatcher.MatchedIndex() + 1));
+        return true;
+    }
+
+    //Regular expression, data before the earliest position that a match (or partial match) could start at is never searched again
+    QString strWindow = QString::fromLatin1(mbufRecvData.Mid(mintRecvScanned, mbufRecvData.End() - mintRecvScanned));
+    QRegularExpressionMatch remMatch = siInstruction->reExpression.match(strWindow);
+    if (remMatch.hasMatch() == false)
+    {
+        //No complete match, find where a match could still begin once more data arrives
+        remMatch = siInstruction->reExpression.match(strWindow, 0, QRegularExpression::PartialPreferFirstMatch);
+        mintRecvScanned += (remMatch.hasPartialMatch() == true ? remMatch.capturedStart(0) : strWindow.length());
+        return false;
+    }
+
+    qint64 intStart = mintRecvScanned + remMatch.capturedStart(0);
+    qint64 intEnd = mintRecvScanned + remMatch.capturedEnd(0);
+    if (intStart - mbufRecvData.Start() >= mintRecvBufSize)
+    {
+        //Found but after buffer size limit
+        mintRecvScanned = (intEnd > intStart ? intEnd : intStart + 1);
+        return false;
+    }
+
+    //Store capture groups by number and by name
+    QStringList lstGroupNames = siInstruction->reExpression.namedCaptureGroups();
+    int i = 1;
+    while (i <= remMatch.lastCapturedIndex())
+    {
+        QByteArray baValue = remMatch.captured(i).toLatin1();
+        mhashVariables.insert(QByteArray::number(i), baValue);
+        if (i < lstGroupNames.count() && !lstGroupNames.at(i).isEmpty())
+        {
+            mhashVariables.insert(lstGroupNames.at(i).toLatin1(), baValue);
+        }
+        ++i;
+    }
+    mintRecvScanned = intEnd;
+    return true;
+}
+
+//=============================================================================
+//=============================================================================
+bool
+LrdScriptExecutor::FillVariables(
+    const QList<QByteArray> &lstParts,
+    QByteArray *pbaOutput
+    )
+{
+    //Appends alternating literal data and variable values to the output. Fails the script and returns false if a variable has not been set
+    QByteArray baMissing;
+    if (LrdScriptCompiler::FillVariables(lstParts, mhashVariables, pbaOutput, &baMissing) == false)
+    {
+        //Variable has not been set by a parameter, previous regular expression receive, loop or #SET
+        Fail(QString("variable ${").append(baMissing).append("} has not been set"));
+        return false;
+    }
+    return true;
+}
+
+//=============================================================================
+//=============================================================================
+void
+LrdScriptExecutor::ClearRecvData(
+    )
+{
+    //Clears the receive buffer
+    mbufRecvData.Clear();
+    mintRecvScanned = 0;
+}
+
+//=============================================================================
+//=============================================================================
+void
+LrdScriptExecutor::StartPauseTimer(
+    )
+{
+    //Starts the pause timer so that it fires just before the deadline, the rest of the time is busy-waited in PauseTimerElapsed()
+    qint64 intRemaining = mintTimerDeadline - mtmrScriptTimer.nsecsElapsed() - ScriptingWaitSpinTime*1000;
+    mtmrPauseTimer.start(intRemaining > 0 ? (int)(intRemaining/1000000) : 0);
+}
+
+//=============================================================================
+//=============================================================================
+void
+LrdScriptExecutor::PauseTimerElapsed(
+    )
+{
+    //Pause timer has fired
+    if (mintTimerDeadline != -1)
+    {
+        if (mintTimerDeadline - mtmrScriptTimer.nsecsElapsed() > ScriptingWaitSpinTime*1000)
+        {
+            //Timer fired early, wait again
+            StartPauseTimer();
+            return;
+        }
+
+        //Busy-wait the last part of the wait
+        qint64 intNow = mtmrScriptTimer.nsecsElapsed();
+        while (intNow < mintTimerDeadline)
+        {
+            intNow = mtmrScriptTimer.nsecsElapsed();
+        }
+        mhstWaitJitter.Record((quint64)(intNow - mintTimerDeadline)/1000);
+        mintTimerDeadline = -1;
+    }
+
+    //Run the next instruction
+    AdvanceLine();
+}
+
+//=============================================================================
+//=============================================================================
+void
+LrdScriptExecutor::RecvTimeout(
+    )
+{
+    //Data was not received in time
+    if (mbIsRunning == true && mbWaitingForReceive == true)
+    {
+        Fail(QString("expected data not found after ").append(QString::number(mintRecvTime)).append(" seconds, ").append(QString::number(mbufRecvData.Length())).append(" bytes in buffer"));
+    }
+}
+
+//=============================================================================
+//=============================================================================
+void
+LrdScriptExecutor::Fail(
+    const QString &strMessage
+    )
+{
+    //Stops the script because the current instruction failed, the program counter is left on the instruction
+    mbIsRunning = false;
+    mtmrPauseTimer.stop();
+    mtmrRecvTimer.stop();
+    emit ScriptFinished(false, strMessage);
+}
+
+//=============================================================================
+//=============================================================================
+bool
+LrdScriptExecutor::IsRunning(
+    ) const
+{
+    //Returns true if a script is running
+    return mbIsRunning;
+}
+
+//=============================================================================
+//=============================================================================
+bool
+LrdScriptExecutor::IsWaitingForReceive(
+    ) const
+{
+    //Returns true if a receive instruction is waiting for data
+    return mbWaitingForReceive;
+}
+
+//=============================================================================
+//=============================================================================
+int
+LrdScriptExecutor::CurrentLine(
+    ) const
+{
+    //Returns the script line (0-based) of the instruction being executed, or -1 once the script has completed
+    return (mintProgramCounter < mvecProgram.count() ? mvecProgram.at(mintProgramCounter).intLine : -1);
+}
+
+//=============================================================================
+//=============================================================================
+unsigned char
+LrdScriptExecutor::Action(
+    ) const
+{
+    //Returns the action currently being executed (ScriptingAction*)
+    return mucAction;
+}
+
+//=============================================================================
+//=============================================================================
+qint64
+LrdScriptExecutor::ReceiveLength(
+    ) const
+{
+    //Returns the number of unconsumed bytes in the receive buffer
+    return mbufRecvData.Length();
+}
+
+//=============================================================================
+//=============================================================================
+qint64
+LrdScriptExecutor::ReceiveElapsed(
+    ) const
+{
+    //Returns the time (in ms) the current receive has been waiting for
+    return (mtmrRecvElapsed.isValid() ? mtmrRecvElapsed.elapsed() : 0);
+}
+
+//=============================================================================
+//=============================================================================
+qint64
+LrdScriptExecutor::WaitTime(
+    ) const
+{
+    //Returns the length (in us) of the current wait
+    return mintWaitTime;
+}
+
+//=============================================================================
+//=============================================================================
+qint64
+LrdScriptExecutor::WaitRemaining(
+    ) const
+{
+    //Returns the time (in ms) left until the current wait finishes
+    return (mintTimerDeadline == -1 ? 0 : qMax((qint64)0, (mintTimerDeadline - mtmrScriptTimer.nsecsElapsed())/1000000));
+}
+
+//=============================================================================
+//=============================================================================
+qint64
+LrdScriptExecutor::BytesWriteRemaining(
+    ) const
+{
+    //Returns the number of bytes of the last send that have not been written (only counted when waiting for writes)
+    return mintBytesWriteRemain;
+}
+
+//=============================================================================
+//=============================================================================
+const LrdHistogram &
+LrdScriptExecutor::WaitJitter(
+    ) const
+{
+    //Returns the time (in us) each wait finished after its deadline
+    return mhstWaitJitter;
+}
+
+/******************************************************************************/
+// END OF FILE
+/******************************************************************************/
@@ -0,0 +1,212 @@
+/******************************************************************************
+** Copyright (C) 2016 Laird
+**
+** Project: UwTerminalX
+**
+** Module: LrdScriptExecutor.h
+**
+** Notes:
+**
+** License: This program is free software: you can redistribute it and/or
+**          modify it under the terms of the GNU General Public License as
+**          published by the Free Software Foundation, version 3.
+**
+**          This program is distributed in the hope that it will be useful,
+**          but WITHOUT ANY WARRANTY; without even the implied warranty of
+**          MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+**          GNU General Public License for more details.
+**
+**          You should have received a copy of the GNU General Public License
+**          along with this program.  If not, see http://www.gnu.org/licenses/
+**
+*******************************************************************************/
+#ifndef LRDSCRIPTEXECUTOR_H
+#define LRDSCRIPTEXECUTOR_H
+
+/******************************************************************************/
+// Include Files
+/******************************************************************************/
+#include <QObject>
+#include <QString>
+#include <QStringList>
+#include <QByteArray>
+#include <QVector>
+#include <QHash>
+#include <QTimer>
+#include <QElapsedTimer>
+#include "LrdScriptCompiler.h"
+#include "LrdStreamMatcher.h"
+#include "LrdMultiMatcher.h"
+#include "LrdChunkBuffer.h"
+#include "LrdHistogram.h"
+
+/******************************************************************************/
+// Defines
+/******************************************************************************/
+#define ScriptingActionDataIn          1     //Action ID when waiting to receive data
+#define ScriptingActionDataOut         2     //Action ID when sending data out
+#define ScriptingActionWaitTime        3     //Action ID when waiting for a period of time
+#define ScriptingActionOther           4     //Action ID when doing no action (empty line/comment)
+#define ScriptingMaxInstructionsPerSlice 1000 //Maximum number of instructions run without returning to the event loop (so a loop that never waits cannot freeze the GUI or stop data being read)
+#define ScriptingWaitSpinTime          1000  //Time (in us) before a wait deadline that the wait timer fires at, the remainder is busy-waited for sub-millisecond accuracy
+
+/******************************************************************************/
+// Class definitions
+/******************************************************************************/
+class LrdScriptExecutor : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit LrdScriptExecutor(
+        QObject *parent = 0
+        );
+    ~LrdScriptExecutor(
+        );
+    void
+    SetReceiveLimits(
+        int intRecvTime,
+        int intRecvBufSize
+        );
+    void
+    SetWaitForWrite(
+        bool bWaitForWrite
+        );
+    void
+    Start(
+        const QVector<LrdScriptInstruction> &vecProgram,
+        const QHash<QByteArray, QByteArray> &hashVariables
+        );
+    void
+    Stop(
+        );
+    void
+    SetPaused(
+        bool bPaused
+        );
+    void
+    DataReceived(
+        const QByteArray &baData
+        );
+    void
+    DataWritten(
+        qint64 intWritten
+        );
+    bool
+    IsRunning(
+        ) const;
+    bool
+    IsWaitingForReceive(
+        ) const;
+    int
+    CurrentLine(
+        ) const;
+    unsigned char
+    Action(
+        ) const;
+    qint64
+    ReceiveLength(
+        ) const;
+    qint64
+    ReceiveElapsed(
+        ) const;
+    qint64
+    WaitTime(
+        ) const;
+    qint64
+    WaitRemaining(
+        ) const;
+    qint64
+    BytesWriteRemaining(
+        ) const;
+    const LrdHistogram &
+    WaitJitter(
+        ) const;
+
+signals:
+    void
+    SendData(
+        const QByteArray &baData
+        );
+    void
+    DataMatched(
+        const QByteArray &baData
+        );
+    void
+    LineChanged(
+        int intLine
+        );
+    void
+    StatusChanged(
+        );
+    void
+    ScriptFinished(
+        bool bPassed,
+        const QString &strMessage
+        );
+
+private slots:
+    void
+    AdvanceLine(
+        );
+    void
+    PauseTimerElapsed(
+        );
+    void
+    RecvTimeout(
+        );
+
+private:
+    bool
+    CheckRecvMatch(
+        const LrdScriptInstruction *siInstruction
+        );
+    bool
+    FillVariables(
+        const QList<QByteArray> &lstParts,
+        QByteArray *pbaOutput
+        );
+    void
+    ClearRecvData(
+        );
+    void
+    StartPauseTimer(
+        );
+    void
+    Fail(
+        const QString &strMessage
+        );
+
+    QVector<LrdScriptInstruction> mvecProgram; //Compiled script being executed
+    int mintProgramCounter; //Index of the instruction being executed
+    QHash<QByteArray, QByteArray> mhashVariables; //Variables set by parameters, regular expression capture groups, loops and #SET/#INC/#DEC
+    QVector<qint64> mvecLoopCounters; //Number of iterations remaining for each loop in the script
+    bool mbIsRunning; //True if the script is running
+    bool mbPaused; //True if execution is paused (the instruction being waited on still completes)
+    unsigned char mucAction; //Which action is currently being executed (ScriptingAction*)
+    int mintRecvTime; //Time (in seconds) to wait for data to be received before failing
+    int mintRecvBufSize; //Number of bytes to search for received data before failing
+    bool mbWaitingForReceive; //True if waiting in a receive instruction for data to arrive
+    LrdStreamMatcher mmatRecvMatcher; //Matcher for the data being waited for, partial matches carry over between received chunks
+    LrdMultiMatcher mmatRecvAnyMatcher; //Matcher for the alternatives being waited for by #WAITANY, partial matches carry over between received chunks
+    LrdChunkBuffer mbufRecvData; //Data received from the device (awaiting a match), data consumed by matches is freed a chunk at a time
+    qint64 mintRecvScanned; //Position in the receive data up to which data has been passed to the matcher (or, for regular expressions, the earliest position a match could still start at)
+    QTimer mtmrRecvTimer; //Fails the script if data is not received in time
+    QElapsedTimer mtmrRecvElapsed; //Times how long the current receive has been waiting
+    bool mbWaitForWrite; //True if sends wait for the data to be written before the next instruction is run
+    bool mbWaitingForWrite; //True if waiting for sent data to be written
+    qint64 mintBytesWriteRemain; //Number of bytes remaining to be written from the last send
+    QTimer mtmrPauseTimer; //Timer used for wait instructions (and to yield to the event loop)
+    QElapsedTimer mtmrScriptTimer; //Times the script from when it was started, wait deadlines are measured from this
+    qint64 mintTimerDeadline; //Time (in ns from the script start) the pause timer must run the next instruction at (-1 to run it as soon as the timer fires)
+    qint64 mintWaitDeadline; //Deadline (in ns from the script start) of the last wait, the next wait follows on from this so timing errors do not accumulate
+    qint64 mintWaitTime; //Length (in us) of the current wait
+    bool mbWaitScheduled; //True if the next wait can follow on from the last wait deadline (false after the script had to wait for data or was paused)
+    LrdHistogram mhstWaitJitter; //Time (in us) each wait finished after its deadline
+};
+
+#endif // LRDSCRIPTEXECUTOR_H
+
+/******************************************************************************/
+// END OF FILE
+/******************************************************************************/
@@ -0,0 +1,284 @@
+/******************************************************************************
+** Copyright (C) 2016 Laird
+**
+** Project: UwTerminalX
+**
+** Module: LrdScriptRecorder.cpp
+**
+** Notes:
+**
+** License: This program is free software: you can redistribute it and/or
+**          modify it under the terms of the GNU General Public License as
+**          published by the Free Software Foundation, version 3.
+**
+**          This program is distributed in the hope that it will be useful,
+**          but WITHOUT ANY WARRANTY; without even the implied warranty of
+**          MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+**          GNU General Public License for more details.
+**
+**          You should have received a copy of the GNU General Public License
+**          along with this program.  If not, see http://www.gnu.org/licenses/
+**
+*******************************************************************************/
+/******************************************************************************/
+// Include Files
+/******************************************************************************/
+#include "LrdScriptRecorder.h"
+
+/******************************************************************************/
+// Local Functions or Private Members
+/******************************************************************************/
+//Module status response lines: \n00\r for success or \n01\t<error code>\r for an error
+QRegularExpression LrdScriptRecorder::reStatus = QRegularExpression("\n0[0-9](\t[^\r\n]*)?\r");
+
+//=============================================================================
+//=============================================================================
+LrdScriptRecorder::LrdScriptRecorder(
+    )
+{
+    //Not recording
+    mbRecording = false;
+    mintSentCount = 0;
+}
+
+//=============================================================================
+//=============================================================================
+void
+LrdScriptRecorder::Start(
+    )
+{
+    //Clears any previous recording and starts a new one
+    mvecEvents.clear();
+    mintSentCount = 0;
+    mtmrRecording.start();
+    mbRecording = true;
+}
+
+//=============================================================================
+//=============================================================================
+void
+LrdScriptRecorder::Stop(
+    )
+{
+    //Stops recording, the recording is kept until the next one is started
+    mbRecording = false;
+}
+
+//=============================================================================
+//=============================================================================
+bool
+LrdScriptRecorder::IsRecording(
+    ) const
+{
+    //Returns true whilst recording
+    return mbRecording;
+}
+
+//=============================================================================
+//=============================================================================
+int
+LrdScriptRecorder::SentCount(
+    ) const
+{
+    //Returns the number of times data was sent in the recording
+    return mintSentCount;
+}
+
+//=============================================================================
+//=============================================================================
+void
+LrdScriptRecorder::RecordSent(
+    const QByteArray &baData
+    )
+{
+    //Records data sent to the module, this only stores the data so that recording does not slow down the terminal
+    if (mbRecording == true)
+    {
+        Event evSent;
+        evSent.bSent = true;
+        evSent.intStart = mtmrRecording.nsecsElapsed()/1000;
+        evSent.intEnd = evSent.intStart;
+        evSent.baData = baData;
+        mvecEvents.append(evSent);
+        ++mintSentCount;
+    }
+}
+
+//=============================================================================
+//=============================================================================
+void
+LrdScriptRecorder::RecordReceived(
+    const QByteArray &baData
+    )
+{
+    //Records data received from the module, data received between sends is joined together
+    if (mbRecording == true)
+    {
+        qint64 intNow = mtmrRecording.nsecsElapsed()/1000;
+        if (!mvecEvents.isEmpty() && mvecEvents.last().bSent == false)
+        {
+            //Add to the current response
+            mvecEvents.last().baData.append(baData);
+            mvecEvents.last().intEnd = intNow;
+        }
+        else
+        {
+            Event evReceived;
+            evReceived.bSent = false;
+            evReceived.intStart = intNow;
+            evReceived.intEnd = intNow;
+            evReceived.baData = baData;
+            mvecEvents.append(evReceived);
+        }
+    }
+}
+
+//=============================================================================
+//=============================================================================
+QString
+LrdScriptRecorder::GenerateScript(
+    const QString &strHeader
+    ) const
+{
+    //Converts the recording into a script. Each send becomes a > line followed by a < line waiting for the last stable line of the response (the status code where there is one). Where there is nothing to wait for, a ~ line keeps the recorded timing: the time the module took to respond, or the time until the next send if it did not respond
+    QStringList lstScript;
+    lstScript << QString("//").append(strHeader);
+
+    qint64 intLastSend = -1;
+    qint64 intLastResponse = -1;
+    bool bSynchronised = true;
+    int i = 0;
+    while (i < mvecEvents.count())
+    {
+        if (mvecEvents.at(i).bSent == false)
+        {
+            //Data received before anything was sent is not part of the script
+            ++i;
+            continue;
+        }
+
+        const Event *evSent = &mvecEvents.at(i);
+        if (bSynchronised == false && intLastSend != -1)
+        {
+            //The previous line has nothing to wait for, keep the recorded timing
+            qint64 intWait = ((intLastResponse != -1 ? intLastResponse : evSent->intStart) - intLastSend + 999)/1000;
+            lstScript << QString("~").append(QString::number(qMax((qint64)RecorderMinWait, intWait)));
+        }
+        lstScript << QString(">").append(EscapeData(evSent->baData));
+        intLastSend = evSent->intStart;
+        intLastResponse = -1;
+        ++i;
+
+        if (i < mvecEvents.count() && mvecEvents.at(i).bSent == false)
+        {
+            //Response to the data sent
+            QByteArray baAnchor = FindAnchor(mvecEvents.at(i).baData);
+            bSynchronised = !baAnchor.isEmpty();
+            if (bSynchronised == true)
+            {
+                lstScript << QString("<").append(EscapeData(baAnchor));
+            }
+            else
+            {
+                intLastResponse = mvecEvents.at(i).intEnd;
+            }
+            ++i;
+        }
+        else
+        {
+            //No response
+            bSynchronised = false;
+        }
+    }
+
+    return lstScript.join("\n").append("\n");
+}
+
+//=============================================================================
+//=============================================================================
+QByteArray
+LrdScriptRecorder::FindAnchor(
+    const QByteArray &baResponse
+    )
+{
+    //Finds the part of a response to wait for: the last status response, otherwise the last complete line. Returns an empty array if there is no complete line
+    QString strResponse = QString::fromLatin1(baResponse);
+    QRegularExpressionMatchIterator remiStatus = reStatus.globalMatch(strResponse);
+    QRegularExpressionMatch remLastStatus;
+    while (remiStatus.hasNext())
+    {
+        remLastStatus = remiStatus.next();
+    }
+    if (remLastStatus.hasMatch())
+    {
+        //Status codes do not change between runs
+        return remLastStatus.captured(0).toLatin1();
+    }
+
+    //Find the last line which is not empty, with its line ending
+    int intEnd = baResponse.length() - 1;
+    while (intEnd >= 0 && baResponse.at(intEnd) != '\r' && baResponse.at(intEnd) != '\n')
+    {
+        //Incomplete line at the end of the response
+        --intEnd;
+    }
+    while (intEnd > 0 && (baResponse.at(intEnd - 1) == '\r' || baResponse.at(intEnd - 1) == '\n'))
+    {
+        //Empty lines
+        --intEnd;
+    }
+    if (intEnd <= 0)
+    {
+        //No complete line
+        return QByteArray();
+    }
+
+    int intStart = intEnd - 1;
+    while (intStart > 0 && baResponse.at(intStart - 1) != '\r' && baResponse.at(intStart - 1) != '\n' && intEnd - intStart < RecorderMaxAnchorLength)
+    {
+        --intStart;
+    }
+    return baResponse.mid(intStart, intEnd - intStart + 1);
+}
+
+//=============================================================================
+//=============================================================================
+QString
+LrdScriptRecorder::EscapeData(
+    const QByteArray &baData
+    )
+{
+    //Converts data to script escape sequences (\r, \n, \t and \HH for other control characters, bytes above 0x7F so that data which is not valid UTF-8 is kept, backslashes and dollar signs so ${...} is not read back as a variable)
+    QByteArray baEscaped;
+    int i = 0;
+    while (i < baData.length())
+    {
+        unsigned char ucChar = (unsigned char)baData.at(i);
+        if (ucChar == '\r')
+        {
+            baEscaped.append("\\r");
+        }
+        else if (ucChar == '\n')
+        {
+            baEscaped.append("\\n");
+        }
+        else if (ucChar == '\t')
+        {
+            baEscaped.append("\\t");
+        }
+        else if (ucChar < 0x20 || ucChar >= 0x7F || ucChar == '\\' || ucChar == '$')
+        {
+            baEscaped.append("\\").append(QByteArray::number(ucChar, 16).toUpper().rightJustified(2, '0'));
+        }
+        else
+        {
+            baEscaped.append((char)ucChar);
+        }
+        ++i;
+    }
+    return QString::fromLatin1(baEscaped);
+}
+
+/******************************************************************************/
+// END OF FILE
+/******************************************************************************/
@@ -0,0 +1,103 @@
+/******************************************************************************
+** Copyright (C) 2016 Laird
+**
+** Project: UwTerminalX
+**
+** Module: LrdScriptRecorder.h
+**
+** Notes:
+**
+** License: This program is free software: you can redistribute it and/or
+**          modify it under the terms of the GNU General Public License as
+**          published by the Free Software Foundation, version 3.
+**
+**          This program is distributed in the hope that it will be useful,
+**          but WITHOUT ANY WARRANTY; without even the implied warranty of
+**          MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+**          GNU General Public License for more details.
+**
+**          You should have received a copy of the GNU General Public License
+**          along with this program.  If not, see http://www.gnu.org/licenses/
+**
+*******************************************************************************/
+#ifndef LRDSCRIPTRECORDER_H
+#define LRDSCRIPTRECORDER_H
+
+/******************************************************************************/
+// Include Files
+/******************************************************************************/
+#include <QString>
+#include <QStringList>
+#include <QByteArray>
+#include <QVector>
+#include <QElapsedTimer>
+#include <QRegularExpression>
+
+/******************************************************************************/
+// Defines
+/******************************************************************************/
+#define RecorderMaxAnchorLength        64    //Maximum length of the response data a receive line waits for
+#define RecorderMinWait                1     //Minimum length (in ms) of a generated wait
+
+/******************************************************************************/
+// Class definitions
+/******************************************************************************/
+class LrdScriptRecorder
+{
+public:
+    LrdScriptRecorder(
+        );
+    void
+    Start(
+        );
+    void
+    Stop(
+        );
+    bool
+    IsRecording(
+        ) const;
+    int
+    SentCount(
+        ) const;
+    void
+    RecordSent(
+        const QByteArray &baData
+        );
+    void
+    RecordReceived(
+        const QByteArray &baData
+        );
+    QString
+    GenerateScript(
+        const QString &strHeader
+        ) const;
+
+private:
+    struct Event
+    {
+        bool bSent; //True for data sent to the module, false for data received
+        qint64 intStart; //Time (in us from the start of the recording) the data was sent or first received
+        qint64 intEnd; //Time (in us from the start of the recording) the last of the data was received
+        QByteArray baData; //Data sent or received (consecutive received data is joined)
+    };
+    static QByteArray
+    FindAnchor(
+        const QByteArray &baResponse
+        );
+    static QString
+    EscapeData(
+        const QByteArray &baData
+        );
+
+    QVector<Event> mvecEvents; //Data sent and received in the recording
+    QElapsedTimer mtmrRecording; //Times events from the start of the recording
+    bool mbRecording; //True whilst recording
+    int mintSentCount; //Number of send events in the recording
+    static QRegularExpression reStatus; //Regular expression used for finding module status responses (e.g. 00 or 01 with an error code)
+};
+
+#endif // LRDSCRIPTRECORDER_H
+
+/******************************************************************************/
+// END OF FILE
+/******************************************************************************/
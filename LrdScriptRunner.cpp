@@ -0,0 +1,475 @@
+/******************************************************************************
+** Copyright (C) 2016 Laird
+**
+** Project: UwTerminalX
+**
+** Module: LrdScriptRunner.cpp
+**
+** Notes:
+**
+** License: This program is free software: you can redistribute it and/or
+**          modify it under the terms of the GNU General Public License as
+**          published by the Free Software Foundation, version 3.
+**
+**          This program is distributed in the hope that it will be useful,
+**          but WITHOUT ANY WARRANTY; without even the implied warranty of
+**          MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+**          GNU General Public License for more details.
+**
+**          You should have received a copy of the GNU General Public License
+**          along with this program.  If not, see http://www.gnu.org/licenses/
+**
+*******************************************************************************/
+/******************************************************************************/
+// Include Files
+/******************************************************************************/
+#include "LrdScriptRunner.h"
+#include <QCoreApplication>
+#include <QFile>
+#include <QFileInfo>
+#include <QXmlStreamWriter>
+#include <stdio.h>
+
+/******************************************************************************/
+// Local Functions or Private Members
+/******************************************************************************/
+LrdScriptRunner::LrdScriptRunner(QObject *parent) : QObject(parent), mtsOutput(stdout)
+{
+    //Connect script executor signals
+    connect(&mexeScript, SIGNAL(SendData(QByteArray)), this, SLOT(ScriptSendData(QByteArray)));
+    connect(&mexeScript, SIGNAL(DataMatched(QByteArray)), this, SLOT(ScriptDataMatched(QByteArray)));
+    connect(&mexeScript, SIGNAL(ScriptFinished(bool,QString)), this, SLOT(ScriptFinished(bool,QString)));
+
+    //Connect serial port signals
+    connect(&mspSerialPort, SIGNAL(readyRead()), this, SLOT(SerialRead()));
+    connect(&mspSerialPort, SIGNAL(error(QSerialPort::SerialPortError)), this, SLOT(SerialError(QSerialPort::SerialPortError)));
+
+    //Default settings
+    mbQuiet = false;
+    mintRecvTime = ScriptRunnerDefaultRecvTime;
+    mintRecvBufSize = ScriptRunnerDefaultRecvSize;
+    mbIsRunning = false;
+    mintExitCode = ScriptRunnerExitError;
+}
+
+//=============================================================================
+//=============================================================================
+LrdScriptRunner::~LrdScriptRunner(
+    )
+{
+    //Disconnect signals and close the port
+    disconnect(&mexeScript, SIGNAL(SendData(QByteArray)), this, SLOT(ScriptSendData(QByteArray)));
+    disconnect(&mexeScript, SIGNAL(DataMatched(QByteArray)), this, SLOT(ScriptDataMatched(QByteArray)));
+    disconnect(&mexeScript, SIGNAL(ScriptFinished(bool,QString)), this, SLOT(ScriptFinished(bool,QString)));
+    disconnect(&mspSerialPort, SIGNAL(readyRead()), this, SLOT(SerialRead()));
+    disconnect(&mspSerialPort, SIGNAL(error(QSerialPort::SerialPortError)), this, SLOT(SerialError(QSerialPort::SerialPortError)));
+    if (mspSerialPort.isOpen())
+    {
+        mspSerialPort.close();
+    }
+}
+
+//=============================================================================
+//=============================================================================
+bool
+LrdScriptRunner::IsHeadless(
+    int argc,
+    char *argv[]
+    )
+{
+    //Checks if the command line asks for a script to be run without the GUI, this is checked before any application object exists
+    int i = 1;
+    while (i < argc)
+    {
+        QString strArgument = QString::fromLocal8Bit(argv[i]).toUpper();
+        if (strArgument == "HEADLESS" || strArgument == "--HEADLESS")
+        {
+            return true;
+        }
+        ++i;
+    }
+    return false;
+}
+
+//=============================================================================
+//=============================================================================
+bool
+LrdScriptRunner::Start(
+    const QStringList &lstArguments
+    )
+{
+    //Loads, compiles and starts running the script. Returns false (with the exit code set) if the script cannot be run
+    if (ParseArguments(lstArguments) == false)
+    {
+        //Invalid arguments
+        QTextStream(stderr) << "Usage: UwTerminalX HEADLESS COM=<port> SCRIPT=<file> [BAUD=<baud>] [STOP=<1|2>] [DATA=<7|8>] [PAR=<0-2>] [FLOW=<0-2>] [JUNIT=<file>] [RECVTIME=<seconds>] [RECVSIZE=<bytes>] [QUIET]\n";
+        mintExitCode = ScriptRunnerExitError;
+        return false;
+    }
+
+    //Load the script
+    QFile fileScript(mstrScriptFile);
+    if (!fileScript.open(QIODevice::ReadOnly | QIODevice::Text))
+    {
+        //Unable to open script
+        QString strMessage = QString("Unable to open script file: ").append(mstrScriptFile);
+        QTextStream(stderr) << strMessage << "\n";
+        mintExitCode = ScriptRunnerExitError;
+        WriteJUnit(strMessage);
+        return false;
+    }
+    mlstScriptLines = QString::fromUtf8(fileScript.readAll()).replace("\r\n", "\n").split('\n');
+    fileScript.close();
+
+    //Compile the script
+    QList<int> lstBadLines;
+    if (LrdScriptCompiler::Compile(mlstScriptLines, &mvecProgram, &lstBadLines) == false)
+    {
+        //Syntax errors
+        QString strMessage = QString("Script failed to compile, errors on line(s):");
+        int i = 0;
+        while (i < lstBadLines.count())
+        {
+            strMessage.append(" ").append(QString::number(lstBadLines.at(i) + 1));
+            ++i;
+        }
+        QTextStream(stderr) << strMessage << "\n";
+        mintExitCode = ScriptRunnerExitError;
+        WriteJUnit(strMessage);
+        return false;
+    }
+
+    //Open the port
+    if (!mspSerialPort.open(QIODevice::ReadWrite))
+    {
+        //Port failed to open
+        QString strMessage = QString("Unable to open port ").append(mspSerialPort.portName()).append(": ").append(mspSerialPort.errorString());
+        QTextStream(stderr) << strMessage << "\n";
+        mintExitCode = ScriptRunnerExitPortError;
+        WriteJUnit(strMessage);
+        return false;
+    }
+
+    //Run the script once the event loop has started (so that finishing can exit it)
+    mbIsRunning = true;
+    mtmrScriptTimer.start();
+    QTimer::singleShot(0, this, SLOT(RunScript()));
+    return true;
+}
+
+//=============================================================================
+//=============================================================================
+int
+LrdScriptRunner::ExitCode(
+    )
+{
+    //Returns the exit code for the application
+    return mintExitCode;
+}
+
+//=============================================================================
+//=============================================================================
+bool
+LrdScriptRunner::ParseArguments(
+    const QStringList &lstArguments
+    )
+{
+    //Reads the port settings and options from the command line, these use the same format as the GUI arguments
+    mspSerialPort.setBaudRate(115200);
+    mspSerialPort.setDataBits(QSerialPort::Data8);
+    mspSerialPort.setStopBits(QSerialPort::OneStop);
+    mspSerialPort.setParity(QSerialPort::NoParity);
+    mspSerialPort.setFlowControl(QSerialPort::HardwareControl);
+
+    int i = 1;
+    while (i < lstArguments.count())
+    {
+        QString strArgument = lstArguments.at(i);
+        if (strArgument.left(4).toUpper() == "COM=")
+        {
+            //Serial port
+            mspSerialPort.setPortName(strArgument.mid(4));
+        }
+        else if (strArgument.left(5).toUpper() == "BAUD=")
+        {
+            //Baud rate
+            mspSerialPort.setBaudRate(strArgument.mid(5).toInt());
+        }
+        else if (strArgument.left(5).toUpper() == "STOP=")
+        {
+            //Stop bits
+            mspSerialPort.setStopBits(strArgument.right(1) == "2" ? QSerialPort::TwoStop : QSerialPort::OneStop);
+        }
+        else if (strArgument.left(5).toUpper() == "DATA=")
+        {
+            //Data bits
+            mspSerialPort.setDataBits(strArgument.right(1) == "7" ? QSerialPort::Data7 : QSerialPort::Data8);
+        }
+        else if (strArgument.left(4).toUpper() == "PAR=")
+        {
+            //Parity
+            mspSerialPort.setParity(strArgument.right(1) == "1" ? QSerialPort::OddParity : (strArgument.right(1) == "2" ? QSerialPort::EvenParity : QSerialPort::NoParity));
+        }
+        else if (strArgument.left(5).toUpper() == "FLOW=")
+        {
+            //Flow control
+            mspSerialPort.setFlowControl(strArgument.right(1) == "1" ? QSerialPort::HardwareControl : (strArgument.right(1) == "2" ? QSerialPort::SoftwareControl : QSerialPort::NoFlowControl));
+        }
+        else if (strArgument.left(7).toUpper() == "SCRIPT=")
+        {
+            //Script to run
+            mstrScriptFile = strArgument.mid(7);
+        }
+        else if (strArgument.left(11).toUpper() == "SCRIPTFILE=")
+        {
+            //Script to run (same argument as the GUI)
+            mstrScriptFile = strArgument.mid(11);
+        }
+        else if (strArgument.left(6).toUpper() == "JUNIT=")
+        {
+            //JUnit XML results file
+            mstrJUnitFile = strArgument.mid(6);
+        }
+        else if (strArgument.left(9).toUpper() == "RECVTIME=")
+        {
+            //Receive timeout
+            mintRecvTime = strArgument.mid(9).toInt();
+        }
+        else if (strArgument.left(9).toUpper() == "RECVSIZE=")
+        {
+            //Receive buffer size
+            mintRecvBufSize = strArgument.mid(9).toInt();
+        }
+        else if (strArgument.toUpper() == "QUIET")
+        {
+            //Only output the result
+            mbQuiet = true;
+        }
+        ++i;
+    }
+
+    return (!mspSerialPort.portName().isEmpty() && !mstrScriptFile.isEmpty() && mspSerialPort.baudRate() > 0 && mintRecvTime > 0 && mintRecvBufSize > 0);
+}
+
+//=============================================================================
+//=============================================================================
+void
+LrdScriptRunner::RunScript(
+    )
+{
+    //Starts executing the script (unless it has already failed), the receive limits are the same as the scripting dialogue options and there are no parameter table values
+    if (mbIsRunning == false)
+    {
+        return;
+    }
+    mexeScript.SetReceiveLimits(mintRecvTime, mintRecvBufSize);
+    mexeScript.Start(mvecProgram, QHash<QByteArray, QByteArray>());
+}
+
+//=============================================================================
+//=============================================================================
+void
+LrdScriptRunner::ScriptSendData(
+    const QByteArray &baData
+    )
+{
+    //Data sent by the script
+    mspSerialPort.write(baData);
+    Log(QString("> ").append(Printable(baData)));
+}
+
+//=============================================================================
+//=============================================================================
+void
+LrdScriptRunner::ScriptDataMatched(
+    const QByteArray &baData
+    )
+{
+    //Data received by the script, up to the end of the match
+    Log(QString("< ").append(Printable(baData)));
+}
+
+//=============================================================================
+//=============================================================================
+void
+LrdScriptRunner::ScriptFinished(
+    bool bPassed,
+    const QString &strMessage
+    )
+{
+    //Script has completed or failed
+    Finish((bPassed == true ? ScriptRunnerExitPass : ScriptRunnerExitFail), strMessage);
+}
+
+//=============================================================================
+//=============================================================================
+void
+LrdScriptRunner::SerialRead(
+    )
+{
+    //Serial port data received, passed to the script
+    mexeScript.DataReceived(mspSerialPort.readAll());
+}
+
+//=============================================================================
+//=============================================================================
+void
+LrdScriptRunner::SerialError(
+    QSerialPort::SerialPortError speErrorCode
+    )
+{
+    //Serial port error, fails the script
+    if (mbIsRunning == true && speErrorCode != QSerialPort::NoError && speErrorCode != QSerialPort::TimeoutError)
+    {
+        Finish(ScriptRunnerExitFail, QString("serial port error: ").append(mspSerialPort.errorString()));
+    }
+}
+
+//=============================================================================
+//=============================================================================
+void
+LrdScriptRunner::Log(
+    const QString &strMessage
+    )
+{
+    //Outputs a line of progress with the time and script line number
+    QString strLine = QString("[").append(QString::number((double)mtmrScriptTimer.nsecsElapsed()/1000000000.0, 'f', 3)).append("] #").append(QString::number(mexeScript.CurrentLine() + 1)).append(" ").append(strMessage);
+    if (mbQuiet == false)
+    {
+        //Flushed per line so progress is visible when the output is piped (e.g. to a CI log)
+        mtsOutput << strLine << "\n";
+        mtsOutput.flush();
+    }
+    if (!mstrJUnitFile.isEmpty())
+    {
+        mstrOutput.append(strLine).append("\n");
+    }
+}
+
+//=============================================================================
+//=============================================================================
+void
+LrdScriptRunner::Finish(
+    int intExitCode,
+    const QString &strMessage
+    )
+{
+    //Script has finished, outputs the result and exits the application
+    int intLine = mexeScript.CurrentLine();
+    mbIsRunning = false;
+    mexeScript.Stop();
+    mintExitCode = intExitCode;
+
+    QString strResult;
+    if (intExitCode == ScriptRunnerExitPass)
+    {
+        strResult = QString("PASS ").append(mstrScriptFile).append(" (").append(QString::number((double)mtmrScriptTimer.elapsed()/1000.0, 'f', 3)).append(" seconds)");
+    }
+    else
+    {
+        strResult = QString("FAIL ").append(mstrScriptFile).append(" line ").append(QString::number(intLine + 1)).append(intLine >= 0 && intLine < mlstScriptLines.count() ? QString(" (").append(mlstScriptLines.at(intLine)).append(")") : QString()).append(": ").append(strMessage).append(" after ").append(QString::number((double)mtmrScriptTimer.elapsed()/1000.0, 'f', 3)).append(" seconds");
+    }
+    mtsOutput << strResult << "\n";
+    mtsOutput.flush();
+    WriteJUnit(intExitCode == ScriptRunnerExitPass ? QString() : strResult);
+
+    //Let any data still being sent leave before closing
+    mspSerialPort.waitForBytesWritten(1000);
+    mspSerialPort.close();
+    QCoreApplication::exit(mintExitCode);
+}
+
+//=============================================================================
+//=============================================================================
+void
+LrdScriptRunner::WriteJUnit(
+    const QString &strMessage
+    )
+{
+    //Writes the result as a JUnit XML file with one test case for the script. Failures to run the script are reported as errors
+    if (mstrJUnitFile.isEmpty())
+    {
+        return;
+    }
+
+    QFile fileJUnit(mstrJUnitFile);
+    if (!fileJUnit.open(QIODevice::WriteOnly | QIODevice::Truncate))
+    {
+        //Unable to write results
+        QTextStream(stderr) << "Unable to write JUnit file: " << mstrJUnitFile << "\n";
+        return;
+    }
+
+    bool bFailed = (mintExitCode == ScriptRunnerExitFail);
+    bool bError = (mintExitCode != ScriptRunnerExitPass && mintExitCode != ScriptRunnerExitFail);
+    QString strTime = QString::number((mtmrScriptTimer.isValid() ? (double)mtmrScriptTimer.elapsed()/1000.0 : 0.0), 'f', 3);
+    QXmlStreamWriter xmlWriter(&fileJUnit);
+    xmlWriter.setAutoFormatting(true);
+    xmlWriter.writeStartDocument();
+    xmlWriter.writeStartElement("testsuites");
+    xmlWriter.writeStartElement("testsuite");
+    xmlWriter.writeAttribute("name", "UwTerminalX");
+    xmlWriter.writeAttribute("tests", "1");
+    xmlWriter.writeAttribute("failures", (bFailed == true ? "1" : "0"));
+    xmlWriter.writeAttribute("errors", (bError == true ? "1" : "0"));
+    xmlWriter.writeAttribute("time", strTime);
+    xmlWriter.writeStartElement("testcase");
+    xmlWriter.writeAttribute("classname", "UwTerminalX");
+    xmlWriter.writeAttribute("name", QFileInfo(mstrScriptFile).fileName());
+    xmlWriter.writeAttribute("time", strTime);
+    if (bFailed == true || bError == true)
+    {
+        xmlWriter.writeStartElement(bFailed == true ? "failure" : "error");
+        xmlWriter.writeAttribute("message", strMessage);
+        xmlWriter.writeCharacters(strMessage);
+        xmlWriter.writeEndElement();
+    }
+    xmlWriter.writeTextElement("system-out", mstrOutput);
+    xmlWriter.writeEndElement();
+    xmlWriter.writeEndElement();
+    xmlWriter.writeEndElement();
+    xmlWriter.writeEndDocument();
+    fileJUnit.close();
+}
+
+//=============================================================================
+//=============================================================================
+QString
+LrdScriptRunner::Printable(
+    const QByteArray &baData
+    )
+{
+    //Returns data with control characters shown as escape sequences (in the same format scripts use)
+    QString strPrintable;
+    int i = 0;
+    while (i < baData.length())
+    {
+        unsigned char ucChar = (unsigned char)baData.at(i);
+        if (ucChar == '\r')
+        {
+            strPrintable.append("\\r");
+        }
+        else if (ucChar == '\n')
+        {
+            strPrintable.append("\\n");
+        }
+        else if (ucChar == '\t')
+        {
+            strPrintable.append("\\t");
+        }
+        else if (ucChar < 0x20 || ucChar >= 0x7F || ucChar == '\\')
+        {
+            strPrintable.append("\\").append(QString::number(ucChar, 16).toUpper().rightJustified(2, '0'));
+        }
+        else
+        {
+            strPrintable.append(QChar(ucChar));
+        }
+        ++i;
+    }
+    return strPrintable;
+}
+
+/******************************************************************************/
+// END OF FILE
+/******************************************************************************/
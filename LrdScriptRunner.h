@@ -0,0 +1,145 @@
+/******************************************************************************
+** Copyright (C) 2016 Laird
+**
+** Project: UwTerminalX
+**
+** Module: LrdScriptRunner.h
+**
+** Notes:
+**
+** License: This program is free software: you can redistribute it and/or
+**          modify it under the terms of the GNU General Public License as
+**          published by the Free Software Foundation, version 3.
+**
+**          This program is distributed in the hope that it will be useful,
+**          but WITHOUT ANY WARRANTY; without even the implied warranty of
+**          MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+**          GNU General Public License for more details.
+**
+**          You should have received a copy of the GNU General Public License
+**          along with this program.  If not, see http://www.gnu.org/licenses/
+**
+*******************************************************************************/
+#ifndef LRDSCRIPTRUNNER_H
+#define LRDSCRIPTRUNNER_H
+
+/******************************************************************************/
+// Include Files
+/******************************************************************************/
+#include <QObject>
+#include <QString>
+#include <QStringList>
+#include <QByteArray>
+#include <QVector>
+#include <QTimer>
+#include <QElapsedTimer>
+#include <QTextStream>
+#include <QSerialPort>
+#include "LrdScriptCompiler.h"
+#include "LrdScriptExecutor.h"
+
+/******************************************************************************/
+// Defines
+/******************************************************************************/
+#define ScriptRunnerExitPass           0     //Exit code when the script ran to completion
+#define ScriptRunnerExitFail           1     //Exit code when the script failed (data not received, variable not set or port error)
+#define ScriptRunnerExitError          2     //Exit code when the arguments are invalid or the script could not be loaded or compiled
+#define ScriptRunnerExitPortError      3     //Exit code when the serial port could not be opened
+#define ScriptRunnerDefaultRecvTime    900   //Default time (in seconds) to wait for data to be received (as the scripting dialogue)
+#define ScriptRunnerDefaultRecvSize    16384 //Default maximum number of bytes to search for received data (as the scripting dialogue)
+
+/******************************************************************************/
+// Class definitions
+/******************************************************************************/
+class LrdScriptRunner : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit LrdScriptRunner(
+        QObject *parent = 0
+        );
+    ~LrdScriptRunner(
+        );
+    static bool
+    IsHeadless(
+        int argc,
+        char *argv[]
+        );
+    bool
+    Start(
+        const QStringList &lstArguments
+        );
+    int
+    ExitCode(
+        );
+
+private slots:
+    void
+    RunScript(
+        );
+    void
+    ScriptSendData(
+        const QByteArray &baData
+        );
+    void
+    ScriptDataMatched(
+        const QByteArray &baData
+        );
+    void
+    ScriptFinished(
+        bool bPassed,
+        const QString &strMessage
+        );
+    void
+    SerialRead(
+        );
+    void
+    SerialError(
+        QSerialPort::SerialPortError speErrorCode
+        );
+
+private:
+    bool
+    ParseArguments(
+        const QStringList &lstArguments
+        );
+    void
+    Log(
+        const QString &strMessage
+        );
+    void
+    Finish(
+        int intExitCode,
+        const QString &strMessage
+        );
+    void
+    WriteJUnit(
+        const QString &strMessage
+        );
+    static QString
+    Printable(
+        const QByteArray &baData
+        );
+
+    QSerialPort mspSerialPort; //Serial port the script is run against
+    QString mstrScriptFile; //Filename of the script
+    QString mstrJUnitFile; //Filename to write JUnit XML results to (empty for none)
+    bool mbQuiet; //True if only the result is output (not each send/receive)
+    int mintRecvTime; //Time (in seconds) to wait for data to be received before failing
+    int mintRecvBufSize; //Number of bytes to search for received data before failing
+    QStringList mlstScriptLines; //Source lines of the script (for output)
+    QVector<LrdScriptInstruction> mvecProgram; //Compiled script being executed
+    LrdScriptExecutor mexeScript; //Executes the compiled script (shared with the scripting dialogue)
+    bool mbIsRunning; //True if the script is running
+    QElapsedTimer mtmrScriptTimer; //Times the script from when it was started
+    int mintExitCode; //Exit code for the application
+    QTextStream mtsOutput; //Standard output
+    QString mstrOutput; //Output of the script (for the JUnit XML file)
+};
+
+#endif // LRDSCRIPTRUNNER_H
+
+/******************************************************************************/
+// END OF FILE
+/******************************************************************************/
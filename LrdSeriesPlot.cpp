@@ -0,0 +1,222 @@
+/******************************************************************************
+** Copyright (C) 2016 Laird
+**
+** Project: UwTerminalX
+**
+** Module: LrdSeriesPlot.cpp
+**
+** Notes:
+**
+** License: This program is free software: you can redistribute it and/or
+**          modify it under the terms of the GNU General Public License as
+**          published by the Free Software Foundation, version 3.
+**
+**          This program is distributed in the hope that it will be useful,
+**          but WITHOUT ANY WARRANTY; without even the implied warranty of
+**          MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+**          GNU General Public License for more details.
+**
+**          You should have received a copy of the GNU General Public License
+**          along with this program.  If not, see http://www.gnu.org/licenses/
+**
+*******************************************************************************/
+
+/******************************************************************************/
+// Include Files
+/******************************************************************************/
+#include "LrdSeriesPlot.h"
+
+/******************************************************************************/
+// Local Functions or Private Members
+/******************************************************************************/
+LrdSeriesPlot::LrdSeriesPlot(QWidget *parent) : QWidget(parent)
+{
+    //Initial values
+    mpSeries = 0;
+    mintMarkerChannel = -1;
+    setAttribute(Qt::WA_OpaquePaintEvent);
+}
+
+//=============================================================================
+//=============================================================================
+void
+LrdSeriesPlot::SetSeries(
+    const LrdTimeSeries *pSeries
+    )
+{
+    //Sets the series to plot
+    mpSeries = pSeries;
+    update();
+}
+
+//=============================================================================
+//=============================================================================
+void
+LrdSeriesPlot::AddTrace(
+    int intChannel,
+    QColor colTrace
+    )
+{
+    //Adds a channel to draw as a line
+    mlstTraceChannels.append(intChannel);
+    mlstTraceColours.append(colTrace);
+}
+
+//=============================================================================
+//=============================================================================
+void
+LrdSeriesPlot::SetMarkerChannel(
+    int intChannel
+    )
+{
+    //Sets the channel that causes a marker to be drawn for a sample when it is non-zero
+    mintMarkerChannel = intChannel;
+}
+
+//=============================================================================
+//=============================================================================
+void
+LrdSeriesPlot::paintEvent(
+    QPaintEvent *
+    )
+{
+    //Redraw the plot
+    QPainter pntPlot(this);
+    pntPlot.fillRect(rect(), Qt::black);
+
+    QRect rectPlot = rect().adjusted(SeriesPlotMargin, SeriesPlotMargin + fontMetrics().height(), -SeriesPlotMargin, -SeriesPlotMargin);
+    if (mpSeries == 0 || mpSeries->Count() < 2 || rectPlot.width() < 2 || rectPlot.height() < 2)
+    {
+        //Nothing to draw
+        return;
+    }
+
+    //All traces share the same scale so they can be compared against each other
+    quint32 intMax = 1;
+    int i = 0;
+    while (i < mlstTraceChannels.count())
+    {
+        quint32 intChannelMax = mpSeries->MaxValue(mlstTraceChannels.at(i));
+        if (intChannelMax > intMax)
+        {
+            intMax = intChannelMax;
+        }
+        ++i;
+    }
+
+    //Grid lines at each quarter of the scale
+    pntPlot.setPen(QColor(48, 48, 48));
+    i = 1;
+    while (i < 4)
+    {
+        int intY = rectPlot.bottom() - rectPlot.height()*i/4;
+        pntPlot.drawLine(rectPlot.left(), intY, rectPlot.right(), intY);
+        ++i;
+    }
+
+    if (mintMarkerChannel != -1)
+    {
+        //Mark samples which have a non-zero marker value (e.g. errors) along the bottom of the plot
+        pntPlot.setPen(Qt::red);
+        int intCount = mpSeries->Count();
+        i = 0;
+        while (i < intCount)
+        {
+            if (mpSeries->Value(i, mintMarkerChannel) != 0)
+            {
+                int intX = rectPlot.left() + (int)((qint64)i*(rectPlot.width()-1)/(intCount-1));
+                pntPlot.drawLine(intX, rectPlot.bottom(), intX, rectPlot.bottom() - SeriesPlotMargin*2);
+            }
+            ++i;
+        }
+    }
+
+    i = 0;
+    while (i < mlstTraceChannels.count())
+    {
+        //Draw each trace
+        pntPlot.setPen(mlstTraceColours.at(i));
+        DrawTrace(&pntPlot, rectPlot, mlstTraceChannels.at(i), intMax);
+        ++i;
+    }
+
+    //Scale and time span labels
+    pntPlot.setPen(Qt::lightGray);
+    pntPlot.drawText(SeriesPlotMargin, SeriesPlotMargin + fontMetrics().ascent(), QString("Max: ").append(QString::number(intMax)));
+    QString strSpan = QString::number((double)(mpSeries->Time(mpSeries->Count()-1) - mpSeries->Time(0))/1000.0, 'f', 1).append("s");
+    pntPlot.drawText(rect().right() - SeriesPlotMargin - fontMetrics().width(strSpan), SeriesPlotMargin + fontMetrics().ascent(), strSpan);
+}
+
+//=============================================================================
+//=============================================================================
+void
+LrdSeriesPlot::DrawTrace(
+    QPainter *pPainter,
+    const QRect &rectPlot,
+    int intChannel,
+    quint32 intMax
+    )
+{
+    //Draws a single channel. When there are more samples than pixel columns, each column is drawn as a line between the lowest and highest value of the samples it covers so that peaks are never lost
+    int intCount = mpSeries->Count();
+    int intWidth = rectPlot.width();
+    int intHeight = rectPlot.height() - 1;
+
+    if (intCount <= intWidth)
+    {
+        //Draw every sample
+        QVector<QPoint> vecPoints;
+        vecPoints.reserve(intCount);
+        int i = 0;
+        while (i < intCount)
+        {
+            vecPoints.append(QPoint(rectPlot.left() + (int)((qint64)i*(intWidth-1)/(intCount-1)), rectPlot.bottom() - (int)((quint64)mpSeries->Value(i, intChannel)*intHeight/intMax)));
+            ++i;
+        }
+        pPainter->drawPolyline(vecPoints.constData(), vecPoints.count());
+        return;
+    }
+
+    //Min/max decimation, one vertical line per pixel column plus a line joining it to the previous column
+    QVector<QLine> vecLines;
+    vecLines.reserve(intWidth*2);
+    int intPrevY = -1;
+    int intX = 0;
+    while (intX < intWidth)
+    {
+        int intStart = (int)((qint64)intX*intCount/intWidth);
+        int intEnd = (int)((qint64)(intX+1)*intCount/intWidth);
+        quint32 intLow = mpSeries->Value(intStart, intChannel);
+        quint32 intHigh = intLow;
+        int i = intStart + 1;
+        while (i < intEnd)
+        {
+            quint32 intValue = mpSeries->Value(i, intChannel);
+            if (intValue < intLow)
+            {
+                intLow = intValue;
+            }
+            else if (intValue > intHigh)
+            {
+                intHigh = intValue;
+            }
+            ++i;
+        }
+
+        int intYLow = rectPlot.bottom() - (int)((quint64)intLow*intHeight/intMax);
+        int intYHigh = rectPlot.bottom() - (int)((quint64)intHigh*intHeight/intMax);
+        int intYLast = rectPlot.bottom() - (int)((quint64)mpSeries->Value(intEnd-1, intChannel)*intHeight/intMax);
+        if (intPrevY != -1)
+        {
+            vecLines.append(QLine(rectPlot.left() + intX - 1, intPrevY, rectPlot.left() + intX, rectPlot.bottom() - (int)((quint64)mpSeries->Value(intStart, intChannel)*intHeight/intMax)));
+        }
+        vecLines.append(QLine(rectPlot.left() + intX, intYLow, rectPlot.left() + intX, intYHigh));
+        intPrevY = intYLast;
+        ++intX;
+    }
+    pPainter->drawLines(vecLines);
+}
+
+/******************************************************************************/
+// END OF FILE
+/******************************************************************************/
@@ -0,0 +1,94 @@
+/******************************************************************************
+** Copyright (C) 2016 Laird
+**
+** Project: UwTerminalX
+**
+** Module: LrdSeriesPlot.h
+**
+** Notes:
+**
+** License: This program is free software: you can redistribute it and/or
+**          modify it under the terms of the GNU General Public License as
+**          published by the Free Software Foundation, version 3.
+**
+**          This program is distributed in the hope that it will be useful,
+**          but WITHOUT ANY WARRANTY; without even the implied warranty of
+**          MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+**          GNU General Public License for more details.
+**
+**          You should have received a copy of the GNU General Public License
+**          along with this program.  If not, see http://www.gnu.org/licenses/
+**
+*******************************************************************************/
+#ifndef LRDSERIESPLOT_H
+#define LRDSERIESPLOT_H
+
+/******************************************************************************/
+// Include Files
+/******************************************************************************/
+#include <QWidget>
+#include <QPainter>
+#include <QPaintEvent>
+#include <QColor>
+#include <QList>
+#include <QVector>
+#include <QLine>
+#include <QPoint>
+#include "LrdTimeSeries.h"
+
+/******************************************************************************/
+// Defines
+/******************************************************************************/
+#define SeriesPlotMargin                  4       //Margin (in pixels) around the plot area
+
+/******************************************************************************/
+// Class definitions
+/******************************************************************************/
+class LrdSeriesPlot : public QWidget
+{
+    Q_OBJECT
+public:
+    explicit
+    LrdSeriesPlot(
+        QWidget *parent = 0
+        );
+    void
+    SetSeries(
+        const LrdTimeSeries *pSeries
+        );
+    void
+    AddTrace(
+        int intChannel,
+        QColor colTrace
+        );
+    void
+    SetMarkerChannel(
+        int intChannel
+        );
+
+protected:
+    void
+    paintEvent(
+        QPaintEvent *peEvent
+        );
+
+private:
+    void
+    DrawTrace(
+        QPainter *pPainter,
+        const QRect &rectPlot,
+        int intChannel,
+        quint32 intMax
+        );
+
+    const LrdTimeSeries *mpSeries; //Series that is plotted
+    QList<int> mlstTraceChannels; //Channels which are drawn as traces
+    QList<QColor> mlstTraceColours; //Colour of each trace
+    int mintMarkerChannel; //Channel which marks a sample when non-zero (-1 for none)
+};
+
+#endif // LRDSERIESPLOT_H
+
+/******************************************************************************/
+// END OF FILE
+/******************************************************************************/
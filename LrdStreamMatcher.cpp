@@ -0,0 +1,139 @@
+/******************************************************************************
+** Copyright (C) 2016 Laird
+**
+** Project: UwTerminalX
+**
+** Module: LrdStreamMatcher.cpp
+**
+** Notes:
+**
+** License: This program is free software: you can redistribute it and/or
+**          modify it under the terms of the GNU General Public License as
+**          published by the Free Software Foundation, version 3.
+**
+**          This program is distributed in the hope that it will be useful,
+**          but WITHOUT ANY WARRANTY; without even the implied warranty of
+**          MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+**          GNU General Public License for more details.
+**
+**          You should have received a copy of the GNU General Public License
+**          along with this program.  If not, see http://www.gnu.org/licenses/
+**
+*******************************************************************************/
+
+/******************************************************************************/
+// Include Files
+/******************************************************************************/
+#include "LrdStreamMatcher.h"
+
+/******************************************************************************/
+// Local Functions or Private Members
+/******************************************************************************/
+LrdStreamMatcher::LrdStreamMatcher(
+    )
+{
+    //Nothing to match
+    mintState = 0;
+}
+
+//=============================================================================
+//=============================================================================
+void
+LrdStreamMatcher::SetPattern(
+    const QByteArray &baPattern
+    )
+{
+    //Sets the data to search for and builds the failure table
+    mbaPattern = baPattern;
+    mvecFailure.resize(mbaPattern.length());
+    const char *pchPattern = mbaPattern.constData();
+    int intPrefix = 0;
+    int i = 1;
+    if (mbaPattern.length() > 0)
+    {
+        mvecFailure[0] = 0;
+    }
+    while (i < mbaPattern.length())
+    {
+        while (intPrefix > 0 && pchPattern[i] != pchPattern[intPrefix])
+        {
+            intPrefix = mvecFailure[intPrefix - 1];
+        }
+        if (pchPattern[i] == pchPattern[intPrefix])
+        {
+            ++intPrefix;
+        }
+        mvecFailure[i] = intPrefix;
+        ++i;
+    }
+    mintState = 0;
+}
+
+//=============================================================================
+//=============================================================================
+void
+LrdStreamMatcher::Reset(
+    )
+{
+    //Forgets any partial match, the pattern is kept
+    mintState = 0;
+}
+
+//=============================================================================
+//=============================================================================
+int
+LrdStreamMatcher::Feed(
+    const char *pchData,
+    int intLength
+    )
+{
+    //Searches the next part of the stream. A partial match at the end of the data carries over to the next call. Returns the number of bytes of this data up to and including the end of the match, or -1 if the pattern has not been found yet
+    if (mbaPattern.isEmpty())
+    {
+        //Empty pattern always matches
+        return 0;
+    }
+
+    const char *pchPattern = mbaPattern.constData();
+    const int *pintFailure = mvecFailure.constData();
+    int intPatternLength = mbaPattern.length();
+    int intState = mintState;
+    int i = 0;
+    while (i < intLength)
+    {
+        while (intState > 0 && pchData[i] != pchPattern[intState])
+        {
+            //Fall back to the longest prefix that still matches
+            intState = pintFailure[intState - 1];
+        }
+        if (pchData[i] == pchPattern[intState])
+        {
+            ++intState;
+            if (intState == intPatternLength)
+            {
+                //Match found, start afresh for the next search
+                mintState = 0;
+                return i + 1;
+            }
+        }
+        ++i;
+    }
+
+    //Pattern not found, remember how much of it was matched
+    mintState = intState;
+    return -1;
+}
+
+//=============================================================================
+//=============================================================================
+int
+LrdStreamMatcher::PatternLength(
+    ) const
+{
+    //Returns the length of the pattern
+    return mbaPattern.length();
+}
+
+/******************************************************************************/
+// END OF FILE
+/******************************************************************************/
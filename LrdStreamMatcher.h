@@ -0,0 +1,66 @@
+/******************************************************************************
+** Copyright (C) 2016 Laird
+**
+** Project: UwTerminalX
+**
+** Module: LrdStreamMatcher.h
+**
+** Notes:
+**
+** License: This program is free software: you can redistribute it and/or
+**          modify it under the terms of the GNU General Public License as
+**          published by the Free Software Foundation, version 3.
+**
+**          This program is distributed in the hope that it will be useful,
+**          but WITHOUT ANY WARRANTY; without even the implied warranty of
+**          MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+**          GNU General Public License for more details.
+**
+**          You should have received a copy of the GNU General Public License
+**          along with this program.  If not, see http://www.gnu.org/licenses/
+**
+*******************************************************************************/
+#ifndef LRDSTREAMMATCHER_H
+#define LRDSTREAMMATCHER_H
+
+/******************************************************************************/
+// Include Files
+/******************************************************************************/
+#include <QByteArray>
+#include <QVector>
+
+/******************************************************************************/
+// Class definitions
+/******************************************************************************/
+class LrdStreamMatcher
+{
+public:
+    LrdStreamMatcher(
+        );
+    void
+    SetPattern(
+        const QByteArray &baPattern
+        );
+    void
+    Reset(
+        );
+    int
+    Feed(
+        const char *pchData,
+        int intLength
+        );
+    int
+    PatternLength(
+        ) const;
+
+private:
+    QByteArray mbaPattern; //Data being searched for
+    QVector<int> mvecFailure; //Knuth-Morris-Pratt failure table: length of the longest proper prefix of the pattern that is also a suffix of pattern[0..i]
+    int mintState; //Number of pattern bytes matched at the end of the data fed so far
+};
+
+#endif // LRDSTREAMMATCHER_H
+
+/******************************************************************************/
+// END OF FILE
+/******************************************************************************/
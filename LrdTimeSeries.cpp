@@ -0,0 +1,256 @@
+/******************************************************************************
+** Copyright (C) 2016 Laird
+**
+** Project: UwTerminalX
+**
+** Module: LrdTimeSeries.cpp
+**
+** Notes:
+**
+** License: This program is free software: you can redistribute it and/or
+**          modify it under the terms of the GNU General Public License as
+**          published by the Free Software Foundation, version 3.
+**
+**          This program is distributed in the hope that it will be useful,
+**          but WITHOUT ANY WARRANTY; without even the implied warranty of
+**          MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+**          GNU General Public License for more details.
+**
+**          You should have received a copy of the GNU General Public License
+**          along with this program.  If not, see http://www.gnu.org/licenses/
+**
+*******************************************************************************/
+
+/******************************************************************************/
+// Include Files
+/******************************************************************************/
+#include "LrdTimeSeries.h"
+
+/******************************************************************************/
+// Local Functions or Private Members
+/******************************************************************************/
+LrdTimeSeries::LrdTimeSeries(
+    )
+{
+    //Initial values
+    mintStride = 1;
+}
+
+//=============================================================================
+//=============================================================================
+void
+LrdTimeSeries::SetChannels(
+    const QStringList &lstNames
+    )
+{
+    //Sets the names of the channels recorded in each sample, this clears any existing samples
+    mlstNames = lstNames;
+    mintStride = lstNames.count() + 1;
+    mvecData.clear();
+}
+
+//=============================================================================
+//=============================================================================
+void
+LrdTimeSeries::Clear(
+    )
+{
+    //Removes all samples but keeps the allocated memory for the next test
+    mvecData.resize(0);
+}
+
+//=============================================================================
+//=============================================================================
+void
+LrdTimeSeries::Append(
+    quint32 intTime,
+    const quint32 *pintValues
+    )
+{
+    //Adds a sample (one value per channel) taken at the provided time (in ms)
+    if (Count() >= TimeSeriesMaxSamples)
+    {
+        //Series is full, discard the oldest half
+        mvecData.remove(0, (TimeSeriesMaxSamples/2)*mintStride);
+    }
+    mvecData.append(intTime);
+    int i = 0;
+    while (i < mintStride-1)
+    {
+        mvecData.append(pintValues[i]);
+        ++i;
+    }
+}
+
+//=============================================================================
+//=============================================================================
+int
+LrdTimeSeries::Count(
+    ) const
+{
+    //Returns the number of samples
+    return mvecData.count()/mintStride;
+}
+
+//=============================================================================
+//=============================================================================
+int
+LrdTimeSeries::Channels(
+    ) const
+{
+    //Returns the number of channels in each sample
+    return mintStride-1;
+}
+
+//=============================================================================
+//=============================================================================
+QString
+LrdTimeSeries::ChannelName(
+    int intChannel
+    ) const
+{
+    //Returns the name of a channel
+    return mlstNames.at(intChannel);
+}
+
+//=============================================================================
+//=============================================================================
+quint32
+LrdTimeSeries::Time(
+    int intSample
+    ) const
+{
+    //Returns the time (in ms) a sample was taken at
+    return mvecData.at(intSample*mintStride);
+}
+
+//=============================================================================
+//=============================================================================
+quint32
+LrdTimeSeries::Value(
+    int intSample,
+    int intChannel
+    ) const
+{
+    //Returns the value of a channel in a sample
+    return mvecData.at(intSample*mintStride + intChannel + 1);
+}
+
+//=============================================================================
+//=============================================================================
+quint32
+LrdTimeSeries::MaxValue(
+    int intChannel
+    ) const
+{
+    //Returns the highest value of a channel over all samples
+    quint32 intMax = 0;
+    int i = intChannel + 1;
+    while (i < mvecData.count())
+    {
+        if (mvecData.at(i) > intMax)
+        {
+            intMax = mvecData.at(i);
+        }
+        i += mintStride;
+    }
+    return intMax;
+}
+
+//=============================================================================
+//=============================================================================
+bool
+LrdTimeSeries::ExportCSV(
+    const QString &strFilename
+    ) const
+{
+    //Writes all samples to a CSV file with a header row
+    QFile fileOutput(strFilename);
+    if (!fileOutput.open(QIODevice::WriteOnly | QIODevice::Truncate | QIODevice::Text))
+    {
+        //Unable to open file
+        return false;
+    }
+
+    QTextStream tsOutput(&fileOutput);
+    tsOutput << "time_ms";
+    int i = 0;
+    while (i < mlstNames.count())
+    {
+        tsOutput << "," << mlstNames.at(i);
+        ++i;
+    }
+    tsOutput << "\n";
+
+    i = 0;
+    while (i < mvecData.count())
+    {
+        //Output one sample per row
+        tsOutput << mvecData.at(i);
+        int j = 1;
+        while (j < mintStride)
+        {
+            tsOutput << "," << mvecData.at(i+j);
+            ++j;
+        }
+        tsOutput << "\n";
+        i += mintStride;
+    }
+    tsOutput.flush();
+    fileOutput.close();
+    return true;
+}
+
+//=============================================================================
+//=============================================================================
+bool
+LrdTimeSeries::ExportJSON(
+    const QString &strFilename,
+    const QJsonObject &objInfo
+    ) const
+{
+    //Writes all samples to a JSON file, each channel is stored as an array alongside the provided test information
+    QFile fileOutput(strFilename);
+    if (!fileOutput.open(QIODevice::WriteOnly | QIODevice::Truncate))
+    {
+        //Unable to open file
+        return false;
+    }
+
+    QJsonObject objRoot;
+    QJsonObject objSeries;
+    QJsonArray arrValues;
+    int i = 0;
+    while (i < mvecData.count())
+    {
+        arrValues.append((qint64)mvecData.at(i));
+        i += mintStride;
+    }
+    objSeries.insert("time_ms", arrValues);
+
+    int j = 0;
+    while (j < mlstNames.count())
+    {
+        //Add channel values
+        arrValues = QJsonArray();
+        i = j + 1;
+        while (i < mvecData.count())
+        {
+            arrValues.append((qint64)mvecData.at(i));
+            i += mintStride;
+        }
+        objSeries.insert(mlstNames.at(j), arrValues);
+        ++j;
+    }
+
+    objRoot.insert("info", objInfo);
+    objRoot.insert("samples", Count());
+    objRoot.insert("series", objSeries);
+    fileOutput.write(QJsonDocument(objRoot).toJson());
+    fileOutput.close();
+    return true;
+}
+
+/******************************************************************************/
+// END OF FILE
+/******************************************************************************/
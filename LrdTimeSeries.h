@@ -0,0 +1,107 @@
+/******************************************************************************
+** Copyright (C) 2016 Laird
+**
+** Project: UwTerminalX
+**
+** Module: LrdTimeSeries.h
+**
+** Notes:
+**
+** License: This program is free software: you can redistribute it and/or
+**          modify it under the terms of the GNU General Public License as
+**          published by the Free Software Foundation, version 3.
+**
+**          This program is distributed in the hope that it will be useful,
+**          but WITHOUT ANY WARRANTY; without even the implied warranty of
+**          MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+**          GNU General Public License for more details.
+**
+**          You should have received a copy of the GNU General Public License
+**          along with this program.  If not, see http://www.gnu.org/licenses/
+**
+*******************************************************************************/
+#ifndef LRDTIMESERIES_H
+#define LRDTIMESERIES_H
+
+/******************************************************************************/
+// Include Files
+/******************************************************************************/
+#include <QtGlobal>
+#include <QVector>
+#include <QString>
+#include <QStringList>
+#include <QFile>
+#include <QTextStream>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QJsonArray>
+
+/******************************************************************************/
+// Defines
+/******************************************************************************/
+#define TimeSeriesMaxSamples              172800  //Maximum number of samples kept (24 hours at 2 samples per second), oldest half is discarded when reached
+
+/******************************************************************************/
+// Class definitions
+/******************************************************************************/
+class LrdTimeSeries
+{
+public:
+    LrdTimeSeries(
+        );
+    void
+    SetChannels(
+        const QStringList &lstNames
+        );
+    void
+    Clear(
+        );
+    void
+    Append(
+        quint32 intTime,
+        const quint32 *pintValues
+        );
+    int
+    Count(
+        ) const;
+    int
+    Channels(
+        ) const;
+    QString
+    ChannelName(
+        int intChannel
+        ) const;
+    quint32
+    Time(
+        int intSample
+        ) const;
+    quint32
+    Value(
+        int intSample,
+        int intChannel
+        ) const;
+    quint32
+    MaxValue(
+        int intChannel
+        ) const;
+    bool
+    ExportCSV(
+        const QString &strFilename
+        ) const;
+    bool
+    ExportJSON(
+        const QString &strFilename,
+        const QJsonObject &objInfo
+        ) const;
+
+private:
+    QStringList mlstNames; //Name of each channel
+    int mintStride; //Number of values stored per sample (time + channels)
+    QVector<quint32> mvecData; //Samples stored back to back as [time, channel 0, channel 1, ...]
+};
+
+#endif // LRDTIMESERIES_H
+
+/******************************************************************************/
+// END OF FILE
+/******************************************************************************/
@@ -21,14 +21,30 @@ SOURCES += main.cpp\
     UwxMainWindow.cpp \
     UwxPopup.cpp \
     LrdLogger.cpp \
-    UwxEscape.cpp
+    UwxEscape.cpp \
+    LrdLogIndex.cpp \
+    LrdHistogram.cpp \
+    LrdCrc32.cpp \
+    LrdPrbs.cpp \
+    LrdDataVerifier.cpp \
+    LrdTimeSeries.cpp \
+    LrdSeriesPlot.cpp \
+    LrdScriptRecorder.cpp
 
 HEADERS  += \
     LrdScrollEdit.h \
     UwxMainWindow.h \
     UwxPopup.h \
     LrdLogger.h \
-    UwxEscape.h
+    UwxEscape.h \
+    LrdLogIndex.h \
+    LrdHistogram.h \
+    LrdCrc32.h \
+    LrdPrbs.h \
+    LrdDataVerifier.h \
+    LrdTimeSeries.h \
+    LrdSeriesPlot.h \
+    LrdScriptRecorder.h
 
 FORMS    += \
     UwxPopup.ui \
@@ -48,13 +64,29 @@ RESOURCES += \
 #Scripting form
 !contains(DEFINES, SKIPSCRIPTINGFORM)
 {
+    QT += qml
+
     SOURCES += LrdCodeEditor.cpp \
     LrdHighlighter.cpp \
-    UwxScripting.cpp
+    UwxScripting.cpp \
+    LrdScriptCompiler.cpp \
+    LrdStreamMatcher.cpp \
+    LrdMultiMatcher.cpp \
+    LrdChunkBuffer.cpp \
+    LrdScriptExecutor.cpp \
+    LrdScriptRunner.cpp \
+    LrdJsScriptEngine.cpp
 
     HEADERS += LrdCodeEditor.h \
     LrdHighlighter.h \
-    UwxScripting.h
+    UwxScripting.h \
+    LrdScriptCompiler.h \
+    LrdStreamMatcher.h \
+    LrdMultiMatcher.h \
+    LrdChunkBuffer.h \
+    LrdScriptExecutor.h \
+    LrdScriptRunner.h \
+    LrdJsScriptEngine.h
 
     FORMS += UwxScripting.ui
 }
@@ -29,9 +29,6 @@
 /******************************************************************************/
 // Local Functions or Private Members
 /******************************************************************************/
-//Set pattern to match
-QRegularExpression UwxEscape::reESeq = QRegularExpression("[\\\\]([0-9A-Fa-f]{2})");
-
 //=============================================================================
 //=============================================================================
 void
@@ -39,17 +36,100 @@ UwxEscape::EscapeCharacters(
     QString *strData
     )
 {
-    //Escapes character sequences
-    QRegularExpressionMatchIterator remiESeqMatch = UwxEscape::reESeq.globalMatch(strData);
-    while (remiESeqMatch.hasNext())
+    //Escapes character sequences in one pass so that escaped output is never escaped again
+    QString strOutput;
+    strOutput.reserve(strData->length());
+    int i = 0;
+    while (i < strData->length())
+    {
+        QChar chThis = strData->at(i);
+        if (chThis == '\\' && i + 1 < strData->length())
+        {
+            QChar chNext = strData->at(i + 1);
+            int intHigh = (chNext.unicode() < 0x80 ? HexValue((char)chNext.unicode()) : -1);
+            int intLow = (i + 2 < strData->length() && strData->at(i + 2).unicode() < 0x80 ? HexValue((char)strData->at(i + 2).unicode()) : -1);
+            if (intHigh != -1 && intLow != -1)
+            {
+                //Character code
+                strOutput.append(QChar((intHigh << 4) | intLow));
+                i += 3;
+                continue;
+            }
+            else if (chNext == 'r' || chNext == 'n' || chNext == 't')
+            {
+                //Newline or tab character
+                strOutput.append(chNext == 'r' ? '\r' : (chNext == 'n' ? '\n' : '\t'));
+                i += 2;
+                continue;
+            }
+        }
+        strOutput.append(chThis);
+        ++i;
+    }
+    *strData = strOutput;
+}
+
+//=============================================================================
+//=============================================================================
+void
+UwxEscape::EscapeCharacters(
+    QByteArray *baData
+    )
+{
+    //Escapes character sequences in data which has already been encoded, each \HH becomes the single byte HH. Done in one pass so that escaped output is never escaped again
+    QByteArray baOutput;
+    baOutput.reserve(baData->length());
+    int i = 0;
+    while (i < baData->length())
     {
-        //We have escape sequences
-        QRegularExpressionMatch remThisESeqMatch = remiESeqMatch.next();
-        strData->replace(QString("\\").append(remThisESeqMatch.captured(1)), QString((char)remThisESeqMatch.captured(1).toInt(NULL, 16)));
+        char chThis = baData->at(i);
+        if (chThis == '\\' && i + 1 < baData->length())
+        {
+            char chNext = baData->at(i + 1);
+            int intHigh = HexValue(chNext);
+            int intLow = (i + 2 < baData->length() ? HexValue(baData->at(i + 2)) : -1);
+            if (intHigh != -1 && intLow != -1)
+            {
+                //Character code
+                baOutput.append((char)((intHigh << 4) | intLow));
+                i += 3;
+                continue;
+            }
+            else if (chNext == 'r' || chNext == 'n' || chNext == 't')
+            {
+                //Newline or tab character
+                baOutput.append(chNext == 'r' ? '\r' : (chNext == 'n' ? '\n' : '\t'));
+                i += 2;
+                continue;
+            }
+        }
+        baOutput.append(chThis);
+        ++i;
     }
+    *baData = baOutput;
+}
 
-    //Replace newline and tab characters
-    strData->replace("\\r", "\r").replace("\\n", "\n").replace("\\t", "\t");
+//=============================================================================
+//=============================================================================
+int
+UwxEscape::HexValue(
+    char chDigit
+    )
+{
+    //Returns the value of a hexadecimal digit, or -1 if it is not one
+    if (chDigit >= '0' && chDigit <= '9')
+    {
+        return chDigit - '0';
+    }
+    else if (chDigit >= 'A' && chDigit <= 'F')
+    {
+        return chDigit - 'A' + 10;
+    }
+    else if (chDigit >= 'a' && chDigit <= 'f')
+    {
+        return chDigit - 'a' + 10;
+    }
+    return -1;
 }
 
 /******************************************************************************/
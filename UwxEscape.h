@@ -27,6 +27,7 @@
 // Include Files
 /******************************************************************************/
 #include <QString>
+#include <QByteArray>
 #include <QRegularExpression>
 
 /******************************************************************************/
@@ -40,9 +41,18 @@ public:
     EscapeCharacters(
         QString *strData
         );
+    static
+    void
+    EscapeCharacters(
+        QByteArray *baData
+        );
 
 private:
-    static QRegularExpression reESeq; //Regular expression used for escaping character codes
+    static
+    int
+    HexValue(
+        char chDigit
+        );
 };
 
 #endif // UWXESCAPE_H
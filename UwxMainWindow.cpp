@@ -138,6 +138,12 @@ MainWindow::MainWindow(QWidget *parent) : QMainWindow(parent), ui(new Ui::MainWi
     gnmManager = 0;
     gtmrSpeedTestDelayTimer = 0;
     gbSpeedTestRunning = false;
+    gintSpeedLatencySentTime = -1;
+    gintSpeedRateLimit = 0;
+    gbSpeedSweepRunning = false;
+    gbSpeedMatrixRunning = false;
+    gbSpeedMatrixExit = false;
+    gintSpeedDisplayDropped = 0;
 
 #ifndef SKIPAUTOMATIONFORM
     guaAutomationForm = 0;
@@ -235,6 +241,25 @@ MainWindow::MainWindow(QWidget *parent) : QMainWindow(parent), ui(new Ui::MainWi
     gtmrSpeedTestStats10s.setInterval(10000);
     gtmrSpeedTestStats10s.setSingleShot(false);
     connect(&gtmrSpeedTestStats10s, SIGNAL(timeout()), this, SLOT(OutputSpeedTestStats()));
+    gtmrSpeedRateTimer.setInterval(SpeedTestRateInterval);
+    gtmrSpeedRateTimer.setTimerType(Qt::PreciseTimer);
+    gtmrSpeedRateTimer.setSingleShot(false);
+    connect(&gtmrSpeedRateTimer, SIGNAL(timeout()), this, SLOT(SpeedTestRateTimer()));
+    gtmrSpeedSweepTimer.setSingleShot(true);
+    connect(&gtmrSpeedSweepTimer, SIGNAL(timeout()), this, SLOT(SpeedTestSweepTimer()));
+    gtmrSpeedMatrixTimer.setSingleShot(true);
+    connect(&gtmrSpeedMatrixTimer, SIGNAL(timeout()), this, SLOT(SpeedMatrixTimer()));
+    ui->groupBox_SpeedLatency->hide();
+    ui->groupBox_SpeedPacketErrors->hide();
+    ui->groupBox_SpeedPrbs->hide();
+
+    //Setup speed test time series and graph
+    gtsSpeedSeries.SetChannels(QStringList() << "rx_bytes_per_s" << "tx_bytes_per_s" << "rx_packets" << "errors" << "buffer_bytes");
+    ui->plot_Speed->SetSeries(&gtsSpeedSeries);
+    ui->plot_Speed->AddTrace(SpeedSeriesRxBytes, Qt::green);
+    ui->plot_Speed->AddTrace(SpeedSeriesTxBytes, QColor(64, 128, 255));
+    ui->plot_Speed->SetMarkerChannel(SpeedSeriesErrors);
+    ui->plot_Speed->hide();
 
     //Display version
     ui->statusBar->showMessage(QString("UwTerminalX")
@@ -341,6 +366,7 @@ MainWindow::MainWindow(QWidget *parent) : QMainWindow(parent), ui(new Ui::MainWi
     gpMenu->addAction("Automation")->setData(MenuActionAutomation);
     gpMenu->addAction("Scripting")->setData(MenuActionScripting);
     gpMenu->addAction("Batch")->setData(MenuActionBatch);
+    gpMenu->addAction("Start Script Recording")->setData(MenuActionRecordScript);
     gpMenu->addAction("Clear module")->setData(MenuActionClearModule);
     gpMenu->addAction("Clear Display")->setData(MenuActionClearDisplay);
     gpMenu->addAction("Clear RX/TX count")->setData(MenuActionClearRxTx);
@@ -363,6 +389,9 @@ MainWindow::MainWindow(QWidget *parent) : QMainWindow(parent), ui(new Ui::MainWi
     gpSpeedMenu->addAction("Send && receive test (delay 5 seconds)")->setData(SpeedMenuActionSendRecv5Delay);
     gpSpeedMenu->addAction("Send && receive test (delay 10 seconds)")->setData(SpeedMenuActionSendRecv10Delay);
     gpSpeedMenu->addAction("Send && receive test (delay 15 seconds)")->setData(SpeedMenuActionSendRecv15Delay);
+    gpSpeedMenu->addAction("Send && receive rate sweep (find highest loss-free rate)")->setData(SpeedMenuActionSendRecvSweep);
+    gpSpeedMenu->addSeparator();
+    gpSpeedMenu->addAction("Baud rate matrix test...")->setData(SpeedMenuActionMatrix);
 
     //Disable unimplemented actions
     gpSMenu3->actions()[3]->setEnabled(false); //Multi Data File +
@@ -420,6 +449,19 @@ MainWindow::MainWindow(QWidget *parent) : QMainWindow(parent), ui(new Ui::MainWi
     ui->check_LogEnable->setChecked(gpTermSettings->value("LogEnable", DefaultLogEnable).toBool());
     ui->check_LogAppend->setChecked(gpTermSettings->value("LogMode", DefaultLogMode).toBool());
 
+    //Setup log search index on a low priority background thread
+    qRegisterMetaType<LrdLogIndexHit>("LrdLogIndexHit");
+    qRegisterMetaType< QList<LrdLogIndexHit> >("QList<LrdLogIndexHit>");
+    gpLogIndex = new LrdLogIndex();
+    gpLogIndex->moveToThread(&gthrLogIndexThread);
+    connect(gpLogIndex, SIGNAL(IndexStatus(QString)), this, SLOT(LogIndexStatus(QString)));
+    connect(gpLogIndex, SIGNAL(SearchFinished(QString,QList<LrdLogIndexHit>,qint64)), this, SLOT(LogIndexSearchFinished(QString,QList<LrdLogIndexHit>,qint64)));
+    gthrLogIndexThread.start(QThread::LowPriority);
+    gtmrLogIndexTimer.setInterval(LogIndexUpdateInterval);
+    connect(&gtmrLogIndexTimer, SIGNAL(timeout()), this, SLOT(UpdateLogIndex()));
+    ui->list_LogSearch->hide();
+    ui->check_LogIndex->setChecked(gpTermSettings->value("LogIndexEnable", DefaultLogIndexEnable).toBool());
+
 #ifdef UseSSL
     //Set SSL status
     ui->check_EnableSSL->setChecked(gpTermSettings->value("SSLEnable", DefaultSSLEnable).toBool());
@@ -623,6 +665,10 @@ MainWindow::MainWindow(QWidget *parent) : QMainWindow(parent), ui(new Ui::MainWi
     bool bArgAccept = false;
     bool bArgNoConnect = false;
     bool bStartScript = false;
+    QString strMatrixBauds;
+    QString strMatrixTypes;
+    int intMatrixDuration = SpeedMatrixDefaultDuration;
+    bool bMatrixConfigure = true;
     while (chi < slArgs.length())
     {
         if (slArgs[chi].toUpper() == "ACCEPT")
@@ -793,6 +839,36 @@ MainWindow::MainWindow(QWidget *parent) : QMainWindow(parent), ui(new Ui::MainWi
             //Connect to device at startup
             bArgNoConnect = true;
         }
+        else if (slArgs[chi].left(12).toUpper() == "SPEEDMATRIX=")
+        {
+            //Baud rates (comma separated) to run a baud rate matrix speed test at
+            strMatrixBauds = slArgs[chi].mid(12);
+        }
+        else if (slArgs[chi].left(11).toUpper() == "SPEEDTYPES=")
+        {
+            //Speed test data types (comma separated names or indexes) to run at each baud rate
+            strMatrixTypes = slArgs[chi].mid(11);
+        }
+        else if (slArgs[chi].left(10).toUpper() == "SPEEDTIME=")
+        {
+            //Time (in seconds) to run each baud rate matrix speed test for
+            intMatrixDuration = slArgs[chi].mid(10).toInt();
+        }
+        else if (slArgs[chi].left(9).toUpper() == "SPEEDOUT=")
+        {
+            //Filename to write baud rate matrix speed test results to
+            gstrSpeedMatrixOutput = slArgs[chi].mid(9);
+        }
+        else if (slArgs[chi].toUpper() == "SPEEDNOCFG")
+        {
+            //Do not change the module baud rate with AT+CFG 520 in baud rate matrix speed tests
+            bMatrixConfigure = false;
+        }
+        else if (slArgs[chi].toUpper() == "SPEEDEXIT")
+        {
+            //Exit once the baud rate matrix speed test has finished
+            gbSpeedMatrixExit = true;
+        }
 #ifndef SKIPAUTOMATIONFORM
         else if (slArgs[chi].toUpper() == "AUTOMATION" && bArgAccept == true)
         {
@@ -856,7 +932,7 @@ MainWindow::MainWindow(QWidget *parent) : QMainWindow(parent), ui(new Ui::MainWi
                 gusScriptingForm->SetUwTerminalXVersion(UwVersion);
 
                 //Connect the message passing signal and slot
-                connect(gusScriptingForm, SIGNAL(SendData(QString,bool,bool)), this, SLOT(MessagePass(QString,bool,bool)));
+                connect(gusScriptingForm, SIGNAL(SendData(QByteArray)), this, SLOT(ScriptSendData(QByteArray)));
                 connect(gusScriptingForm, SIGNAL(ScriptStartRequest()), this, SLOT(ScriptStartRequest()));
                 connect(gusScriptingForm, SIGNAL(ScriptFinished()), this, SLOT(ScriptFinished()));
 
@@ -904,6 +980,13 @@ MainWindow::MainWindow(QWidget *parent) : QMainWindow(parent), ui(new Ui::MainWi
         }
     }
 
+    if (bArgAccept == true && bArgCom == true && !strMatrixBauds.isEmpty())
+    {
+        //Run unattended baud rate matrix speed test
+        ui->selector_Tab->setCurrentIndex(TabSpeedTest);
+        SpeedMatrixStart(strMatrixBauds, strMatrixTypes, intMatrixDuration, bMatrixConfigure);
+    }
+
 #if __APPLE__
     //Show a warning to Mac users with the FTDI driver installed
     if ((QFile::exists("/System/Library/Extensions/FTDIUSBSerialDriver.kext") || QFile::exists("/Library/Extensions/FTDIUSBSerialDriver.kext")) && gpTermSettings->value("MacFTDIDriverWarningShown").isNull())
@@ -943,8 +1026,23 @@ MainWindow::~MainWindow(){
     disconnect(this, SLOT(replyFinished(QNetworkReply*)));
     disconnect(this, SLOT(DetectBaudTimeout()));
     disconnect(this, SLOT(MessagePass(QString,bool,bool)));
+#ifndef SKIPSCRIPTINGFORM
+    disconnect(this, SLOT(ScriptSendData(QByteArray)));
+#endif
     disconnect(this, SLOT(UpdateSpeedTestValues()));
     disconnect(this, SLOT(OutputSpeedTestStats()));
+    disconnect(this, SLOT(SpeedTestRateTimer()));
+    disconnect(this, SLOT(SpeedTestSweepTimer()));
+    disconnect(this, SLOT(SpeedMatrixTimer()));
+    disconnect(this, SLOT(UpdateLogIndex()));
+    disconnect(this, SLOT(LogIndexStatus(QString)));
+    disconnect(this, SLOT(LogIndexSearchFinished(QString,QList<LrdLogIndexHit>,qint64)));
+
+    //Stop log index thread
+    gtmrLogIndexTimer.stop();
+    gthrLogIndexThread.quit();
+    gthrLogIndexThread.wait();
+    delete gpLogIndex;
 
     if (gtmrSpeedTestDelayTimer != 0)
     {
@@ -1214,7 +1312,8 @@ MainWindow::on_btn_TermClose_clicked(
             ui->btn_SpeedStop->setEnabled(false);
             ui->btn_SpeedStart->setEnabled(false);
             ui->combo_SpeedDataType->setEnabled(true);
-            if (ui->combo_SpeedDataType->currentIndex() == 1)
+            ui->spin_SpeedRate->setEnabled(true);
+            if (ui->combo_SpeedDataType->currentIndex() == SpeedDataTypeString || ui->combo_SpeedDataType->currentIndex() == SpeedDataTypeLatency || ui->combo_SpeedDataType->currentIndex() == SpeedDataTypePacket)
             {
                 //Enable string options
                 ui->edit_SpeedTestData->setEnabled(true);
@@ -1243,10 +1342,21 @@ MainWindow::on_btn_TermClose_clicked(
                 //Stop 10 second stats update timer
                 gtmrSpeedTestStats10s.stop();
             }
+            if (gtmrSpeedRateTimer.isActive())
+            {
+                //Stop target rate send timer
+                gtmrSpeedRateTimer.stop();
+            }
+            if (gtmrSpeedSweepTimer.isActive())
+            {
+                //Stop rate sweep
+                gtmrSpeedSweepTimer.stop();
+            }
+            gbSpeedSweepRunning = false;
 
             //Clear buffers
             gbaSpeedMatchData.clear();
-            gbaSpeedReceivedData.clear();
+            gdvSpeedVerifier.SetMatchData(QByteArray());
 
             //Show finished message in status bar
             ui->statusBar->showMessage("Speed testing failed due to serial port being closed.");
@@ -1426,6 +1536,11 @@ MainWindow::SerialRead(
     {
         //Speed test is not running
         QByteArray baOrigData = gspSerialPort.readAll();
+        if (gsrScriptRecorder.IsRecording() == true)
+        {
+            //Record the response
+            gsrScriptRecorder.RecordReceived(baOrigData);
+        }
 #ifndef SKIPSCRIPTINGFORM
         if (gusScriptingForm != 0 && gbScriptingRunning == true)
         {
@@ -1450,7 +1565,8 @@ MainWindow::SerialRead(
             //Replace unprintable characters
             baDispData.replace('\0', "\\00").replace("\x01", "\\01").replace("\x02", "\\02").replace("\x03", "\\03").replace("\x04", "\\04").replace("\x05", "\\05").replace("\x06", "\\06").replace("\x07", "\\07").replace("\x08", "\\08").replace("\x0b", "\\0B").replace("\x0c", "\\0C").replace("\x0e", "\\0E").replace("\x0f", "\\0F").replace("\x10", "\\10").replace("\x11", "\\11").replace("\x12", "\\12").replace("\x13", "\\13").replace("\x14", "\\14").replace("\x15", "\\15").replace("\x16", "\\16").replace("\x17", "\\17").replace("\x18", "\\18").replace("\x19", "\\19").replace("\x1a", "\\1a").replace("\x1b", "\\1b").replace("\x1c", "\\1c").replace("\x1d", "\\1d").replace("\x1e", "\\1e").replace("\x1f", "\\1f");
 
-            //Update display buffer
+            //Update display buffer, after any data sent before it was received
+            FlushEchoBuffer();
             gbaDisplayBuffer.append(baDispData);
             if (!gtmrTextUpdateTimer.isActive())
             {
@@ -2271,7 +2387,7 @@ MainWindow::MenuSelected(
             gusScriptingForm->SetUwTerminalXVersion(UwVersion);
 
             //Connect the message passing signal and slot
-            connect(gusScriptingForm, SIGNAL(SendData(QString,bool,bool)), this, SLOT(MessagePass(QString,bool,bool)));
+            connect(gusScriptingForm, SIGNAL(SendData(QByteArray)), this, SLOT(ScriptSendData(QByteArray)));
             connect(gusScriptingForm, SIGNAL(ScriptStartRequest()), this, SLOT(ScriptStartRequest()));
             connect(gusScriptingForm, SIGNAL(ScriptFinished()), this, SLOT(ScriptFinished()));
 
@@ -2285,6 +2401,67 @@ MainWindow::MenuSelected(
         gusScriptingForm->SetEditorFocus();
     }
 #endif
+    else if (intItem == MenuActionRecordScript)
+    {
+        //Start/stop recording the terminal session as a script
+        if (gsrScriptRecorder.IsRecording() == false)
+        {
+            //Start recording
+            gsrScriptRecorder.Start();
+            gbaDisplayBuffer.append("\n[Script Recording Started]\n");
+            gpMenu->actions()[14]->setText("Stop Script Recording");
+        }
+        else
+        {
+            //Stop recording and save the script
+            gsrScriptRecorder.Stop();
+            gpMenu->actions()[14]->setText("Start Script Recording");
+            if (gsrScriptRecorder.SentCount() == 0)
+            {
+                //Nothing to save
+                gbaDisplayBuffer.append("\n[Script Recording Stopped: no data was sent]\n");
+            }
+            else
+            {
+#ifndef SKIPAUTOMATIONFORM
+                if (guaAutomationForm != 0)
+                {
+                    guaAutomationForm->TempAlwaysOnTop(0);
+                }
+#endif
+                QString strFilename = QFileDialog::getSaveFileName(this, tr("Save Recorded Script"), gstrLastFilename[FilenameIndexOthers], tr("Text Files (*.txt);;All Files (*.*)"));
+#ifndef SKIPAUTOMATIONFORM
+                if (guaAutomationForm != 0)
+                {
+                    guaAutomationForm->TempAlwaysOnTop(1);
+                }
+#endif
+
+                if (strFilename.length() > 1)
+                {
+                    //Write the script
+                    QFile fileScript(strFilename);
+                    if (fileScript.open(QIODevice::WriteOnly | QIODevice::Text))
+                    {
+                        fileScript.write(gsrScriptRecorder.GenerateScript(QString("Recorded by UwTerminalX v").append(UwVersion).append(" on ").append(QDateTime::currentDateTime().toString("yyyy-MM-dd hh:mm:ss"))).toUtf8());
+                        fileScript.close();
+                        gbaDisplayBuffer.append(QString("\n[Script Recording Saved: ").append(strFilename).append("]\n").toUtf8());
+                    }
+                    else
+                    {
+                        //Failed to open file
+                        QString strMessage = tr("Error during script recording save: Access to selected file is denied: ").append(strFilename);
+                        gpmErrorForm->show();
+                        gpmErrorForm->SetMessage(&strMessage);
+                    }
+                }
+            }
+        }
+        if (!gtmrTextUpdateTimer.isActive())
+        {
+            gtmrTextUpdateTimer.start();
+        }
+    }
     else if (intItem == MenuActionBatch)
     {
         //Start a Batch file script
@@ -2452,6 +2629,12 @@ MainWindow::EnterPressed(
                 gintQueuedTXBytes += baTmpBA.size();
                 DoLineEnd();
 
+                if (gsrScriptRecorder.IsRecording() == true)
+                {
+                    //Record the data and line ending sent
+                    gsrScriptRecorder.RecordSent(QByteArray(baTmpBA).append(ui->radio_LCR->isChecked() ? "\r" : ui->radio_LLF->isChecked() ? "\n" : ui->radio_LCRLF->isChecked() ? "\r\n" : ui->radio_LLFCR->isChecked() ? "\n\r" : ""));
+                }
+
                 //Add to log
                 gpMainLog->WriteLogData(baTmpBA.append("\n"));
             }
@@ -2751,6 +2934,46 @@ MainWindow::DoLineEnd(
     return;
 }
 
+//=============================================================================
+//=============================================================================
+void
+MainWindow::FlushEchoBuffer(
+    )
+{
+    //Makes the data sent by scripts since the last display update displayable (in the same way as received data) and adds it to the display buffer. This is done in a single pass when the display needs it rather than each time data is sent
+    if (gbaEchoBuffer.isEmpty())
+    {
+        return;
+    }
+
+    bool bShowCRLF = ui->check_ShowCLRF->isChecked();
+    const char *pchHex = "0123456789ABCDEF";
+    const unsigned char *pchData = (const unsigned char *)gbaEchoBuffer.constData();
+    int intLength = gbaEchoBuffer.length();
+    gbaDisplayBuffer.reserve(gbaDisplayBuffer.length() + intLength);
+    int i = 0;
+    while (i < intLength)
+    {
+        unsigned char chThis = pchData[i];
+        if (bShowCRLF == true && (chThis == '\t' || chThis == '\r' || chThis == '\n'))
+        {
+            //Escape \t, \r and \n
+            gbaDisplayBuffer.append('\\').append(chThis == '\t' ? 't' : (chThis == '\r' ? 'r' : 'n'));
+        }
+        else if (chThis < 0x20 && chThis != '\t' && chThis != '\r' && chThis != '\n')
+        {
+            //Replace unprintable characters
+            gbaDisplayBuffer.append('\\').append(pchHex[chThis >> 4]).append(pchHex[chThis & 0x0f]);
+        }
+        else
+        {
+            gbaDisplayBuffer.append((char)chThis);
+        }
+        ++i;
+    }
+    gbaEchoBuffer.clear();
+}
+
 //=============================================================================
 //=============================================================================
 void
@@ -3374,7 +3597,8 @@ MainWindow::SerialError(
             ui->btn_SpeedStop->setEnabled(false);
             ui->btn_SpeedStart->setEnabled(false);
             ui->combo_SpeedDataType->setEnabled(true);
-            if (ui->combo_SpeedDataType->currentIndex() == 1)
+            ui->spin_SpeedRate->setEnabled(true);
+            if (ui->combo_SpeedDataType->currentIndex() == SpeedDataTypeString || ui->combo_SpeedDataType->currentIndex() == SpeedDataTypeLatency || ui->combo_SpeedDataType->currentIndex() == SpeedDataTypePacket)
             {
                 //Enable string options
                 ui->edit_SpeedTestData->setEnabled(true);
@@ -3403,10 +3627,21 @@ MainWindow::SerialError(
                 //Stop 10 second stats update timer
                 gtmrSpeedTestStats10s.stop();
             }
+            if (gtmrSpeedRateTimer.isActive())
+            {
+                //Stop target rate send timer
+                gtmrSpeedRateTimer.stop();
+            }
+            if (gtmrSpeedSweepTimer.isActive())
+            {
+                //Stop rate sweep
+                gtmrSpeedSweepTimer.stop();
+            }
+            gbSpeedSweepRunning = false;
 
             //Clear buffers
             gbaSpeedMatchData.clear();
-            gbaSpeedReceivedData.clear();
+            gdvSpeedVerifier.SetMatchData(QByteArray());
 
             //Show finished message in status bar
             ui->statusBar->showMessage("Speed testing failed due to serial port error.");
@@ -3508,6 +3743,11 @@ MainWindow::MessagePass(
         QByteArray baTmpBA = strDataString.toUtf8();
         gspSerialPort.write(baTmpBA);
         gintQueuedTXBytes += baTmpBA.size();
+        if (gsrScriptRecorder.IsRecording() == true)
+        {
+            //Record the data sent, with the line ending if one is sent below
+            gsrScriptRecorder.RecordSent(bEscapeString == false && bFromScripting == false ? QByteArray(baTmpBA).append(ui->radio_LCR->isChecked() ? "\r" : ui->radio_LLF->isChecked() ? "\n" : ui->radio_LCRLF->isChecked() ? "\r\n" : ui->radio_LLFCR->isChecked() ? "\n\r" : "") : baTmpBA);
+        }
         if (ui->check_Echo->isChecked() == true)
         {
             if (ui->check_ShowCLRF->isChecked() == true)
@@ -3519,7 +3759,8 @@ MainWindow::MessagePass(
             //Replace unprintable characters
             baTmpBA.replace('\0', "\\00").replace("\x01", "\\01").replace("\x02", "\\02").replace("\x03", "\\03").replace("\x04", "\\04").replace("\x05", "\\05").replace("\x06", "\\06").replace("\x07", "\\07").replace("\x08", "\\08").replace("\x0b", "\\0B").replace("\x0c", "\\0C").replace("\x0e", "\\0E").replace("\x0f", "\\0F").replace("\x10", "\\10").replace("\x11", "\\11").replace("\x12", "\\12").replace("\x13", "\\13").replace("\x14", "\\14").replace("\x15", "\\15").replace("\x16", "\\16").replace("\x17", "\\17").replace("\x18", "\\18").replace("\x19", "\\19").replace("\x1a", "\\1a").replace("\x1b", "\\1b").replace("\x1c", "\\1c").replace("\x1d", "\\1d").replace("\x1e", "\\1e").replace("\x1f", "\\1f");
 
-            //Output to display buffer
+            //Output to display buffer, after any data sent by a script before it
+            FlushEchoBuffer();
             gbaDisplayBuffer.append(baTmpBA);
             if (!gtmrTextUpdateTimer.isActive())
             {
@@ -3810,6 +4051,7 @@ MainWindow::UpdateReceiveText(
     )
 {
     //Updates the receive text buffer
+    FlushEchoBuffer();
     ui->text_TermEditData->AddDatInText(&gbaDisplayBuffer);
     gbaDisplayBuffer.clear();
 }
@@ -5444,6 +5686,10 @@ MainWindow::on_btn_LogRefresh_clicked(
             ++i;
         }
     }
+
+    //Update the log search index for this directory
+    gstrLogDirectory = strDirPath;
+    UpdateLogIndex();
 }
 
 //=============================================================================
@@ -5870,6 +6116,18 @@ MainWindow::LoadSettings(
         {
             gpTermSettings->setValue("LogMode", DefaultLogMode); //Clear log before opening, 0 = no, 1 = yes
         }
+        if (gpTermSettings->value("LogIndexEnable").isNull())
+        {
+            gpTermSettings->setValue("LogIndexEnable", DefaultLogIndexEnable); //Index log files in the background for searching, 0 = no, 1 = yes
+        }
+        if (gpTermSettings->value("SpeedTestChunkSize").isNull())
+        {
+            gpTermSettings->setValue("SpeedTestChunkSize", DefaultSpeedTestChunkSize); //Number of bytes to send per chunk when speed testing, higher is needed to saturate fast baud rates
+        }
+        if (gpTermSettings->value("SpeedTestLowWater").isNull())
+        {
+            gpTermSettings->setValue("SpeedTestLowWater", DefaultSpeedTestLowWater); //Number of bytes left in the output buffer when speed testing at which the next chunk is sent
+        }
         if (gpTermSettings->value("LogEnable").isNull())
         {
             gpTermSettings->setValue("LogEnable", DefaultLogEnable); //0 = disabled, 1 = enable
@@ -6524,6 +6782,45 @@ MainWindow::ScriptFinished(
     gbScriptingRunning = false;
     gchTermMode = 0;
 }
+
+//=============================================================================
+//=============================================================================
+void
+MainWindow::ScriptSendData(
+    const QByteArray &baData
+    )
+{
+    //Sends data from the scripting form. The data is sent and logged as it is (so binary data is not changed), echoed data is made displayable when the display is next updated
+    if (gspSerialPort.isOpen() == true && gbLoopbackMode == false)
+    {
+        gspSerialPort.write(baData);
+        gintQueuedTXBytes += baData.size();
+        if (gsrScriptRecorder.IsRecording() == true)
+        {
+            //Record the data sent
+            gsrScriptRecorder.RecordSent(baData);
+        }
+        if (ui->check_Echo->isChecked() == true)
+        {
+            //Output to display buffer
+            gbaEchoBuffer.append(baData);
+            if (!gtmrTextUpdateTimer.isActive())
+            {
+                gtmrTextUpdateTimer.start();
+            }
+        }
+        gpMainLog->WriteRawLogData(baData);
+    }
+    else if (gspSerialPort.isOpen() == true && gbLoopbackMode == true)
+    {
+        //Loopback is enabled
+        gbaDisplayBuffer.append("\n[Cannot send: Loopback mode is enabled.]\n");
+        if (!gtmrTextUpdateTimer.isActive())
+        {
+            gtmrTextUpdateTimer.start();
+        }
+    }
+}
 #endif
 
 //=============================================================================
@@ -6585,6 +6882,22 @@ MainWindow::on_btn_SpeedStop_clicked(
     )
 {
     //Speed testing stop button pressed
+    if (gbSpeedMatrixRunning == true && gchSpeedMatrixStage == SpeedMatrixStageRun)
+    {
+        //Stopped by the user: cancel the remaining baud rate matrix tests once this test has stopped
+        gtmrSpeedMatrixTimer.stop();
+        gintSpeedMatrixBaudIndex = glstSpeedMatrixBauds.count();
+        gchSpeedMatrixStage = SpeedMatrixStageWait;
+        gtmrSpeedMatrixTimer.start(SpeedMatrixPollTime);
+    }
+    if (gbSpeedSweepRunning == true)
+    {
+        //Rate sweep cancelled, report the best rate found so far
+        gbSpeedSweepRunning = false;
+        gtmrSpeedSweepTimer.stop();
+        gstrSpeedSweepResult = QString("Rate sweep cancelled, highest loss-free rate found: ").append(QString::number(gintSpeedSweepLow)).append(" bytes/s.");
+    }
+
     if (gtmrSpeedTestDelayTimer != 0)
     {
         //Clean up delayed send data timer
@@ -6633,7 +6946,8 @@ MainWindow::on_btn_SpeedStop_clicked(
         ui->btn_SpeedStop->setEnabled(false);
         ui->btn_SpeedStart->setEnabled(true);
         ui->combo_SpeedDataType->setEnabled(true);
-        if (ui->combo_SpeedDataType->currentIndex() == 1)
+        ui->spin_SpeedRate->setEnabled(true);
+        if (ui->combo_SpeedDataType->currentIndex() == SpeedDataTypeString || ui->combo_SpeedDataType->currentIndex() == SpeedDataTypeLatency || ui->combo_SpeedDataType->currentIndex() == SpeedDataTypePacket)
         {
             //Enable string options
             ui->edit_SpeedTestData->setEnabled(true);
@@ -6662,13 +6976,24 @@ MainWindow::on_btn_SpeedStop_clicked(
             //Stop 10 second stats update timer
             gtmrSpeedTestStats10s.stop();
         }
+        if (gtmrSpeedRateTimer.isActive())
+        {
+            //Stop target rate send timer
+            gtmrSpeedRateTimer.stop();
+        }
+        if (gtmrSpeedSweepTimer.isActive())
+        {
+            //Stop rate sweep
+            gtmrSpeedSweepTimer.stop();
+        }
+        gbSpeedSweepRunning = false;
 
         //Clear buffers
         gbaSpeedMatchData.clear();
-        gbaSpeedReceivedData.clear();
+        gdvSpeedVerifier.SetMatchData(QByteArray());
 
         //Show message that test has finished
-        ui->statusBar->showMessage("Speed testing finished.");
+        ui->statusBar->showMessage(QString("Speed testing finished. ").append(gstrSpeedSweepResult));
     }
 }
 
@@ -6682,10 +7007,35 @@ MainWindow::SpeedMenuSelected(
     //Speed test menu item selected
     QChar chItem = qaAction->data().toChar();
 
+    if (chItem == SpeedMenuActionMatrix)
+    {
+        //Baud rate matrix test, ask for the baud rates, data types and test duration
+        bool bOk;
+        QString strBaudRates = QInputDialog::getText(this, "Baud Rate Matrix Test", "Baud rates to test (comma separated):", QLineEdit::Normal, ui->combo_Baud->currentText(), &bOk);
+        if (bOk == false || strBaudRates.isEmpty())
+        {
+            return;
+        }
+        QString strDataTypes = QInputDialog::getText(this, "Baud Rate Matrix Test", "Data types to test at each baud rate (comma separated):", QLineEdit::Normal, ui->combo_SpeedDataType->currentText(), &bOk);
+        if (bOk == false || strDataTypes.isEmpty())
+        {
+            return;
+        }
+        int intDuration = QInputDialog::getInt(this, "Baud Rate Matrix Test", "Time to run each test for (seconds):", SpeedMatrixDefaultDuration, 5, 86400, 1, &bOk);
+        if (bOk == false)
+        {
+            return;
+        }
+        bool bConfigure = (QMessageBox::question(this, "Baud Rate Matrix Test", "Change the module baud rate with AT+CFG 520 before testing each baud rate? The module must be in interactive (AT command) mode.", QMessageBox::Yes | QMessageBox::No, QMessageBox::Yes) == QMessageBox::Yes);
+        gstrSpeedMatrixOutput.clear();
+        SpeedMatrixStart(strBaudRates, strDataTypes, intDuration, bConfigure);
+        return;
+    }
+
     if (gspSerialPort.isOpen() == true && gbLoopbackMode == false && gbTermBusy == false)
     {
         //Check size of string if sending data
-        if (ui->combo_SpeedDataType->currentIndex() != 0 && !(ui->edit_SpeedTestData->text().length() > 3))
+        if (ui->combo_SpeedDataType->currentIndex() != SpeedDataTypeSpeed && ui->combo_SpeedDataType->currentIndex() < SpeedDataTypePRBS7 && !(ui->edit_SpeedTestData->text().length() > 3))
         {
             //Invalid string size
             QString strMessage = tr("Error: Test data string must be a minimum of 4 bytes for speed testing.");
@@ -6693,12 +7043,21 @@ MainWindow::SpeedMenuSelected(
             gpmErrorForm->SetMessage(&strMessage);
             return;
         }
+        else if (ui->combo_SpeedDataType->currentIndex() == SpeedDataTypePacket && ui->edit_SpeedTestData->text().toUtf8().length() > SpeedTestPacketMaxPayload)
+        {
+            //Invalid string size
+            QString strMessage = tr("Error: Test data string must be a maximum of ").append(QString::number(SpeedTestPacketMaxPayload)).append(" bytes for packet speed testing.");
+            gpmErrorForm->show();
+            gpmErrorForm->SetMessage(&strMessage);
+            return;
+        }
 
         //Enable testing
         gbSpeedTestRunning = true;
         ui->btn_SpeedStop->setEnabled(true);
         ui->btn_SpeedStart->setEnabled(false);
         ui->combo_SpeedDataType->setEnabled(false);
+        ui->spin_SpeedRate->setEnabled(false);
         ui->edit_SpeedTestData->setEnabled(false);
         ui->check_SpeedStringUnescape->setEnabled(false);
 
@@ -6715,11 +7074,49 @@ MainWindow::SpeedMenuSelected(
         gintSpeedBytesSent = 0;
         gintSpeedBytesSent10s = 0;
         gintSpeedBufferCount = 0;
+        gintSpeedDisplayDropped = 0;
+        ui->label_SpeedDisplayDropped->clear();
         gintSpeedTestStatPacketsSent = 0;
         gintSpeedTestStatPacketsReceived = 0;
-        gintSpeedTestReceiveIndex = 0;
+        gdvSpeedVerifier.Reset();
         gintSpeedTestStatSuccess = 0;
         gintSpeedTestStatErrors = 0;
+        gintSpeedLatencySequence = 0;
+        gintSpeedLatencySentTime = -1;
+        gintSpeedLatencyTimeouts = 0;
+        ghstSpeedLatency.Reset();
+        gintSpeedPacketSequence = 0;
+        gintSpeedPacketNextSequence = 0;
+        gbSpeedPacketFirst = true;
+        gbSpeedPacketSynced = true;
+        gintSpeedPacketCorruptPending = 0;
+        gintSpeedPacketLost = 0;
+        gintSpeedPacketCorrupt = 0;
+        gintSpeedPacketDuplicate = 0;
+        gintSpeedPacketOutOfOrder = 0;
+        memset(gintSpeedPacketSeen, 0, sizeof(gintSpeedPacketSeen));
+        memset(gintSpeedPacketLostMap, 0, sizeof(gintSpeedPacketLostMap));
+        gtsSpeedSeries.Clear();
+
+        //Load send chunk sizes, the low water mark must be below the chunk size or the buffer would never drain
+        gintSpeedTestChunkSize = qBound((uint)SpeedTestMinChunkSize, gpTermSettings->value("SpeedTestChunkSize", DefaultSpeedTestChunkSize).toUInt(), (uint)SpeedTestMaxChunkSize);
+        gintSpeedTestLowWater = gpTermSettings->value("SpeedTestLowWater", DefaultSpeedTestLowWater).toUInt();
+        if (gintSpeedTestLowWater >= gintSpeedTestChunkSize)
+        {
+            gintSpeedTestLowWater = gintSpeedTestChunkSize/4;
+        }
+
+        //Latency tests only ever have one packet outstanding so are not rate limited
+        gintSpeedRateLimit = (ui->combo_SpeedDataType->currentIndex() == SpeedDataTypeLatency ? 0 : ui->spin_SpeedRate->value());
+        gbSpeedSweepRunning = false;
+        gstrSpeedSweepResult.clear();
+        gstrSpeedSweepSteps.clear();
+        gintSpeedSeriesLastRx = 0;
+        gintSpeedSeriesLastTx = 0;
+        gintSpeedSeriesLastPackets = 0;
+        gintSpeedSeriesLastErrors = 0;
+        gintSpeedSeriesLastTime = 0;
+        ui->plot_Speed->update();
 
         //Clear all text boxes
         ui->edit_SpeedPacketsBad->setText("0");
@@ -6737,18 +7134,40 @@ MainWindow::SpeedMenuSelected(
         ui->edit_SpeedBytesSent->setText("0");
         ui->edit_SpeedBytesSent10s->setText("0");
         ui->edit_SpeedBytesSentAvg->setText("0");
+        ui->edit_SpeedLatencyP50->setText("0");
+        ui->edit_SpeedLatencyP99->setText("0");
+        ui->edit_SpeedLatencyP999->setText("0");
+        ui->edit_SpeedLatencyMin->setText("0");
+        ui->edit_SpeedLatencyAvg->setText("0");
+        ui->edit_SpeedLatencyMax->setText("0");
+        ui->edit_SpeedLatencySamples->setText("0");
+        ui->edit_SpeedLatencyLost->setText("0");
+        ui->edit_SpeedPacketLost->setText("0");
+        ui->edit_SpeedPacketCorrupt->setText("0");
+        ui->edit_SpeedPacketDuplicate->setText("0");
+        ui->edit_SpeedPacketOutOfOrder->setText("0");
 
         //Clear all labels
         ui->label_SpeedRx->setText("0");
         ui->label_SpeedTx->setText("0");
         ui->label_SpeedTime->setText("00:00:00:00");
 
-        //Clear received buffer and data match buffer
+        //Clear data match buffer
         gbaSpeedMatchData.clear();
-        gbaSpeedReceivedData.clear();
 
         //Check if this is a string match or throughput-only test
-        if (ui->combo_SpeedDataType->currentIndex() != 0)
+        if (ui->combo_SpeedDataType->currentIndex() >= SpeedDataTypePRBS7)
+        {
+            //PRBS test, generate data in chunks
+            gprbSpeedPrbs.SetOrder(ui->combo_SpeedDataType->currentIndex() == SpeedDataTypePRBS31 ? 31 : (ui->combo_SpeedDataType->currentIndex() == SpeedDataTypePRBS23 ? 23 : (ui->combo_SpeedDataType->currentIndex() == SpeedDataTypePRBS15 ? 15 : 7)));
+            ui->edit_SpeedPrbsBits->setText("0");
+            ui->edit_SpeedPrbsErrors->setText("0");
+            ui->edit_SpeedPrbsBER->setText("0");
+            ui->edit_SpeedPrbsErroredSeconds->setText("0");
+            ui->edit_SpeedPrbsSlips->setText("0");
+            ui->edit_SpeedPrbsSync->setText("Searching");
+        }
+        else if (ui->combo_SpeedDataType->currentIndex() != SpeedDataTypeSpeed)
         {
             //Escape character codes if enabled
             if (ui->check_SpeedStringUnescape->isChecked())
@@ -6766,8 +7185,37 @@ MainWindow::SpeedMenuSelected(
 
             //Set length of match data
             gintSpeedTestMatchDataLength = gbaSpeedMatchData.length();
+            gdvSpeedVerifier.SetMatchData(gbaSpeedMatchData);
+
+            if (ui->combo_SpeedDataType->currentIndex() == SpeedDataTypeLatency)
+            {
+                //Latency packets consist of a header followed by the test data, the packet length is used for packet statistics
+                gbaSpeedLatencyPacket.fill(0, SpeedTestLatencyHeaderSize);
+                gbaSpeedLatencyPacket[0] = (char)SpeedTestLatencyMagic1;
+                gbaSpeedLatencyPacket[1] = (char)SpeedTestLatencyMagic2;
+                gbaSpeedLatencyPacket.append(gbaSpeedMatchData);
+                gintSpeedTestMatchDataLength = gbaSpeedLatencyPacket.length();
+                gbaSpeedPacketBuffer.clear();
+                gbaSpeedPacketBuffer.reserve(SpeedTestReceiveBufferSize + gintSpeedTestMatchDataLength);
+            }
+            else if (ui->combo_SpeedDataType->currentIndex() == SpeedDataTypePacket)
+            {
+                //CRC32 packets consist of a header, the test data and a CRC32 of the header and test data
+                gbaSpeedPacket.fill(0, SpeedTestPacketHeaderSize);
+                gbaSpeedPacket[0] = (char)SpeedTestPacketMagic1;
+                gbaSpeedPacket[1] = (char)SpeedTestPacketMagic2;
+                qToLittleEndian<quint16>((quint16)gbaSpeedMatchData.length(), (uchar *)gbaSpeedPacket.data() + 6);
+                gbaSpeedPacket.append(gbaSpeedMatchData);
+                gbaSpeedPacket.append(QByteArray(SpeedTestPacketCRCSize, 0));
+                gintSpeedTestMatchDataLength = gbaSpeedPacket.length();
+                gbaSpeedPacketBuffer.clear();
+                gbaSpeedPacketBuffer.reserve(SpeedTestReceiveBufferSize + SpeedTestPacketHeaderSize + SpeedTestPacketMaxPayload + SpeedTestPacketCRCSize);
+            }
         }
 
+        //Build the data sent for each chunk
+        SpeedTestBuildSendBuffer();
+
         if (chItem == SpeedMenuActionRecv)
         {
             //Receive only test
@@ -6779,7 +7227,7 @@ MainWindow::SpeedMenuSelected(
             gchSpeedTestMode = SpeedModeSend;
 
             //Send data
-            SendSpeedTestData(SpeedTestChunkSize);
+            SpeedTestBeginSending();
         }
         else if (chItem == SpeedMenuActionSendRecv || chItem == SpeedMenuActionSendRecv5Delay || chItem == SpeedMenuActionSendRecv10Delay || chItem == SpeedMenuActionSendRecv15Delay)
         {
@@ -6797,8 +7245,29 @@ MainWindow::SpeedMenuSelected(
             else
             {
                 //Send immediately
-                SendSpeedTestData(SpeedTestChunkSize);
+                SpeedTestBeginSending();
+            }
+        }
+        else if (chItem == SpeedMenuActionSendRecvSweep)
+        {
+            //Rate sweep, start at the highest rate (the configured rate or the highest rate the port can send at) and binary search for the highest rate with no errors
+            gchSpeedTestMode = SpeedModeSendRecv;
+            if (ui->spin_SpeedRate->value() > 0)
+            {
+                gintSpeedSweepMax = ui->spin_SpeedRate->value();
+            }
+            else
+            {
+                //Each character has a start bit, data bits, an optional parity bit and stop bits
+                gintSpeedSweepMax = gspSerialPort.baudRate()/(1 + gspSerialPort.dataBits() + (gspSerialPort.parity() == QSerialPort::NoParity ? 0 : 1) + (gspSerialPort.stopBits() == QSerialPort::TwoStop ? 2 : 1));
             }
+            gintSpeedSweepLow = 0;
+            gintSpeedSweepHigh = gintSpeedSweepMax;
+            gbSpeedSweepRunning = true;
+            gbSpeedSweepHolding = false;
+            SpeedTestSetRate(gintSpeedSweepMax);
+            SpeedTestBeginSending();
+            gtmrSpeedSweepTimer.start(SpeedTestSweepSettleTime);
         }
 
         //Show message in status bar
@@ -6828,7 +7297,7 @@ MainWindow::OutputSpeedTestStats(
     {
         //Receiving active
         ui->edit_SpeedBytesRec10s->setText(QString::number(gintSpeedBytesReceived10s));
-        if (ui->combo_SpeedDataType->currentIndex() != 0)
+        if (ui->combo_SpeedDataType->currentIndex() != SpeedDataTypeSpeed && ui->combo_SpeedDataType->currentIndex() < SpeedDataTypePRBS7)
         {
             //Show stats about packets
             ui->edit_SpeedPacketsRec10s->setText(QString::number(gintSpeedBytesReceived10s/gintSpeedTestMatchDataLength));
@@ -6848,7 +7317,10 @@ MainWindow::on_combo_SpeedDataType_currentIndexChanged(
     )
 {
     //Speed test type changed
-    if (ui->combo_SpeedDataType->currentIndex() == 0)
+    ui->groupBox_SpeedLatency->setVisible(ui->combo_SpeedDataType->currentIndex() == SpeedDataTypeLatency);
+    ui->groupBox_SpeedPacketErrors->setVisible(ui->combo_SpeedDataType->currentIndex() == SpeedDataTypePacket);
+    ui->groupBox_SpeedPrbs->setVisible(ui->combo_SpeedDataType->currentIndex() >= SpeedDataTypePRBS7);
+    if (ui->combo_SpeedDataType->currentIndex() == SpeedDataTypeSpeed)
     {
         //Throughput only
         ui->edit_SpeedTestData->setEnabled(false);
@@ -6864,15 +7336,18 @@ MainWindow::on_combo_SpeedDataType_currentIndexChanged(
 
 
         //Disable sending modes
+        gpSpeedMenu->actions()[0]->setEnabled(true);
         gpSpeedMenu->actions()[1]->setEnabled(false);
         gpSpeedMenu->actions()[2]->setEnabled(false);
         gpSpeedMenu->actions()[3]->setEnabled(false);
         gpSpeedMenu->actions()[4]->setEnabled(false);
         gpSpeedMenu->actions()[5]->setEnabled(false);
+        gpSpeedMenu->actions()[6]->setEnabled(false);
     }
-    else if (ui->combo_SpeedDataType->currentIndex() == 1)
+    else if (ui->combo_SpeedDataType->currentIndex() == SpeedDataTypeString || ui->combo_SpeedDataType->currentIndex() == SpeedDataTypeLatency || ui->combo_SpeedDataType->currentIndex() == SpeedDataTypePacket)
     {
-        //String
+        //String, latency or packet
+        ui->edit_SpeedTestData->setEnabled(true);
         ui->edit_SpeedPacketsSent->setEnabled(true);
         ui->edit_SpeedPacketsSent10s->setEnabled(true);
         ui->edit_SpeedPacketsSentAvg->setEnabled(true);
@@ -6884,12 +7359,37 @@ MainWindow::on_combo_SpeedDataType_currentIndexChanged(
         ui->edit_SpeedPacketsErrorRate->setEnabled(true);
 
 
-        //Enable sending modes
+        //Enable sending modes (latency tests need packets to be returned so only send & receive modes are available)
+        gpSpeedMenu->actions()[0]->setEnabled(ui->combo_SpeedDataType->currentIndex() != SpeedDataTypeLatency);
+        gpSpeedMenu->actions()[1]->setEnabled(ui->combo_SpeedDataType->currentIndex() != SpeedDataTypeLatency);
+        gpSpeedMenu->actions()[2]->setEnabled(true);
+        gpSpeedMenu->actions()[3]->setEnabled(true);
+        gpSpeedMenu->actions()[4]->setEnabled(true);
+        gpSpeedMenu->actions()[5]->setEnabled(true);
+        gpSpeedMenu->actions()[6]->setEnabled(ui->combo_SpeedDataType->currentIndex() != SpeedDataTypeLatency);
+    }
+    else
+    {
+        //PRBS, test data is generated and bit errors are counted instead of packets
+        ui->edit_SpeedTestData->setEnabled(false);
+        ui->edit_SpeedPacketsSent->setEnabled(false);
+        ui->edit_SpeedPacketsSent10s->setEnabled(false);
+        ui->edit_SpeedPacketsSentAvg->setEnabled(false);
+        ui->edit_SpeedPacketsRec->setEnabled(false);
+        ui->edit_SpeedPacketsRec10s->setEnabled(false);
+        ui->edit_SpeedPacketsRecAvg->setEnabled(false);
+        ui->edit_SpeedPacketsGood->setEnabled(false);
+        ui->edit_SpeedPacketsBad->setEnabled(false);
+        ui->edit_SpeedPacketsErrorRate->setEnabled(false);
+
+        //Enable all modes
+        gpSpeedMenu->actions()[0]->setEnabled(true);
         gpSpeedMenu->actions()[1]->setEnabled(true);
         gpSpeedMenu->actions()[2]->setEnabled(true);
         gpSpeedMenu->actions()[3]->setEnabled(true);
         gpSpeedMenu->actions()[4]->setEnabled(true);
         gpSpeedMenu->actions()[5]->setEnabled(true);
+        gpSpeedMenu->actions()[6]->setEnabled(true);
     }
 }
 
@@ -6925,6 +7425,8 @@ MainWindow::on_btn_SpeedCopy_clicked(
         append(QString::number(strTmpStr.toUtf8().size())).
         append("\r\n    > Unescape: ").
         append((ui->check_SpeedStringUnescape->isChecked() ? "Yes" : "No")).
+        append("\r\n    > Send Rate (Bytes/s): ").
+        append((gintSpeedRateLimit == 0 ? QString("Max") : QString::number(gintSpeedRateLimit))).
         append("\r\n    > Test Type: ").
         append((gchSpeedTestMode == SpeedModeSendRecv ? "Send/Receive" : (gchSpeedTestMode == SpeedModeSend ? "Send" : (gchSpeedTestMode == SpeedModeRecv ? "Receive" : "Inactive")))).
         append("\r\n---------------------------------\r\nResults:\r\n    > Test time: ").
@@ -6959,6 +7461,47 @@ MainWindow::on_btn_SpeedCopy_clicked(
         append(ui->edit_SpeedPacketsBad->text()).
         append("\r\n    > Rx Error Rate % (Packets): ").
         append(ui->edit_SpeedPacketsErrorRate->text()).
+        append("\r\n    > Display Dropped (Bytes): ").
+        append(QString::number(gintSpeedDisplayDropped)).
+        append(ui->combo_SpeedDataType->currentIndex() == SpeedDataTypeLatency ? QString("\r\n    > Latency p50 (us): ").
+            append(ui->edit_SpeedLatencyP50->text()).
+            append("\r\n    > Latency p99 (us): ").
+            append(ui->edit_SpeedLatencyP99->text()).
+            append("\r\n    > Latency p99.9 (us): ").
+            append(ui->edit_SpeedLatencyP999->text()).
+            append("\r\n    > Latency min (us): ").
+            append(ui->edit_SpeedLatencyMin->text()).
+            append("\r\n    > Latency average (us): ").
+            append(ui->edit_SpeedLatencyAvg->text()).
+            append("\r\n    > Latency max (us): ").
+            append(ui->edit_SpeedLatencyMax->text()).
+            append("\r\n    > Latency samples: ").
+            append(ui->edit_SpeedLatencySamples->text()).
+            append("\r\n    > Latency lost (timeout): ").
+            append(ui->edit_SpeedLatencyLost->text()) : QString("")).
+        append(ui->combo_SpeedDataType->currentIndex() == SpeedDataTypePacket ? QString("\r\n    > Rx Lost (Packets): ").
+            append(ui->edit_SpeedPacketLost->text()).
+            append("\r\n    > Rx Corrupt (Packets): ").
+            append(ui->edit_SpeedPacketCorrupt->text()).
+            append("\r\n    > Rx Duplicate (Packets): ").
+            append(ui->edit_SpeedPacketDuplicate->text()).
+            append("\r\n    > Rx Out of Order (Packets): ").
+            append(ui->edit_SpeedPacketOutOfOrder->text()) : QString("")).
+        append(ui->combo_SpeedDataType->currentIndex() >= SpeedDataTypePRBS7 ? QString("\r\n    > Rx Bits Checked: ").
+            append(ui->edit_SpeedPrbsBits->text()).
+            append("\r\n    > Rx Bit Errors: ").
+            append(ui->edit_SpeedPrbsErrors->text()).
+            append("\r\n    > Rx BER: ").
+            append(ui->edit_SpeedPrbsBER->text()).
+            append("\r\n    > Rx Errored Seconds: ").
+            append(ui->edit_SpeedPrbsErroredSeconds->text()).
+            append("\r\n    > Rx Bit Slips: ").
+            append(ui->edit_SpeedPrbsSlips->text()) : QString("")).
+        append(gstrSpeedSweepSteps.isEmpty() == false ? QString("\r\n---------------------------------\r\nRate Sweep:").
+            append(gstrSpeedSweepSteps).
+            append("\r\n    > Highest Loss-Free Rate (Bytes/s): ").
+            append(QString::number(gintSpeedSweepLow)).
+            append(gbSpeedSweepRunning == true ? " (sweep in progress)" : "") : QString("")).
         append("\r\n=================================\r\n"));
 }
 
@@ -6966,37 +7509,48 @@ MainWindow::on_btn_SpeedCopy_clicked(
 //=============================================================================
 void
 MainWindow::SendSpeedTestData(
-    int intMaxLength
     )
 {
-    //Send string out. It's OK to send less than the maximum length but not more
-    int intSendTimes = (intMaxLength / gintSpeedTestMatchDataLength);
-    if (ui->check_SpeedShowTX->isChecked())
+    if (ui->combo_SpeedDataType->currentIndex() == SpeedDataTypeLatency)
     {
-        //Show TX data in terminal
-        while (intSendTimes > 0)
+        //Only one latency packet is outstanding at a time
+        if (gintSpeedLatencySentTime == -1)
         {
-            //Append to buffer
-            gbaSpeedDisplayBuffer.append(gbaSpeedMatchData);
-            --intSendTimes;
+            SpeedTestSendLatencyPacket();
         }
-        if (!gtmrSpeedUpdateTimer.isActive())
+        return;
+    }
+
+    if (ui->combo_SpeedDataType->currentIndex() >= SpeedDataTypePRBS7)
+    {
+        //Send the next part of the PRBS sequence
+        gprbSpeedPrbs.Generate(gbaSpeedPrbsData.data(), gbaSpeedPrbsData.length());
+        if (ui->check_SpeedShowTX->isChecked())
         {
-            gtmrSpeedUpdateTimer.start();
+            //Show TX data in terminal
+            SpeedTestDisplayData(gbaSpeedPrbsData);
         }
-
-        //Reset variable for actual sending
-        intSendTimes = (intMaxLength / gintSpeedTestMatchDataLength);
+        gspSerialPort.write(gbaSpeedPrbsData);
+        gintSpeedBufferCount += gbaSpeedPrbsData.length();
+        return;
+    }
+    else if (ui->combo_SpeedDataType->currentIndex() == SpeedDataTypePacket)
+    {
+        //Send a chunk of sequence numbered packets
+        SpeedTestSendPackets();
+        return;
     }
 
-    while (intSendTimes > 0)
+    //Send a chunk of repeated test strings with a single write
+    if (ui->check_SpeedShowTX->isChecked())
     {
-        //Send out until finished
-        gspSerialPort.write(gbaSpeedMatchData);
-        gintSpeedBufferCount += gintSpeedTestMatchDataLength;
-        --intSendTimes;
-        ++gintSpeedTestStatPacketsSent;
+        //Show TX data in terminal
+        SpeedTestDisplayData(gbaSpeedSendBuffer);
     }
+
+    gspSerialPort.write(gbaSpeedSendBuffer);
+    gintSpeedBufferCount += gbaSpeedSendBuffer.length();
+    gintSpeedTestStatPacketsSent += gintSpeedSendBufferPackets;
 }
 
 //=============================================================================
@@ -7011,10 +7565,10 @@ MainWindow::SpeedTestBytesWritten(
     {
         //Sending data in speed test
         gintSpeedBufferCount -= intByteCount;
-        if (gintSpeedBufferCount <= SpeedTestMinBufSize)
+        if (gintSpeedRateLimit == 0 && gintSpeedBufferCount <= gintSpeedTestLowWater && ui->combo_SpeedDataType->currentIndex() != SpeedDataTypeLatency)
         {
-            //Buffer has space: send more data
-            SendSpeedTestData(SpeedTestChunkSize);
+            //Buffer has space: send more data (when sending at a target rate, data is sent from the rate timer instead)
+            SendSpeedTestData();
         }
     }
 
@@ -7029,81 +7583,41 @@ void
 MainWindow::SpeedTestReceive(
     )
 {
-    //Receieved data from serial port in speed test mode
-    QByteArray baOrigData = gspSerialPort.readAll();
-    if ((gchSpeedTestMode & SpeedModeRecv) == SpeedModeRecv)
+    //Receieved data from serial port in speed test mode, read directly into the fixed receive buffer to avoid allocating memory for each read
+    qint64 intReadSize;
+    while ((intReadSize = gspSerialPort.read(gchSpeedReceiveBuffer, SpeedTestReceiveBufferSize)) > 0)
     {
-        //Check data as in receieve mode
-        gintSpeedBytesReceived += baOrigData.size();
-        gintSpeedBytesReceived10s += baOrigData.size();
-
-        if (ui->check_SpeedShowRX->isChecked() == true)
+        if ((gchSpeedTestMode & SpeedModeRecv) == SpeedModeRecv)
         {
-            //Append RX data to buffer
-            gbaSpeedDisplayBuffer.append(baOrigData);
-            if (!gtmrSpeedUpdateTimer.isActive())
+            //Check data as in receieve mode
+            gintSpeedBytesReceived += intReadSize;
+            gintSpeedBytesReceived10s += intReadSize;
+
+            if (ui->check_SpeedShowRX->isChecked() == true)
             {
-                gtmrSpeedUpdateTimer.start();
+                //Append RX data to buffer
+                SpeedTestDisplayData(QByteArray::fromRawData(gchSpeedReceiveBuffer, intReadSize));
             }
-        }
 
-        if (ui->combo_SpeedDataType->currentIndex() != 0)
-        {
-            //Test data is OK
-            gbaSpeedReceivedData.append(baOrigData);
-            while (gbaSpeedReceivedData.length() > 0)
+            if (ui->combo_SpeedDataType->currentIndex() == SpeedDataTypeLatency)
             {
-                //Data to check
-                int SizeToTest = gintSpeedTestMatchDataLength - gintSpeedTestReceiveIndex;
-                if (SizeToTest > gbaSpeedReceivedData.length())
-                {
-                    SizeToTest = gbaSpeedReceivedData.length();
-                }
-
-                if (gbaSpeedReceivedData.left(SizeToTest) == gbaSpeedMatchData.mid(gintSpeedTestReceiveIndex, SizeToTest))
-                {
-                    //Good
-                    gbaSpeedReceivedData.remove(0, SizeToTest);
-                    gintSpeedTestReceiveIndex = gintSpeedTestReceiveIndex + SizeToTest;
-                    if (gintSpeedTestReceiveIndex >= gintSpeedTestMatchDataLength)
-                    {
-                        ++gintSpeedTestStatSuccess;
-                        ++gintSpeedTestStatPacketsReceived;
-                        gintSpeedTestReceiveIndex = 0;
-                    }
-                }
-                else
-                {
-                    //Bad
-                    ++gintSpeedTestStatErrors;
-
-                    if (ui->check_SpeedShowErrors->isChecked())
-                    {
-                        //Show error
-                        gbaSpeedDisplayBuffer.append(QString("\r\nError: Data mismatch.\r\n\tExpected: ").append(gbaSpeedMatchData.mid(gintSpeedTestReceiveIndex, SizeToTest)).append("\r\n\tGot     : ").append(gbaSpeedReceivedData.left(SizeToTest)).append("\r\n"));
-                        if (!gtmrSpeedUpdateTimer.isActive())
-                        {
-                            gtmrSpeedUpdateTimer.start();
-                        }
-                    }
-
-                    //Search for start character (ignoring first character)
-                    int StartChar = gbaSpeedReceivedData.indexOf(gbaSpeedMatchData.at(0), 1);
-                    if (StartChar == -1)
-                    {
-                        //Not found, clear whole receive buffer
-                        gbaSpeedReceivedData.clear();
-                        gintSpeedTestReceiveIndex = 0;
-                        gintSpeedTestReceiveIndex = gintSpeedTestReceiveIndex + SizeToTest;
-                    }
-                    else
-                    {
-                        //Found, remove until this character
-                        gbaSpeedReceivedData.remove(0, StartChar);
-                        gintSpeedTestReceiveIndex = 0;
-                    }
-                    ++gintSpeedTestStatPacketsReceived;
-                }
+                //Check latency packets
+                SpeedTestVerifyLatency(gchSpeedReceiveBuffer, intReadSize);
+            }
+            else if (ui->combo_SpeedDataType->currentIndex() == SpeedDataTypePacket)
+            {
+                //Check CRC32 packets
+                SpeedTestVerifyPackets(gchSpeedReceiveBuffer, intReadSize);
+            }
+            else if (ui->combo_SpeedDataType->currentIndex() >= SpeedDataTypePRBS7)
+            {
+                //Check PRBS data
+                gprbSpeedPrbs.Verify(gchSpeedReceiveBuffer, intReadSize, gtmrSpeedTimer.elapsed()/1000);
+            }
+            else if (ui->combo_SpeedDataType->currentIndex() != SpeedDataTypeSpeed)
+            {
+                //Test data is OK
+                SpeedTestVerifyData(gchSpeedReceiveBuffer, intReadSize);
             }
         }
     }
@@ -7112,38 +7626,1058 @@ MainWindow::SpeedTestReceive(
 //=============================================================================
 //=============================================================================
 void
-MainWindow::UpdateSpeedTestValues(
+MainWindow::SpeedTestVerifyData(
+    const char *pchData,
+    qint64 intLength
     )
 {
-    //Update speed test statistics
-    unsigned long lngElapsed = gtmrSpeedTimer.nsecsElapsed()/1000000;
-    unsigned int intHours = (lngElapsed / 3600000);
-    unsigned char chMinutes = (lngElapsed / 60000) % 60;
-    unsigned char chSeconds = (lngElapsed % 60000) / 1000;
-    unsigned int intMiliseconds = (lngElapsed % 600)/10;
-    ui->label_SpeedTime->setText(QString((intHours < 10 ? "0" : "")).append(QString::number(intHours)).append((chMinutes < 10 ? ":0" : ":")).append(QString::number(chMinutes)).append((chSeconds < 10 ? ":0" : ":")).append(QString::number(chSeconds)).append((intMiliseconds < 10 ? ".0" : ".")).append(QString::number(intMiliseconds)));
-
-    if (gintSpeedBytesSent > 0)
-    {
-        //Update sent data
-        ui->label_SpeedTx->setText(QString::number(gintSpeedBytesSent));
-        ui->edit_SpeedBytesSent->setText(QString::number(gintSpeedBytesSent));
-        ui->edit_SpeedPacketsSent->setText(QString::number(gintSpeedTestStatPacketsSent));
+    //Compares received data against the match data, mismatch details are only collected when they are shown
+    QList<LrdDataMismatch> lstMismatches;
+    quint64 intMatched = 0;
+    quint64 intErrors = gdvSpeedVerifier.Verify(pchData, intLength, &intMatched, (ui->check_SpeedShowErrors->isChecked() ? &lstMismatches : NULL));
+    gintSpeedTestStatSuccess += intMatched;
+    gintSpeedTestStatErrors += intErrors;
+    gintSpeedTestStatPacketsReceived += intMatched + intErrors;
+
+    int i = 0;
+    while (i < lstMismatches.count())
+    {
+        //Show error
+        SpeedTestDisplayData(QString("\r\nError: Data mismatch.\r\n\tExpected: ").append(lstMismatches.at(i).baExpected).append("\r\n\tGot     : ").append(lstMismatches.at(i).baReceived).append("\r\n").toUtf8());
+        ++i;
     }
+}
 
-    if ((gchSpeedTestMode & SpeedModeRecv) == SpeedModeRecv)
-    {
-        //Receive mode active
-        ui->label_SpeedRx->setText(QString::number(gintSpeedBytesReceived));
+//=============================================================================
+//=============================================================================
+void
+MainWindow::SpeedTestSendLatencyPacket(
+    )
+{
+    //Sends the next latency packet with the sequence number and send time (in us since the test started) in the header
+    ++gintSpeedLatencySequence;
+    gintSpeedLatencySentTime = gtmrSpeedTimer.nsecsElapsed()/1000;
+    qToLittleEndian<quint32>(gintSpeedLatencySequence, (uchar *)gbaSpeedLatencyPacket.data() + 2);
+    qToLittleEndian<qint64>(gintSpeedLatencySentTime, (uchar *)gbaSpeedLatencyPacket.data() + 6);
+
+    if (ui->check_SpeedShowTX->isChecked())
+    {
+        //Show TX data in terminal
+        SpeedTestDisplayData(gbaSpeedLatencyPacket);
+    }
+
+    gspSerialPort.write(gbaSpeedLatencyPacket);
+    gintSpeedBufferCount += gintSpeedTestMatchDataLength;
+    ++gintSpeedTestStatPacketsSent;
+}
+
+//=============================================================================
+//=============================================================================
+void
+MainWindow::SpeedTestVerifyLatency(
+    const char *pchData,
+    qint64 intLength
+    )
+{
+    //Checks returned latency packets and records the round-trip time of each one
+    gbaSpeedPacketBuffer.append(pchData, intLength);
+    const char *pchBuffer = gbaSpeedPacketBuffer.constData();
+    const char *pchPayload = gbaSpeedLatencyPacket.constData() + SpeedTestLatencyHeaderSize;
+    int intPosition = 0;
+    while ((quint32)(gbaSpeedPacketBuffer.length() - intPosition) >= gintSpeedTestMatchDataLength)
+    {
+        if ((quint8)pchBuffer[intPosition] != SpeedTestLatencyMagic1 || (quint8)pchBuffer[intPosition + 1] != SpeedTestLatencyMagic2)
+        {
+            //Not at the start of a packet
+            ++gintSpeedTestStatErrors;
+            ++gintSpeedTestStatPacketsReceived;
+            if (ui->check_SpeedShowErrors->isChecked())
+            {
+                //Show error
+                SpeedTestDisplayData("\r\nError: Latency packet header not found, resynchronising.\r\n");
+            }
+
+            //Search for the next start byte
+            const char *pchStart = (const char *)memchr(&pchBuffer[intPosition + 1], (char)SpeedTestLatencyMagic1, gbaSpeedPacketBuffer.length() - intPosition - 1);
+            intPosition = (pchStart == NULL ? gbaSpeedPacketBuffer.length() : pchStart - pchBuffer);
+            continue;
+        }
+
+        ++gintSpeedTestStatPacketsReceived;
+        if (memcmp(&pchBuffer[intPosition + SpeedTestLatencyHeaderSize], pchPayload, gintSpeedTestMatchDataLength - SpeedTestLatencyHeaderSize) != 0)
+        {
+            //Payload is corrupt
+            ++gintSpeedTestStatErrors;
+            if (ui->check_SpeedShowErrors->isChecked())
+            {
+                //Show error
+                SpeedTestDisplayData("\r\nError: Latency packet data mismatch.\r\n");
+            }
+        }
+        else
+        {
+            //Good packet, record the round-trip time
+            ++gintSpeedTestStatSuccess;
+            quint32 intSequence = qFromLittleEndian<quint32>((const uchar *)&pchBuffer[intPosition + 2]);
+            qint64 intSentTime = qFromLittleEndian<qint64>((const uchar *)&pchBuffer[intPosition + 6]);
+            qint64 intNow = gtmrSpeedTimer.nsecsElapsed()/1000;
+            if (intSentTime >= 0 && intSentTime <= intNow)
+            {
+                ghstSpeedLatency.Record(intNow - intSentTime);
+            }
+
+            if (intSequence == gintSpeedLatencySequence && gintSpeedLatencySentTime != -1)
+            {
+                //Outstanding packet has returned, send the next one
+                gintSpeedLatencySentTime = -1;
+                if ((gchSpeedTestMode & SpeedModeSend) == SpeedModeSend)
+                {
+                    SpeedTestSendLatencyPacket();
+                }
+            }
+        }
+        intPosition += gintSpeedTestMatchDataLength;
+    }
+
+    //Remove processed data
+    gbaSpeedPacketBuffer.remove(0, intPosition);
+}
+
+//=============================================================================
+//=============================================================================
+void
+MainWindow::UpdateSpeedTestLatencyValues(
+    )
+{
+    //Update latency statistics
+    ui->edit_SpeedLatencyP50->setText(QString::number(ghstSpeedLatency.Percentile(50.0)));
+    ui->edit_SpeedLatencyP99->setText(QString::number(ghstSpeedLatency.Percentile(99.0)));
+    ui->edit_SpeedLatencyP999->setText(QString::number(ghstSpeedLatency.Percentile(99.9)));
+    ui->edit_SpeedLatencyMin->setText(QString::number(ghstSpeedLatency.Min()));
+    ui->edit_SpeedLatencyAvg->setText(QString::number(ghstSpeedLatency.Mean(), 'f', 1));
+    ui->edit_SpeedLatencyMax->setText(QString::number(ghstSpeedLatency.Max()));
+    ui->edit_SpeedLatencySamples->setText(QString::number(ghstSpeedLatency.Count()));
+    ui->edit_SpeedLatencyLost->setText(QString::number(gintSpeedLatencyTimeouts));
+}
+
+//=============================================================================
+//=============================================================================
+void
+MainWindow::SpeedTestSendPackets(
+    )
+{
+    //Sends a chunk of CRC32 packets, the sequence number and CRC of each packet in the prebuilt chunk are updated in place and the whole chunk is written at once
+    char *pchPacket = gbaSpeedSendBuffer.data();
+    qint64 intCRCOffset = gintSpeedTestMatchDataLength - SpeedTestPacketCRCSize;
+    quint32 i = 0;
+    while (i < gintSpeedSendBufferPackets)
+    {
+        ++gintSpeedPacketSequence;
+        qToLittleEndian<quint32>(gintSpeedPacketSequence, (uchar *)pchPacket + 2);
+        qToLittleEndian<quint32>(LrdCrc32::Calculate(pchPacket, intCRCOffset), (uchar *)pchPacket + intCRCOffset);
+        pchPacket += gintSpeedTestMatchDataLength;
+        ++i;
+    }
+
+    if (ui->check_SpeedShowTX->isChecked())
+    {
+        //Show TX data in terminal
+        SpeedTestDisplayData(gbaSpeedSendBuffer);
+    }
+
+    gspSerialPort.write(gbaSpeedSendBuffer);
+    gintSpeedBufferCount += gbaSpeedSendBuffer.length();
+    gintSpeedTestStatPacketsSent += gintSpeedSendBufferPackets;
+}
+
+//=============================================================================
+//=============================================================================
+void
+MainWindow::SpeedTestVerifyPackets(
+    const char *pchData,
+    qint64 intLength
+    )
+{
+    //Checks received CRC32 packets. Data is appended to a preallocated buffer and only the unprocessed tail is kept between reads
+    gbaSpeedPacketBuffer.append(pchData, intLength);
+    const char *pchBuffer = gbaSpeedPacketBuffer.constData();
+    int intBufferLength = gbaSpeedPacketBuffer.length();
+    int intPosition = 0;
+    while (intBufferLength - intPosition >= SpeedTestPacketHeaderSize)
+    {
+        const uchar *pucPacket = (const uchar *)&pchBuffer[intPosition];
+        quint16 intPayloadLength = qFromLittleEndian<quint16>(pucPacket + 6);
+        if (pucPacket[0] != SpeedTestPacketMagic1 || pucPacket[1] != SpeedTestPacketMagic2 || intPayloadLength > SpeedTestPacketMaxPayload)
+        {
+            //Not at the start of a packet, only the first bad byte after a good packet is counted as an error
+            if (gbSpeedPacketSynced == true)
+            {
+                ++gintSpeedTestStatErrors;
+                ++gintSpeedTestStatPacketsReceived;
+                ++gintSpeedPacketCorrupt;
+                ++gintSpeedPacketCorruptPending;
+                gbSpeedPacketSynced = false;
+                if (ui->check_SpeedShowErrors->isChecked())
+                {
+                    //Show error
+                    SpeedTestDisplayData("\r\nError: Packet header not found, resynchronising.\r\n");
+                }
+            }
+
+            //Search for the next start byte
+            const char *pchStart = (const char *)memchr(&pchBuffer[intPosition + 1], (char)SpeedTestPacketMagic1, intBufferLength - intPosition - 1);
+            intPosition = (pchStart == NULL ? intBufferLength : pchStart - pchBuffer);
+            continue;
+        }
+
+        int intPacketLength = SpeedTestPacketHeaderSize + intPayloadLength + SpeedTestPacketCRCSize;
+        if (intBufferLength - intPosition < intPacketLength)
+        {
+            //Wait for the rest of the packet
+            break;
+        }
+
+        if (LrdCrc32::Calculate((const char *)pucPacket, intPacketLength - SpeedTestPacketCRCSize) != qFromLittleEndian<quint32>(pucPacket + intPacketLength - SpeedTestPacketCRCSize))
+        {
+            //Packet is corrupt, the length may also be wrong so resynchronise from the next byte. Whilst resynchronising this is most likely a false header inside another packet so is not counted again
+            if (gbSpeedPacketSynced == true)
+            {
+                ++gintSpeedTestStatErrors;
+                ++gintSpeedTestStatPacketsReceived;
+                ++gintSpeedPacketCorrupt;
+                ++gintSpeedPacketCorruptPending;
+                gbSpeedPacketSynced = false;
+                if (ui->check_SpeedShowErrors->isChecked())
+                {
+                    //Show error
+                    SpeedTestDisplayData("\r\nError: Packet CRC mismatch.\r\n");
+                }
+            }
+            ++intPosition;
+            continue;
+        }
+
+        //Valid packet
+        ++gintSpeedTestStatPacketsReceived;
+        gbSpeedPacketSynced = true;
+        SpeedTestPacketReceived(qFromLittleEndian<quint32>(pucPacket + 2));
+        intPosition += intPacketLength;
+    }
+
+    //Remove processed data
+    gbaSpeedPacketBuffer.remove(0, intPosition);
+}
+
+//=============================================================================
+//=============================================================================
+void
+MainWindow::SpeedTestPacketReceived(
+    quint32 intSequence
+    )
+{
+    //Updates the lost, duplicate and out of order counters for a valid packet
+    if (gbSpeedPacketFirst == true)
+    {
+        //First packet sets the expected sequence
+        gbSpeedPacketFirst = false;
+        gintSpeedPacketNextSequence = intSequence;
+    }
+
+    qint32 intDifference = (qint32)(intSequence - gintSpeedPacketNextSequence);
+    if (intDifference >= 0)
+    {
+        //In order (any skipped packets are lost unless they were already counted as corrupt)
+        quint64 intAbsorbed = ((quint64)intDifference > gintSpeedPacketCorruptPending ? gintSpeedPacketCorruptPending : (quint64)intDifference);
+        gintSpeedPacketLost += intDifference - intAbsorbed;
+
+        //Skipped sequence numbers have not been seen, the ones nearest this packet are taken to be the corrupt packets and the rest are marked as lost
+        quint32 intClear = (intDifference > SpeedTestPacketWindow ? intSequence - SpeedTestPacketWindow : gintSpeedPacketNextSequence);
+        while (intClear != intSequence)
+        {
+            quint64 intBit = ((quint64)1 << (intClear % 64));
+            gintSpeedPacketSeen[(intClear % SpeedTestPacketWindow)/64] &= ~intBit;
+            if ((quint64)(intSequence - intClear) > intAbsorbed)
+            {
+                gintSpeedPacketLostMap[(intClear % SpeedTestPacketWindow)/64] |= intBit;
+            }
+            else
+            {
+                gintSpeedPacketLostMap[(intClear % SpeedTestPacketWindow)/64] &= ~intBit;
+            }
+            ++intClear;
+        }
+        gintSpeedPacketSeen[(intSequence % SpeedTestPacketWindow)/64] |= ((quint64)1 << (intSequence % 64));
+        gintSpeedPacketNextSequence = intSequence + 1;
+        ++gintSpeedTestStatSuccess;
+    }
+    else if (-intDifference <= SpeedTestPacketWindow && (gintSpeedPacketSeen[(intSequence % SpeedTestPacketWindow)/64] & ((quint64)1 << (intSequence % 64))) != 0)
+    {
+        //Already received
+        ++gintSpeedPacketDuplicate;
+    }
+    else
+    {
+        //Late packet, only taken off the lost count if its sequence number was counted as lost rather than corrupt
+        ++gintSpeedPacketOutOfOrder;
+        ++gintSpeedTestStatSuccess;
+        if (-intDifference <= SpeedTestPacketWindow)
+        {
+            quint64 intBit = ((quint64)1 << (intSequence % 64));
+            if ((gintSpeedPacketLostMap[(intSequence % SpeedTestPacketWindow)/64] & intBit) != 0 && gintSpeedPacketLost > 0)
+            {
+                --gintSpeedPacketLost;
+            }
+            gintSpeedPacketLostMap[(intSequence % SpeedTestPacketWindow)/64] &= ~intBit;
+            gintSpeedPacketSeen[(intSequence % SpeedTestPacketWindow)/64] |= intBit;
+        }
+        else if (gintSpeedPacketLost > 0)
+        {
+            //Too old to know, assume it was counted as lost
+            --gintSpeedPacketLost;
+        }
+    }
+    gintSpeedPacketCorruptPending = 0;
+}
+
+//=============================================================================
+//=============================================================================
+void
+MainWindow::UpdateSpeedTestPacketValues(
+    )
+{
+    //Update packet error statistics
+    ui->edit_SpeedPacketLost->setText(QString::number(gintSpeedPacketLost));
+    ui->edit_SpeedPacketCorrupt->setText(QString::number(gintSpeedPacketCorrupt));
+    ui->edit_SpeedPacketDuplicate->setText(QString::number(gintSpeedPacketDuplicate));
+    ui->edit_SpeedPacketOutOfOrder->setText(QString::number(gintSpeedPacketOutOfOrder));
+}
+
+//=============================================================================
+//=============================================================================
+void
+MainWindow::UpdateSpeedTestPrbsValues(
+    )
+{
+    //Update PRBS bit error statistics
+    ui->edit_SpeedPrbsBits->setText(QString::number(gprbSpeedPrbs.BitsChecked()));
+    ui->edit_SpeedPrbsErrors->setText(QString::number(gprbSpeedPrbs.BitErrors()));
+    ui->edit_SpeedPrbsBER->setText(gprbSpeedPrbs.BitsChecked() == 0 ? QString("0") : QString::number((double)gprbSpeedPrbs.BitErrors()/(double)gprbSpeedPrbs.BitsChecked(), 'e', 2));
+    ui->edit_SpeedPrbsErroredSeconds->setText(QString::number(gprbSpeedPrbs.ErroredSeconds()));
+    ui->edit_SpeedPrbsSlips->setText(QString::number(gprbSpeedPrbs.BitSlips()));
+    ui->edit_SpeedPrbsSync->setText(gprbSpeedPrbs.IsLocked() == true ? "Locked" : "Searching");
+}
+
+//=============================================================================
+//=============================================================================
+void
+MainWindow::UpdateSpeedTestValues(
+    )
+{
+    //Update speed test statistics
+    unsigned long lngElapsed = gtmrSpeedTimer.nsecsElapsed()/1000000;
+    unsigned int intHours = (lngElapsed / 3600000);
+    unsigned char chMinutes = (lngElapsed / 60000) % 60;
+    unsigned char chSeconds = (lngElapsed % 60000) / 1000;
+    unsigned int intMiliseconds = (lngElapsed % 600)/10;
+    ui->label_SpeedTime->setText(QString((intHours < 10 ? "0" : "")).append(QString::number(intHours)).append((chMinutes < 10 ? ":0" : ":")).append(QString::number(chMinutes)).append((chSeconds < 10 ? ":0" : ":")).append(QString::number(chSeconds)).append((intMiliseconds < 10 ? ".0" : ".")).append(QString::number(intMiliseconds)));
+
+    if (gintSpeedBytesSent > 0)
+    {
+        //Update sent data
+        ui->label_SpeedTx->setText(QString::number(gintSpeedBytesSent));
+        ui->edit_SpeedBytesSent->setText(QString::number(gintSpeedBytesSent));
+        ui->edit_SpeedPacketsSent->setText(QString::number(gintSpeedTestStatPacketsSent));
+    }
+
+    if ((gchSpeedTestMode & SpeedModeRecv) == SpeedModeRecv)
+    {
+        //Receive mode active
+        ui->label_SpeedRx->setText(QString::number(gintSpeedBytesReceived));
         ui->edit_SpeedBytesRec->setText(QString::number(gintSpeedBytesReceived));
         ui->edit_SpeedPacketsRec->setText(QString::number(gintSpeedTestStatPacketsReceived));
         ui->edit_SpeedPacketsBad->setText(QString::number(gintSpeedTestStatErrors));
         ui->edit_SpeedPacketsGood->setText(QString::number(gintSpeedTestStatSuccess));
         if (gintSpeedTestStatErrors > 0)
         {
-            //Calculate error rate (up to 2 decimal places and rounding up)
-            ui->edit_SpeedPacketsErrorRate->setText(QString::number(std::ceil((float)gintSpeedTestStatErrors*10000.0/(float)(gintSpeedTestStatSuccess+gintSpeedTestStatErrors))/100.0));
+            //Calculate error rate (up to 2 decimal places and rounding up)
+            ui->edit_SpeedPacketsErrorRate->setText(QString::number(std::ceil((float)gintSpeedTestStatErrors*10000.0/(float)(gintSpeedTestStatSuccess+gintSpeedTestStatErrors))/100.0));
+        }
+    }
+
+    if (ui->combo_SpeedDataType->currentIndex() == SpeedDataTypeLatency)
+    {
+        if (gintSpeedLatencySentTime != -1 && (gtmrSpeedTimer.nsecsElapsed()/1000 - gintSpeedLatencySentTime) > SpeedTestLatencyTimeout*1000)
+        {
+            //Outstanding packet has not been returned in time, count it as lost and send another
+            ++gintSpeedLatencyTimeouts;
+            gintSpeedLatencySentTime = -1;
+            if ((gchSpeedTestMode & SpeedModeSend) == SpeedModeSend)
+            {
+                SpeedTestSendLatencyPacket();
+            }
+        }
+        UpdateSpeedTestLatencyValues();
+    }
+    else if (ui->combo_SpeedDataType->currentIndex() == SpeedDataTypePacket)
+    {
+        //Update packet error statistics
+        UpdateSpeedTestPacketValues();
+    }
+    else if (ui->combo_SpeedDataType->currentIndex() >= SpeedDataTypePRBS7)
+    {
+        //Update bit error statistics
+        UpdateSpeedTestPrbsValues();
+    }
+
+    //Record this interval in the time series
+    SpeedTestAddSample();
+}
+
+//=============================================================================
+//=============================================================================
+quint64
+MainWindow::SpeedTestErrorCount(
+    )
+{
+    //Returns the total number of errors detected for the current speed test data type
+    if (ui->combo_SpeedDataType->currentIndex() >= SpeedDataTypePRBS7)
+    {
+        //Bit errors
+        return gprbSpeedPrbs.BitErrors();
+    }
+    else if (ui->combo_SpeedDataType->currentIndex() == SpeedDataTypePacket)
+    {
+        //Bad packets and packets which never arrived
+        return gintSpeedTestStatErrors + gintSpeedPacketLost;
+    }
+    else if (ui->combo_SpeedDataType->currentIndex() == SpeedDataTypeLatency)
+    {
+        //Bad packets and packets which timed out
+        return gintSpeedTestStatErrors + gintSpeedLatencyTimeouts;
+    }
+    return gintSpeedTestStatErrors;
+}
+
+//=============================================================================
+//=============================================================================
+void
+MainWindow::SpeedTestAddSample(
+    )
+{
+    //Adds the activity since the previous sample to the speed test time series
+    qint64 intNow = gtmrSpeedTimer.elapsed();
+    qint64 intInterval = intNow - gintSpeedSeriesLastTime;
+    if (intInterval <= 0)
+    {
+        //No time has passed
+        return;
+    }
+
+    quint64 intErrors = SpeedTestErrorCount();
+    quint32 intValues[SpeedSeriesChannels];
+    intValues[SpeedSeriesRxBytes] = (quint32)((gintSpeedBytesReceived - gintSpeedSeriesLastRx)*1000/intInterval);
+    intValues[SpeedSeriesTxBytes] = (quint32)((gintSpeedBytesSent - gintSpeedSeriesLastTx)*1000/intInterval);
+    intValues[SpeedSeriesRxPackets] = (quint32)(gintSpeedTestStatPacketsReceived - gintSpeedSeriesLastPackets);
+    //The error count can go down when a packet counted as lost arrives late, that is not counted as negative errors
+    intValues[SpeedSeriesErrors] = (intErrors > gintSpeedSeriesLastErrors ? (quint32)(intErrors - gintSpeedSeriesLastErrors) : 0);
+    intValues[SpeedSeriesBufferBytes] = (quint32)gspSerialPort.bytesToWrite();
+    gtsSpeedSeries.Append((quint32)intNow, intValues);
+
+    gintSpeedSeriesLastRx = gintSpeedBytesReceived;
+    gintSpeedSeriesLastTx = gintSpeedBytesSent;
+    gintSpeedSeriesLastPackets = gintSpeedTestStatPacketsReceived;
+    gintSpeedSeriesLastErrors = intErrors;
+    gintSpeedSeriesLastTime = intNow;
+
+    if (ui->plot_Speed->isVisible())
+    {
+        //Redraw graph
+        ui->plot_Speed->update();
+    }
+}
+
+//=============================================================================
+//=============================================================================
+void
+MainWindow::SpeedTestBuildSendBuffer(
+    )
+{
+    //Builds the data that is sent for each chunk. When sending at a target rate, chunks are limited to the amount of data sent per token bucket update so that data is sent smoothly
+    quint32 intChunkSize = gintSpeedTestChunkSize;
+    if (gintSpeedRateLimit > 0)
+    {
+        intChunkSize = qBound((quint32)SpeedTestMinChunkSize, gintSpeedRateLimit*SpeedTestRateInterval/1000, gintSpeedTestChunkSize);
+    }
+
+    if (ui->combo_SpeedDataType->currentIndex() >= SpeedDataTypePRBS7)
+    {
+        //PRBS data is generated into the buffer for each chunk
+        gbaSpeedPrbsData.resize(intChunkSize);
+        gintSpeedTestMatchDataLength = intChunkSize;
+    }
+    else if (ui->combo_SpeedDataType->currentIndex() == SpeedDataTypeString || ui->combo_SpeedDataType->currentIndex() == SpeedDataTypePacket)
+    {
+        //Number of test strings/packets that fit in a chunk (at least one so that data larger than the chunk size is still sent)
+        gintSpeedSendBufferPackets = (intChunkSize > gintSpeedTestMatchDataLength ? intChunkSize / gintSpeedTestMatchDataLength : 1);
+        gbaSpeedSendBuffer.clear();
+        gbaSpeedSendBuffer.reserve(gintSpeedSendBufferPackets * gintSpeedTestMatchDataLength);
+
+        //Prebuild the chunk once: string chunks are then written as-is and packet chunks only have the sequence number and CRC of each packet updated in place
+        quint32 i = 0;
+        while (i < gintSpeedSendBufferPackets)
+        {
+            gbaSpeedSendBuffer.append(ui->combo_SpeedDataType->currentIndex() == SpeedDataTypePacket ? gbaSpeedPacket : gbaSpeedMatchData);
+            ++i;
+        }
+    }
+}
+
+//=============================================================================
+//=============================================================================
+void
+MainWindow::SpeedTestSetRate(
+    quint32 intRate
+    )
+{
+    //Changes the target send rate (in bytes per second) whilst a test is running
+    gintSpeedRateLimit = intRate;
+    SpeedTestBuildSendBuffer();
+    gdblSpeedRateTokens = 0;
+}
+
+//=============================================================================
+//=============================================================================
+void
+MainWindow::SpeedTestBeginSending(
+    )
+{
+    //Starts sending speed test data, either as fast as possible or at the target rate
+    if (gintSpeedRateLimit == 0)
+    {
+        //Data is sent each time the output buffer drains
+        SendSpeedTestData();
+        return;
+    }
+
+    //Data is sent from the rate timer, the first chunk is sent straight away
+    gdblSpeedRateTokens = (ui->combo_SpeedDataType->currentIndex() >= SpeedDataTypePRBS7 ? gbaSpeedPrbsData.length() : gbaSpeedSendBuffer.length());
+    gintSpeedRateLastTime = gtmrSpeedTimer.nsecsElapsed();
+    gtmrSpeedRateTimer.start();
+    SpeedTestRateTimer();
+}
+
+//=============================================================================
+//=============================================================================
+void
+MainWindow::SpeedTestRateTimer(
+    )
+{
+    //Token bucket update: tokens (bytes) are added at the target rate and a chunk is sent for each chunk's worth of tokens
+    if ((gchSpeedTestMode & SpeedModeSend) != SpeedModeSend)
+    {
+        //No longer sending
+        gtmrSpeedRateTimer.stop();
+        return;
+    }
+
+    qint64 intNow = gtmrSpeedTimer.nsecsElapsed();
+    gdblSpeedRateTokens += (double)gintSpeedRateLimit*(double)(intNow - gintSpeedRateLastTime)/1000000000.0;
+    gintSpeedRateLastTime = intNow;
+
+    //Limit the amount of data waiting to be sent so that a rate higher than the port can manage does not fill memory, tokens are capped to the same amount so bursts are limited
+    quint64 intChunkSize = (ui->combo_SpeedDataType->currentIndex() >= SpeedDataTypePRBS7 ? gbaSpeedPrbsData.length() : gbaSpeedSendBuffer.length());
+    quint64 intMaxQueue = qMax(intChunkSize*2, (quint64)gintSpeedRateLimit*SpeedTestRateMaxQueueTime/1000);
+    if (gdblSpeedRateTokens > intMaxQueue)
+    {
+        gdblSpeedRateTokens = intMaxQueue;
+    }
+
+    while (gdblSpeedRateTokens >= intChunkSize && gintSpeedBufferCount + intChunkSize <= intMaxQueue)
+    {
+        //Send a chunk
+        SendSpeedTestData();
+        gdblSpeedRateTokens -= intChunkSize;
+    }
+}
+
+//=============================================================================
+//=============================================================================
+void
+MainWindow::SpeedTestSweepTimer(
+    )
+{
+    //Rate sweep settle or hold period has elapsed
+    if (gbSpeedSweepRunning == false)
+    {
+        return;
+    }
+
+    if (gbSpeedSweepHolding == false)
+    {
+        //Settle time has elapsed (data sent at the previous rate has been flushed through), measure from now on
+        gintSpeedSweepErrors = SpeedTestErrorCount();
+        gintSpeedSweepReceived = gintSpeedBytesReceived;
+        gintSpeedSweepSent = gintSpeedBytesSent;
+        gbSpeedSweepHolding = true;
+        gtmrSpeedSweepTimer.start(SpeedTestSweepHoldTime);
+        return;
+    }
+
+    //A rate passes if no errors were detected and the target rate was both sent and received (within the tolerance)
+    //The error count can go down when a packet counted as lost before this step arrives late
+    quint64 intErrors = SpeedTestErrorCount();
+    intErrors = (intErrors > gintSpeedSweepErrors ? intErrors - gintSpeedSweepErrors : 0);
+    quint64 intSent = gintSpeedBytesSent - gintSpeedSweepSent;
+    quint64 intReceived = gintSpeedBytesReceived - gintSpeedSweepReceived;
+    quint64 intExpected = (quint64)gintSpeedRateLimit*SpeedTestSweepHoldTime/1000;
+    bool bPassed = (intErrors == 0 && intSent*100 >= intExpected*(100 - SpeedTestSweepTolerance) && intReceived*100 >= intSent*(100 - SpeedTestSweepTolerance));
+    gstrSpeedSweepSteps.append("\r\n    > ").append(QString::number(gintSpeedRateLimit)).append(" Bytes/s: ").append(bPassed == true ? QString("Pass") : QString("Fail (").append(QString::number(intErrors)).append(" errors, ").append(QString::number(intSent/(SpeedTestSweepHoldTime/1000))).append(" Bytes/s sent, ").append(QString::number(intReceived/(SpeedTestSweepHoldTime/1000))).append(" Bytes/s received)"));
+
+    if (bPassed == true)
+    {
+        gintSpeedSweepLow = gintSpeedRateLimit;
+    }
+    else
+    {
+        gintSpeedSweepHigh = gintSpeedRateLimit;
+    }
+
+    if ((quint64)(gintSpeedSweepHigh - gintSpeedSweepLow)*100 <= (quint64)gintSpeedSweepMax*SpeedTestSweepResolution)
+    {
+        //Search has finished, stop the test
+        gbSpeedSweepRunning = false;
+        gstrSpeedSweepResult = QString("Highest loss-free rate: ").append(QString::number(gintSpeedSweepLow)).append(" bytes/s.");
+        on_btn_SpeedStop_clicked();
+        return;
+    }
+
+    //Try the rate half way between the highest pass and lowest fail
+    gbSpeedSweepHolding = false;
+    SpeedTestSetRate(gintSpeedSweepLow + (gintSpeedSweepHigh - gintSpeedSweepLow)/2);
+    gtmrSpeedSweepTimer.start(SpeedTestSweepSettleTime);
+    ui->statusBar->showMessage(QString("Rate sweep: trying ").append(QString::number(gintSpeedRateLimit)).append(" bytes/s, highest loss-free rate so far: ").append(QString::number(gintSpeedSweepLow)).append(" bytes/s."));
+}
+
+//=============================================================================
+//=============================================================================
+void
+MainWindow::SpeedMatrixStart(
+    QString strBaudRates,
+    QString strDataTypes,
+    int intDuration,
+    bool bConfigure
+    )
+{
+    //Starts a baud rate matrix test: each data type is run at each baud rate for a fixed time
+    if (gbSpeedMatrixRunning == true || gbSpeedTestRunning == true || gbTermBusy == true || gbLoopbackMode == true)
+    {
+        //Cannot start
+        QString strMessage = tr("Error: Cannot start a baud rate matrix test whilst the terminal is busy, a speed test is running or loopback mode is enabled.");
+        gpmErrorForm->show();
+        gpmErrorForm->SetMessage(&strMessage);
+        return;
+    }
+
+    glstSpeedMatrixBauds.clear();
+    QStringList lstItems = strBaudRates.split(',', QString::SkipEmptyParts);
+    int i = 0;
+    while (i < lstItems.count())
+    {
+        //Check baud rates are numeric
+        if (lstItems[i].trimmed().toUInt() > 0)
+        {
+            glstSpeedMatrixBauds.append(lstItems[i].trimmed());
+        }
+        ++i;
+    }
+
+    //Data types can be given by index or by name (or the start of the name)
+    glstSpeedMatrixTypes.clear();
+    lstItems = (strDataTypes.isEmpty() ? QStringList(ui->combo_SpeedDataType->currentText()) : strDataTypes.split(',', QString::SkipEmptyParts));
+    i = 0;
+    while (i < lstItems.count())
+    {
+        QString strType = lstItems[i].trimmed();
+        bool bNumeric;
+        int intType = strType.toInt(&bNumeric);
+        if (bNumeric == false)
+        {
+            intType = ui->combo_SpeedDataType->findText(strType, Qt::MatchFixedString);
+            if (intType == -1)
+            {
+                intType = ui->combo_SpeedDataType->findText(strType, Qt::MatchStartsWith);
+            }
+        }
+        if (intType >= 0 && intType < ui->combo_SpeedDataType->count())
+        {
+            glstSpeedMatrixTypes.append(intType);
+        }
+        ++i;
+    }
+
+    if (glstSpeedMatrixBauds.count() == 0 || glstSpeedMatrixTypes.count() == 0 || intDuration <= 0)
+    {
+        //Nothing to test
+        QString strMessage = tr("Error: Baud rate matrix test requires at least one valid baud rate, one valid data type and a test time.");
+        gpmErrorForm->show();
+        gpmErrorForm->SetMessage(&strMessage);
+        if (gbSpeedMatrixExit == true)
+        {
+            //Exit is deferred as this can be called before the event loop is running
+            gbSpeedMatrixFailed = true;
+            QTimer::singleShot(0, this, SLOT(SpeedMatrixExit()));
+        }
+        return;
+    }
+
+    gintSpeedMatrixDuration = intDuration;
+    gbSpeedMatrixConfigure = bConfigure;
+    gbSpeedMatrixFailed = false;
+    gintSpeedMatrixBaudIndex = 0;
+    glstSpeedMatrixResults.clear();
+    glstSpeedMatrixResults.append("baud,data_type,duration_s,tx_bytes,rx_bytes,tx_avg_bytes_per_s,rx_avg_bytes_per_s,errors,rx_link_utilisation_percent,status");
+    gbSpeedMatrixRunning = true;
+    SpeedMatrixNextBaud();
+}
+
+//=============================================================================
+//=============================================================================
+void
+MainWindow::SpeedMatrixNextBaud(
+    )
+{
+    //Moves the baud rate matrix test on to the next baud rate
+    if (gintSpeedMatrixBaudIndex >= glstSpeedMatrixBauds.count())
+    {
+        //All baud rates have been tested
+        SpeedMatrixFinish();
+        return;
+    }
+
+    gintSpeedMatrixTypeIndex = 0;
+    if (gspSerialPort.isOpen() == false)
+    {
+        //Open the port at the current baud rate so the module can be configured
+        OpenDevice();
+    }
+
+    if (gspSerialPort.isOpen() == true && ui->combo_Baud->currentText() == glstSpeedMatrixBauds[gintSpeedMatrixBaudIndex])
+    {
+        //Already at this baud rate
+        gchSpeedMatrixStage = SpeedMatrixStageOpen;
+        gtmrSpeedMatrixTimer.start(SpeedMatrixCommandTime);
+    }
+    else if (gspSerialPort.isOpen() == true && gbSpeedMatrixConfigure == true)
+    {
+        //Change the module baud rate
+        QByteArray baTmpBA = QString("AT+CFG 520 ").append(glstSpeedMatrixBauds[gintSpeedMatrixBaudIndex]).toUtf8();
+        gspSerialPort.write(baTmpBA);
+        gintQueuedTXBytes += baTmpBA.size();
+        DoLineEnd();
+        gchSpeedMatrixStage = SpeedMatrixStageConfigure;
+        gtmrSpeedMatrixTimer.start(SpeedMatrixCommandTime);
+    }
+    else
+    {
+        //Module does not need to be configured
+        SpeedMatrixReopen();
+    }
+    ui->statusBar->showMessage(QString("Baud rate matrix test: changing to ").append(glstSpeedMatrixBauds[gintSpeedMatrixBaudIndex]).append(" baud..."));
+}
+
+//=============================================================================
+//=============================================================================
+void
+MainWindow::SpeedMatrixReopen(
+    )
+{
+    //Reopens the port at the baud rate being tested
+    ui->combo_Baud->setCurrentText(glstSpeedMatrixBauds[gintSpeedMatrixBaudIndex]);
+    OpenDevice();
+    if (gspSerialPort.isOpen() == false || ui->combo_Baud->currentText() != glstSpeedMatrixBauds[gintSpeedMatrixBaudIndex])
+    {
+        //Port failed to open (or baud rate is not supported), record all data types at this baud rate as failed
+        while (gintSpeedMatrixTypeIndex < glstSpeedMatrixTypes.count())
+        {
+            SpeedMatrixRecordResult("port open failed");
+            ++gintSpeedMatrixTypeIndex;
+        }
+        ++gintSpeedMatrixBaudIndex;
+        SpeedMatrixNextBaud();
+        return;
+    }
+
+    //Wait for the module to be ready
+    gchSpeedMatrixStage = SpeedMatrixStageOpen;
+    gtmrSpeedMatrixTimer.start(SpeedMatrixResetTime);
+}
+
+//=============================================================================
+//=============================================================================
+void
+MainWindow::SpeedMatrixStartRun(
+    )
+{
+    //Starts the next data type at the current baud rate
+    while (gintSpeedMatrixTypeIndex < glstSpeedMatrixTypes.count())
+    {
+        //Select the data type, throughput only tests can only receive
+        ui->combo_SpeedDataType->setCurrentIndex(glstSpeedMatrixTypes[gintSpeedMatrixTypeIndex]);
+        QAction *qaAction = (gpSpeedMenu->actions()[2]->isEnabled() == true ? gpSpeedMenu->actions()[2] : gpSpeedMenu->actions()[0]);
+        SpeedMenuSelected(qaAction);
+        if (gbSpeedTestRunning == true)
+        {
+            //Test has started, stop it once the test time has elapsed
+            gchSpeedMatrixStage = SpeedMatrixStageRun;
+            gtmrSpeedMatrixTimer.start(gintSpeedMatrixDuration*1000);
+            ui->statusBar->showMessage(QString("Baud rate matrix test: running ").append(ui->combo_SpeedDataType->currentText()).append(" at ").append(glstSpeedMatrixBauds[gintSpeedMatrixBaudIndex]).append(" baud (").append(QString::number(gintSpeedMatrixBaudIndex*glstSpeedMatrixTypes.count() + gintSpeedMatrixTypeIndex + 1)).append(" of ").append(QString::number(glstSpeedMatrixBauds.count()*glstSpeedMatrixTypes.count())).append(")..."));
+            return;
+        }
+
+        //Test could not be started
+        SpeedMatrixRecordResult("start failed");
+        ++gintSpeedMatrixTypeIndex;
+    }
+
+    //All data types have been tested at this baud rate
+    ++gintSpeedMatrixBaudIndex;
+    SpeedMatrixNextBaud();
+}
+
+//=============================================================================
+//=============================================================================
+void
+MainWindow::SpeedMatrixTimer(
+    )
+{
+    //Baud rate matrix test stage timer has elapsed
+    if (gbSpeedMatrixRunning == false)
+    {
+        return;
+    }
+
+    if (gchSpeedMatrixStage == SpeedMatrixStageConfigure)
+    {
+        //Module has been given the new baud rate, reset it so that it is used
+        QByteArray baTmpBA = "ATZ";
+        gspSerialPort.write(baTmpBA);
+        gintQueuedTXBytes += baTmpBA.size();
+        DoLineEnd();
+        gchSpeedMatrixStage = SpeedMatrixStageReset;
+        gtmrSpeedMatrixTimer.start(SpeedMatrixResetTime);
+    }
+    else if (gchSpeedMatrixStage == SpeedMatrixStageReset)
+    {
+        //Module has reset
+        SpeedMatrixReopen();
+    }
+    else if (gchSpeedMatrixStage == SpeedMatrixStageOpen)
+    {
+        //Module is ready
+        SpeedMatrixStartRun();
+    }
+    else if (gchSpeedMatrixStage == SpeedMatrixStageRun)
+    {
+        //Test time has elapsed, stop the test (this waits for outstanding data)
+        gchSpeedMatrixStage = SpeedMatrixStageWait;
+        if (gbSpeedTestRunning == true)
+        {
+            on_btn_SpeedStop_clicked();
+        }
+        gtmrSpeedMatrixTimer.start(SpeedMatrixPollTime);
+    }
+    else if (gchSpeedMatrixStage == SpeedMatrixStageWait)
+    {
+        if (gbSpeedTestRunning == true)
+        {
+            //Test is still stopping
+            gtmrSpeedMatrixTimer.start(SpeedMatrixPollTime);
+            return;
+        }
+
+        //Test has finished
+        SpeedMatrixRecordResult(gspSerialPort.isOpen() == true ? "ok" : "port closed");
+        ++gintSpeedMatrixTypeIndex;
+        if (gintSpeedMatrixBaudIndex >= glstSpeedMatrixBauds.count())
+        {
+            //Cancelled
+            SpeedMatrixFinish();
+        }
+        else if (gspSerialPort.isOpen() == false)
+        {
+            //Port has been closed, try to reopen it for the remaining data types
+            SpeedMatrixReopen();
+        }
+        else
+        {
+            //Next data type
+            SpeedMatrixStartRun();
+        }
+    }
+}
+
+//=============================================================================
+//=============================================================================
+void
+MainWindow::SpeedMatrixRecordResult(
+    QString strStatus
+    )
+{
+    //Adds the result of the current baud rate matrix test to the results
+    if (strStatus != "ok")
+    {
+        gbSpeedMatrixFailed = true;
+    }
+
+    quint32 intBaud = glstSpeedMatrixBauds[gintSpeedMatrixBaudIndex < glstSpeedMatrixBauds.count() ? gintSpeedMatrixBaudIndex : glstSpeedMatrixBauds.count()-1].toUInt();
+    bool bRan = (strStatus == "ok" || strStatus == "port closed");
+    quint64 intRxAvg = (bRan == true ? ui->edit_SpeedBytesRecAvg->text().toULongLong() : 0);
+
+    //Utilisation assumes 10 bits per character (8N1)
+    glstSpeedMatrixResults.append(QString::number(intBaud).append(",").
+        append(ui->combo_SpeedDataType->itemText(glstSpeedMatrixTypes[gintSpeedMatrixTypeIndex])).append(",").
+        append(QString::number(gintSpeedMatrixDuration)).append(",").
+        append(QString::number(bRan == true ? gintSpeedBytesSent : 0)).append(",").
+        append(QString::number(bRan == true ? gintSpeedBytesReceived : 0)).append(",").
+        append(QString::number(bRan == true ? ui->edit_SpeedBytesSentAvg->text().toULongLong() : 0)).append(",").
+        append(QString::number(intRxAvg)).append(",").
+        append(QString::number(bRan == true ? SpeedTestErrorCount() : 0)).append(",").
+        append(QString::number(intBaud > 0 ? (double)intRxAvg*1000.0/(double)intBaud : 0.0, 'f', 1)).append(",").
+        append(strStatus));
+}
+
+//=============================================================================
+//=============================================================================
+void
+MainWindow::SpeedMatrixFinish(
+    )
+{
+    //Baud rate matrix test has finished, output the combined results table
+    gbSpeedMatrixRunning = false;
+    gtmrSpeedMatrixTimer.stop();
+
+    QString strTable = QString("=================================\r\n  UwTerminalX ").append(UwVersion).append(" Baud Rate Matrix Test\r\n       ").append(QDate::currentDate().toString("dd/MM/yyyy")).append(" @ ").append(QTime::currentTime().toString("hh:mm")).append("\r\n---------------------------------\r\n");
+    int i = 0;
+    while (i < glstSpeedMatrixResults.count())
+    {
+        //Align each column
+        QStringList lstColumns = glstSpeedMatrixResults[i].split(',');
+        int j = 0;
+        while (j < lstColumns.count())
+        {
+            strTable.append(j == 1 || j == lstColumns.count()-1 ? lstColumns[j].leftJustified(16) : lstColumns[j].rightJustified(j == 0 ? 8 : 12)).append(" ");
+            ++j;
+        }
+        strTable.append("\r\n");
+        ++i;
+    }
+    strTable.append("=================================\r\n");
+
+    ui->text_SpeedEditData->append(strTable);
+    QApplication::clipboard()->setText(strTable);
+
+    if (!gstrSpeedMatrixOutput.isEmpty())
+    {
+        //Write results to file
+        QFile fileOutput(gstrSpeedMatrixOutput);
+        if (fileOutput.open(QIODevice::WriteOnly | QIODevice::Truncate | QIODevice::Text))
+        {
+            fileOutput.write(glstSpeedMatrixResults.join("\n").append("\n").toUtf8());
+            fileOutput.close();
         }
+        else
+        {
+            gbSpeedMatrixFailed = true;
+        }
+    }
+
+    ui->statusBar->showMessage(QString("Baud rate matrix test finished").append(gbSpeedMatrixFailed == true ? " (some tests failed)" : "").append(", results have been copied to the clipboard."));
+
+    if (gbSpeedMatrixExit == true)
+    {
+        //Unattended run from the command line, all baud rates can fail to open before the event loop is running so the exit is deferred
+        QTimer::singleShot(0, this, SLOT(SpeedMatrixExit()));
+    }
+}
+
+//=============================================================================
+//=============================================================================
+void
+MainWindow::SpeedMatrixExit(
+    )
+{
+    //Exits after an unattended baud rate matrix test, from the event loop
+    QApplication::exit(gbSpeedMatrixFailed == true ? 1 : 0);
+}
+
+//=============================================================================
+//=============================================================================
+void
+MainWindow::on_check_SpeedGraph_stateChanged(
+    int
+    )
+{
+    //Switch between the speed test data view and the graph
+    ui->plot_Speed->setVisible(ui->check_SpeedGraph->isChecked());
+    ui->text_SpeedEditData->setVisible(!ui->check_SpeedGraph->isChecked());
+}
+
+//=============================================================================
+//=============================================================================
+void
+MainWindow::on_btn_SpeedExport_clicked(
+    )
+{
+    //Export the speed test time series to a CSV or JSON file
+    if (gtsSpeedSeries.Count() == 0)
+    {
+        //Nothing to export
+        QString strMessage = tr("Error: No speed test samples have been recorded.");
+        gpmErrorForm->show();
+        gpmErrorForm->SetMessage(&strMessage);
+        return;
+    }
+
+    QString strSelectedFilter;
+    QString strFilename = QFileDialog::getSaveFileName(this, tr("Export Speed Test Samples"), gstrLastFilename[FilenameIndexOthers], tr("CSV Files (*.csv);;JSON Files (*.json);;All Files (*.*)"), &strSelectedFilter);
+    if (strFilename.isEmpty())
+    {
+        //No file selected
+        return;
+    }
+
+    //Update last directory
+    gstrLastFilename[FilenameIndexOthers] = strFilename;
+    gpTermSettings->setValue("LastOtherFileDirectory", SplitFilePath(strFilename)[0]);
+
+    bool bSuccess;
+    if (strFilename.endsWith(".json", Qt::CaseInsensitive) || (strSelectedFilter.startsWith("JSON") && !strFilename.endsWith(".csv", Qt::CaseInsensitive)))
+    {
+        //JSON export, include the test settings with the samples
+        QJsonObject objInfo;
+        objInfo.insert("application", QString("UwTerminalX ").append(UwVersion));
+        objInfo.insert("date", QDateTime::currentDateTime().toString(Qt::ISODate));
+        objInfo.insert("port", ui->label_SpeedConn->text());
+        objInfo.insert("data_type", ui->combo_SpeedDataType->currentText());
+        objInfo.insert("interval_ms", SpeedTestStatUpdateTime);
+        bSuccess = gtsSpeedSeries.ExportJSON(strFilename, objInfo);
+    }
+    else
+    {
+        //CSV export
+        bSuccess = gtsSpeedSeries.ExportCSV(strFilename);
+    }
+
+    if (bSuccess == false)
+    {
+        //Failed to write file
+        QString strMessage = tr("Error: Unable to write to file ").append(strFilename);
+        gpmErrorForm->show();
+        gpmErrorForm->SetMessage(&strMessage);
+    }
+    else
+    {
+        ui->statusBar->showMessage(QString("Exported ").append(QString::number(gtsSpeedSeries.Count())).append(" speed test samples."));
     }
 }
 
@@ -7157,7 +8691,7 @@ MainWindow::SpeedTestStartTimer(
     disconnect(gtmrSpeedTestDelayTimer, SIGNAL(timeout()), this, SLOT(SpeedTestStartTimer()));
     delete gtmrSpeedTestDelayTimer;
     gtmrSpeedTestDelayTimer = 0;
-    SendSpeedTestData(SpeedTestChunkSize);
+    SpeedTestBeginSending();
 }
 
 //=============================================================================
@@ -7173,7 +8707,8 @@ MainWindow::SpeedTestStopTimer(
     ui->btn_SpeedStop->setEnabled(false);
     ui->btn_SpeedStart->setEnabled(true);
     ui->combo_SpeedDataType->setEnabled(true);
-    if (ui->combo_SpeedDataType->currentIndex() == 1)
+    ui->spin_SpeedRate->setEnabled(true);
+    if (ui->combo_SpeedDataType->currentIndex() == SpeedDataTypeString || ui->combo_SpeedDataType->currentIndex() == SpeedDataTypeLatency || ui->combo_SpeedDataType->currentIndex() == SpeedDataTypePacket)
     {
         //Enable string options
         ui->edit_SpeedTestData->setEnabled(true);
@@ -7202,13 +8737,24 @@ MainWindow::SpeedTestStopTimer(
         //Stop 10 second stats update timer
         gtmrSpeedTestStats10s.stop();
     }
+    if (gtmrSpeedRateTimer.isActive())
+    {
+        //Stop target rate send timer
+        gtmrSpeedRateTimer.stop();
+    }
+    if (gtmrSpeedSweepTimer.isActive())
+    {
+        //Stop rate sweep
+        gtmrSpeedSweepTimer.stop();
+    }
+    gbSpeedSweepRunning = false;
 
     //Clear buffers
     gbaSpeedMatchData.clear();
-    gbaSpeedReceivedData.clear();
+    gdvSpeedVerifier.SetMatchData(QByteArray());
 
     //Show finished message in status bar
-    ui->statusBar->showMessage("Speed testing finished.");
+    ui->statusBar->showMessage(QString("Speed testing finished. ").append(gstrSpeedSweepResult));
 }
 
 //=============================================================================
@@ -7230,12 +8776,28 @@ MainWindow::OutputSpeedTestAvgStats(
     {
         //Receiving active
         ui->edit_SpeedBytesRecAvg->setText(QString::number(gintSpeedBytesReceived/lngElapsed));
-        if (ui->combo_SpeedDataType->currentIndex() != 0)
+        if (ui->combo_SpeedDataType->currentIndex() != SpeedDataTypeSpeed && ui->combo_SpeedDataType->currentIndex() < SpeedDataTypePRBS7)
         {
             //Show stats about packets
             ui->edit_SpeedPacketsRecAvg->setText(QString::number(gintSpeedBytesReceived/gintSpeedTestMatchDataLength/lngElapsed));
         }
     }
+
+    if (ui->combo_SpeedDataType->currentIndex() == SpeedDataTypeLatency)
+    {
+        //Update latency statistics
+        UpdateSpeedTestLatencyValues();
+    }
+    else if (ui->combo_SpeedDataType->currentIndex() == SpeedDataTypePacket)
+    {
+        //Update packet error statistics
+        UpdateSpeedTestPacketValues();
+    }
+    else if (ui->combo_SpeedDataType->currentIndex() >= SpeedDataTypePRBS7)
+    {
+        //Update bit error statistics
+        UpdateSpeedTestPrbsValues();
+    }
 }
 
 //=============================================================================
@@ -7265,6 +8827,15 @@ MainWindow::UpdateDisplayText(
     ui->text_SpeedEditData->moveCursor(QTextCursor::End);
     ui->text_SpeedEditData->insertPlainText(gbaSpeedDisplayBuffer);
 
+    if (ui->text_SpeedEditData->document()->characterCount() > SpeedDisplayMaxSize)
+    {
+        //Only keep the most recent data on the display
+        QTextCursor tcTrim(ui->text_SpeedEditData->document());
+        tcTrim.movePosition(QTextCursor::Start);
+        tcTrim.movePosition(QTextCursor::NextCharacter, QTextCursor::KeepAnchor, ui->text_SpeedEditData->document()->characterCount() - SpeedDisplayTrimSize);
+        tcTrim.removeSelectedText();
+    }
+
     //Go back to previous position
     if (Pos == 65535)
     {
@@ -7283,6 +8854,194 @@ MainWindow::UpdateDisplayText(
 
     //Clear the buffer
     gbaSpeedDisplayBuffer.clear();
+
+    if (gintSpeedDisplayDropped > 0)
+    {
+        //Show how much data the display has skipped
+        ui->label_SpeedDisplayDropped->setText(QString("Display dropped ").append(QString::number(gintSpeedDisplayDropped)).append(" bytes"));
+    }
+}
+
+//=============================================================================
+//=============================================================================
+void
+MainWindow::SpeedTestDisplayData(
+    const QByteArray &baData
+    )
+{
+    //Queues data for the speed test display. If the display has not caught up with the data already queued the new data is dropped from the display only, so updating the display never holds up the test
+    if (gbaSpeedDisplayBuffer.length() + baData.length() > SpeedDisplayMaxPending)
+    {
+        //Display cannot keep up
+        gintSpeedDisplayDropped += baData.length();
+    }
+    else
+    {
+        gbaSpeedDisplayBuffer.append(baData);
+    }
+
+    if (!gtmrSpeedUpdateTimer.isActive())
+    {
+        gtmrSpeedUpdateTimer.start();
+    }
+}
+
+//=============================================================================
+//=============================================================================
+void
+MainWindow::on_check_LogIndex_stateChanged(
+    int
+    )
+{
+    //Log indexing enabled/disabled
+    gpTermSettings->setValue("LogIndexEnable", (ui->check_LogIndex->isChecked() == true ? 1 : 0));
+    ui->edit_LogSearch->setEnabled(ui->check_LogIndex->isChecked());
+    ui->btn_LogSearch->setEnabled(ui->check_LogIndex->isChecked());
+    if (ui->check_LogIndex->isChecked() == true)
+    {
+        //Index the current directory and check for new data periodically
+        gtmrLogIndexTimer.start();
+        UpdateLogIndex();
+    }
+    else
+    {
+        //Stop checking for new data and hide any previous results
+        gtmrLogIndexTimer.stop();
+        ui->list_LogSearch->clear();
+        ui->list_LogSearch->hide();
+        ui->label_LogIndexStatus->clear();
+    }
+}
+
+//=============================================================================
+//=============================================================================
+void
+MainWindow::UpdateLogIndex(
+    )
+{
+    //Request that the log index thread brings the index up to date
+    if (ui->check_LogIndex->isChecked() == true && !gstrLogDirectory.isEmpty())
+    {
+        QMetaObject::invokeMethod(gpLogIndex, "SetDirectory", Qt::QueuedConnection, Q_ARG(QString, gstrLogDirectory));
+    }
+}
+
+//=============================================================================
+//=============================================================================
+void
+MainWindow::on_btn_LogSearch_clicked(
+    )
+{
+    //Search the log index
+    QString strQuery = ui->edit_LogSearch->text();
+    if (strQuery.toUtf8().length() < 3)
+    {
+        //Search string is too short to use the index
+        ui->label_LogIndexStatus->setText("Search must be at least 3 characters.");
+        return;
+    }
+    ui->label_LogIndexStatus->setText("Searching...");
+    QMetaObject::invokeMethod(gpLogIndex, "Search", Qt::QueuedConnection, Q_ARG(QString, strQuery));
+}
+
+//=============================================================================
+//=============================================================================
+void
+MainWindow::on_edit_LogSearch_returnPressed(
+    )
+{
+    //Enter pressed in search box
+    on_btn_LogSearch_clicked();
+}
+
+//=============================================================================
+//=============================================================================
+void
+MainWindow::LogIndexStatus(
+    QString strStatus
+    )
+{
+    //Status update from log index thread
+    ui->label_LogIndexStatus->setText(strStatus);
+}
+
+//=============================================================================
+//=============================================================================
+void
+MainWindow::LogIndexSearchFinished(
+    QString strQuery,
+    QList<LrdLogIndexHit> lstHits,
+    qint64 intElapsedUs
+    )
+{
+    //Search results received from log index thread
+    if (ui->check_LogIndex->isChecked() == false || strQuery != ui->edit_LogSearch->text())
+    {
+        //Indexing has been disabled or the search text has changed since the search was requested
+        return;
+    }
+
+    ui->list_LogSearch->clear();
+    int i = 0;
+    while (i < lstHits.count())
+    {
+        //Add hit to list
+        QListWidgetItem *lwiItem = new QListWidgetItem(QString(lstHits.at(i).strFilename).append(" @ ").append(QString::number(lstHits.at(i).intOffset)).append(": ").append(lstHits.at(i).strPreview));
+        lwiItem->setData(Qt::UserRole, lstHits.at(i).strFilename);
+        lwiItem->setData(Qt::UserRole + 1, lstHits.at(i).intOffset);
+        ui->list_LogSearch->addItem(lwiItem);
+        ++i;
+    }
+    ui->list_LogSearch->setVisible(lstHits.count() > 0);
+    ui->label_LogIndexStatus->setText(QString::number(lstHits.count()).append(lstHits.count() >= LogIndexMaxHits ? "+ hits" : " hits").append(" in ").append(QString::number((double)intElapsedUs/1000.0, 'f', 2)).append("ms"));
+}
+
+//=============================================================================
+//=============================================================================
+void
+MainWindow::on_list_LogSearch_itemDoubleClicked(
+    QListWidgetItem *lwiItem
+    )
+{
+    //Open the log file containing the hit and move to the offset
+    QString strFilename = lwiItem->data(Qt::UserRole).toString();
+    qint64 intOffset = lwiItem->data(Qt::UserRole + 1).toLongLong();
+    int intIndex = ui->combo_LogFile->findText(strFilename);
+    if (intIndex == -1)
+    {
+        //File is not in the list, refresh it
+        on_btn_LogRefresh_clicked();
+        intIndex = ui->combo_LogFile->findText(strFilename);
+        if (intIndex == -1)
+        {
+            //Log file no longer exists
+            ui->label_LogIndexStatus->setText("Log file no longer exists.");
+            return;
+        }
+    }
+
+    if (ui->combo_LogFile->currentIndex() == intIndex)
+    {
+        //Already selected, reload to show the latest data
+        on_combo_LogFile_currentIndexChanged(intIndex);
+    }
+    else
+    {
+        ui->combo_LogFile->setCurrentIndex(intIndex);
+    }
+
+    //Convert the byte offset to a character position in the loaded text
+    QFile fileLogFile(QString(gstrLogDirectory).append("/").append(strFilename));
+    if (fileLogFile.open(QFile::ReadOnly))
+    {
+        int intPosition = QString::fromUtf8(fileLogFile.read(intOffset)).remove('\r').length();
+        fileLogFile.close();
+        QTextCursor tcTmpCur = ui->text_LogData->textCursor();
+        tcTmpCur.setPosition(intPosition < ui->text_LogData->document()->characterCount() ? intPosition : ui->text_LogData->document()->characterCount() - 1);
+        ui->text_LogData->setTextCursor(tcTmpCur);
+        ui->text_LogData->centerCursor();
+        ui->text_LogData->setFocus();
+    }
 }
 
 /******************************************************************************/
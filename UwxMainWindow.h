@@ -57,14 +57,27 @@
 #include <QUrl>
 #include <QFileInfo>
 #include <QHostInfo>
+#include <QThread>
+#include <QListWidgetItem>
+#include <QtEndian>
+#include <QInputDialog>
 //Need cmath for std::ceil function
 #include <cmath>
+#include <cstring>
 #if TARGET_OS_MAC
 #include "QStandardPaths"
 #endif
 #include "LrdScrollEdit.h"
 #include "UwxPopup.h"
 #include "LrdLogger.h"
+#include "LrdLogIndex.h"
+#include "LrdHistogram.h"
+#include "LrdCrc32.h"
+#include "LrdPrbs.h"
+#include "LrdDataVerifier.h"
+#include "LrdTimeSeries.h"
+#include "LrdSeriesPlot.h"
+#include "LrdScriptRecorder.h"
 #if SKIPAUTOMATIONFORM != 1
 #include "UwxAutomation.h"
 #endif
@@ -107,6 +120,7 @@
 #define ModuleTimeout                     4000    //Time (in ms) that a download stage command/process times out (module)
 #define MaxDevNameSize                    8       //Size (in characters) to allow for a module device name (characters past this point will be chopped off)
 #define AutoBaudTimeout                   1200    //Time (in ms) to wait before checking the next baud rate when automatically detecting the module's baud rate
+#define LogIndexUpdateInterval            30000   //Time (in ms) between checking for new log data when log indexing is enabled
 //Defines for default config values
 #define DefaultLogFile                    "UwTerminalX.log"
 #define DefaultLogMode                    0
@@ -127,6 +141,9 @@
 #define DefaultShowFileSize               1
 #define DefaultConfirmClear               1
 #define DefaultShiftEnterLineSeparator    1
+#define DefaultLogIndexEnable             0
+#define DefaultSpeedTestChunkSize         512
+#define DefaultSpeedTestLowWater          128
 //Define the protocol
 #ifndef UseSSL
     //HTTP
@@ -166,6 +183,7 @@
 #define MenuActionCopyAll                 28
 #define MenuActionPaste                   29
 #define MenuActionSelectAll               30
+#define MenuActionRecordScript            31
 //Defines for balloon (notification area) icon options
 #define BalloonActionShow                 1
 #define BalloonActionExit                 2
@@ -176,10 +194,20 @@
 #define SpeedMenuActionSendRecv5Delay     4
 #define SpeedMenuActionSendRecv10Delay    5
 #define SpeedMenuActionSendRecv15Delay    6
+#define SpeedMenuActionSendRecvSweep      7
+#define SpeedMenuActionMatrix             8
 #define SpeedModeInactive                 0b00
 #define SpeedModeRecv                     0b01
 #define SpeedModeSend                     0b10
 #define SpeedModeSendRecv                 0b11
+#define SpeedDataTypeSpeed                0    //Throughput only speed test
+#define SpeedDataTypeString               1    //String matching speed test
+#define SpeedDataTypeLatency              2    //Round-trip latency speed test
+#define SpeedDataTypePacket               3    //Sequence numbered CRC32 packet speed test
+#define SpeedDataTypePRBS7                4    //PRBS7 bit error rate speed test
+#define SpeedDataTypePRBS15               5    //PRBS15 bit error rate speed test
+#define SpeedDataTypePRBS23               6    //PRBS23 bit error rate speed test
+#define SpeedDataTypePRBS31               7    //PRBS31 bit error rate speed test
 //Defines for the selector tab
 #define TabTerminal                       0
 #define TabConfig                         1
@@ -189,9 +217,44 @@
 #define TabLogs                           5
 #define TabEditor                         6
 //Defines for speed testing
-#define SpeedTestChunkSize                512  //Maximum number of bytes to send per chunk when speed testing
-#define SpeedTestMinBufSize               128  //Minimum buffer size when speed testing, when there are less than this number of bytes in the output buffer it will be topped up
+#define SpeedTestMinChunkSize             16   //Minimum configurable number of bytes to send per chunk when speed testing
+#define SpeedTestMaxChunkSize             1048576 //Maximum configurable number of bytes to send per chunk when speed testing
+#define SpeedDisplayMaxPending            65536 //Maximum size (in bytes) of data waiting to be shown on the speed test display, further display data is dropped until the display catches up
+#define SpeedDisplayMaxSize               524288 //Maximum number of characters kept on the speed test display (older data is removed)
+#define SpeedDisplayTrimSize              393216 //Number of characters the speed test display is trimmed down to once it exceeds the maximum size
+#define SpeedTestRateInterval             10   //Time (in ms) between token bucket updates when sending at a target rate
+#define SpeedTestRateMaxQueueTime         50   //Maximum amount of data (in ms at the target rate) allowed to wait in the output buffer when sending at a target rate
+#define SpeedTestSweepSettleTime          3000 //Time (in ms) to wait after changing the rate in a rate sweep before errors are counted
+#define SpeedTestSweepHoldTime            10000 //Time (in ms) each rate is held for in a rate sweep
+#define SpeedTestSweepResolution          2    //Rate sweep finishes once the highest passing and lowest failing rates are within this percentage of the starting rate
+#define SpeedTestSweepTolerance           5    //Percentage of the target rate that may be missing (not sent or not received) in a rate sweep step before it fails
+#define SpeedMatrixDefaultDuration        30   //Default time (in seconds) to run each test for in a baud rate matrix test
+#define SpeedMatrixCommandTime            1000 //Time (in ms) to wait for the module to process a configuration command in a baud rate matrix test
+#define SpeedMatrixResetTime              2000 //Time (in ms) to wait for the module to restart after a reset or port reopen in a baud rate matrix test
+#define SpeedMatrixPollTime               500  //Time (in ms) between checks for a stopping test to finish in a baud rate matrix test
+#define SpeedMatrixStageConfigure         1    //Baud rate matrix stage: waiting for the module to accept the new baud rate (AT+CFG 520)
+#define SpeedMatrixStageReset             2    //Baud rate matrix stage: waiting for the module to reset (ATZ)
+#define SpeedMatrixStageOpen              3    //Baud rate matrix stage: port opened at the new baud rate, waiting for the module to be ready
+#define SpeedMatrixStageRun               4    //Baud rate matrix stage: test running
+#define SpeedMatrixStageWait              5    //Baud rate matrix stage: waiting for the test to stop
 #define SpeedTestStatUpdateTime           500  //Time (in ms) between status updates for speed test mode
+#define SpeedTestReceiveBufferSize        16384 //Size (in bytes) of the fixed buffer that received data is read into when speed testing
+#define SpeedTestLatencyMagic1            0xA5 //First byte of a latency speed test packet
+#define SpeedTestLatencyMagic2            0x5A //Second byte of a latency speed test packet
+#define SpeedTestLatencyHeaderSize        14   //Size of latency speed test packet header: magic (2 bytes), sequence number (4 bytes), send time in us (8 bytes)
+#define SpeedTestLatencyTimeout           2000 //Time (in ms) to wait for a latency speed test packet to be returned before it is counted as lost
+#define SpeedTestPacketMagic1             0xF5 //First byte of a CRC32 speed test packet (never present in UTF-8 text)
+#define SpeedTestPacketMagic2             0x50 //Second byte of a CRC32 speed test packet
+#define SpeedTestPacketHeaderSize         8    //Size of CRC32 speed test packet header: magic (2 bytes), sequence number (4 bytes), payload length (2 bytes)
+#define SpeedTestPacketCRCSize            4    //Size of the CRC32 at the end of a CRC32 speed test packet
+#define SpeedTestPacketMaxPayload         4096 //Maximum payload length of a received CRC32 speed test packet
+#define SpeedTestPacketWindow             1024 //Number of previous sequence numbers remembered to tell duplicated packets from out of order packets
+#define SpeedSeriesRxBytes                0    //Time series channel: bytes received per second
+#define SpeedSeriesTxBytes                1    //Time series channel: bytes sent per second
+#define SpeedSeriesRxPackets              2    //Time series channel: packets received in the interval
+#define SpeedSeriesErrors                 3    //Time series channel: errors detected in the interval
+#define SpeedSeriesBufferBytes            4    //Time series channel: bytes waiting in the output buffer
+#define SpeedSeriesChannels               5    //Number of time series channels
 
 /******************************************************************************/
 // Forward declaration of Class, Struct & Unions
@@ -524,8 +587,39 @@ private slots:
     void
     ScriptFinished(
         );
+    void
+    ScriptSendData(
+        const QByteArray &baData
+        );
 #endif
     void
+    on_check_LogIndex_stateChanged(
+        int
+        );
+    void
+    on_btn_LogSearch_clicked(
+        );
+    void
+    on_edit_LogSearch_returnPressed(
+        );
+    void
+    on_list_LogSearch_itemDoubleClicked(
+        QListWidgetItem *lwiItem
+        );
+    void
+    UpdateLogIndex(
+        );
+    void
+    LogIndexStatus(
+        QString strStatus
+        );
+    void
+    LogIndexSearchFinished(
+        QString strQuery,
+        QList<LrdLogIndexHit> lstHits,
+        qint64 intElapsedUs
+        );
+    void
     on_check_SpeedRTS_stateChanged(
         int
         );
@@ -556,6 +650,13 @@ private slots:
     on_btn_SpeedCopy_clicked(
         );
     void
+    on_check_SpeedGraph_stateChanged(
+        int
+        );
+    void
+    on_btn_SpeedExport_clicked(
+        );
+    void
     UpdateSpeedTestValues(
         );
     void
@@ -565,6 +666,18 @@ private slots:
     SpeedTestStopTimer(
         );
     void
+    SpeedTestRateTimer(
+        );
+    void
+    SpeedTestSweepTimer(
+        );
+    void
+    SpeedMatrixTimer(
+        );
+    void
+    SpeedMatrixExit(
+        );
+    void
     UpdateDisplayText(
         );
 
@@ -584,6 +697,9 @@ private:
     DoLineEnd(
         );
     void
+    FlushEchoBuffer(
+        );
+    void
     SerialStatus(
         bool bType
         );
@@ -632,7 +748,6 @@ private:
         );
     void
     SendSpeedTestData(
-        int intMaxLength
         );
     void
     SpeedTestBytesWritten(
@@ -642,6 +757,83 @@ private:
     SpeedTestReceive(
         );
     void
+    SpeedTestVerifyData(
+        const char *pchData,
+        qint64 intLength
+        );
+    void
+    SpeedTestSendLatencyPacket(
+        );
+    void
+    SpeedTestVerifyLatency(
+        const char *pchData,
+        qint64 intLength
+        );
+    void
+    UpdateSpeedTestLatencyValues(
+        );
+    void
+    SpeedTestSendPackets(
+        );
+    void
+    SpeedTestVerifyPackets(
+        const char *pchData,
+        qint64 intLength
+        );
+    void
+    SpeedTestPacketReceived(
+        quint32 intSequence
+        );
+    void
+    UpdateSpeedTestPacketValues(
+        );
+    void
+    UpdateSpeedTestPrbsValues(
+        );
+    quint64
+    SpeedTestErrorCount(
+        );
+    void
+    SpeedTestAddSample(
+        );
+    void
+    SpeedTestBuildSendBuffer(
+        );
+    void
+    SpeedTestSetRate(
+        quint32 intRate
+        );
+    void
+    SpeedTestBeginSending(
+        );
+    void
+    SpeedTestDisplayData(
+        const QByteArray &baData
+        );
+    void
+    SpeedMatrixStart(
+        QString strBaudRates,
+        QString strDataTypes,
+        int intDuration,
+        bool bConfigure
+        );
+    void
+    SpeedMatrixNextBaud(
+        );
+    void
+    SpeedMatrixReopen(
+        );
+    void
+    SpeedMatrixStartRun(
+        );
+    void
+    SpeedMatrixRecordResult(
+        QString strStatus
+        );
+    void
+    SpeedMatrixFinish(
+        );
+    void
     OutputSpeedTestAvgStats(
         unsigned long nsec
         );
@@ -677,6 +869,10 @@ private:
     QTimer gtmrDownloadTimeoutTimer; //Timer for module timeout indication
     LrdLogger *gpMainLog; //Handle to the main log file (if enabled/used)
     bool gbMainLogEnabled; //True if opened successfully (and enabled)
+    LrdLogIndex *gpLogIndex; //Handle to the log search index (runs on gthrLogIndexThread)
+    QThread gthrLogIndexThread; //Background thread that builds and searches the log index
+    QTimer gtmrLogIndexTimer; //Timer for checking for new log data to index
+    QString gstrLogDirectory; //Directory of the log files currently listed on the logs tab
     QMenu *gpMenu; //Main menu
     QMenu *gpSMenu1; //Submenu 1
     QMenu *gpSMenu2; //Submenu 2
@@ -684,6 +880,7 @@ private:
     QMenu *gpBalloonMenu; //Balloon menu
     QMenu *gpSpeedMenu; //Speed testing menu
     bool gbLoopbackMode; //True if loopback mode is enabled
+    LrdScriptRecorder gsrScriptRecorder; //Records data sent and received in the terminal so it can be saved as a script
     bool gbSysTrayEnabled; //True if system tray is enabled
     QSystemTrayIcon *gpSysTray; //Handle for system tray object
     bool gbIsUWCDownload; //Set to true when a UWC is being downloaded
@@ -696,6 +893,7 @@ private:
     quint32 gintStreamBytesRead; //The number of bytes read from the stream
     quint32 gintStreamBytesProgress; //The number of bytes when the next progress output should be made
     QByteArray gbaDisplayBuffer; //Buffer of data to display
+    QByteArray gbaEchoBuffer; //Data sent by scripts which is waiting to be echoed, it is made displayable when it is added to the display buffer
     QElapsedTimer gtmrStreamTimer; //Counts how long a stream takes to send
     QTimer gtmrTextUpdateTimer; //Timer for slower updating of display buffer (but less display freezing)
     bool gbStreamingBatch; //True if batch file is being streamed
@@ -735,23 +933,82 @@ private:
     unsigned char gchSpeedTestMode; //What mode the speed test is (inactive, receive, send or send & receive)
     QElapsedTimer gtmrSpeedTimer; //Used for timing how long a speed test has been running
     QByteArray gbaSpeedDisplayBuffer; //Buffer of data to display for speed test mode
+    quint64 gintSpeedDisplayDropped; //Number of bytes not shown on the speed test display because the display could not keep up (test data is unaffected)
     QByteArray gbaSpeedMatchData; //Expected data to match in speed test mode
-    QByteArray gbaSpeedReceivedData; //Received data from device in speed test mode
+    char gchSpeedReceiveBuffer[SpeedTestReceiveBufferSize]; //Fixed buffer that received data is read into in speed test mode
     QTimer gtmrSpeedTestStats; //Timer that runs every 250ms to update stats for speed test
     QTimer gtmrSpeedTestStats10s; //Timer that runs every 10 seconds to output 10s stats for speed test
     QTimer gtmrSpeedUpdateTimer; //Timer for slower updating of speed test buffer (but less display freezing)
     QTimer *gtmrSpeedTestDelayTimer; //Timer used for delay before sending data in speed test mode
-    quint32 gintSpeedBytesReceived; //Number of bytes received from device in speed test mode
-    quint32 gintSpeedBytesReceived10s; //Number of bytes received from device in the past 10 seconds in speed test mode
-    quint32 gintSpeedBytesSent; //Number of bytes sent to the device in speed test mode
-    quint32 gintSpeedBytesSent10s; //Number of bytes sent to the device in the past 10 seconds in speed test mode
-    quint32 gintSpeedBufferCount; //Number of bytes waiting to be sent to the device (waiting in the buffer) in speed test mode
+    quint64 gintSpeedBytesReceived; //Number of bytes received from device in speed test mode
+    quint64 gintSpeedBytesReceived10s; //Number of bytes received from device in the past 10 seconds in speed test mode
+    quint64 gintSpeedBytesSent; //Number of bytes sent to the device in speed test mode
+    quint64 gintSpeedBytesSent10s; //Number of bytes sent to the device in the past 10 seconds in speed test mode
+    quint64 gintSpeedBufferCount; //Number of bytes waiting to be sent to the device (waiting in the buffer) in speed test mode
     quint32 gintSpeedTestMatchDataLength; //Length of MatchData
-    quint32 gintSpeedTestReceiveIndex; //Current index for RecData
-    quint32 gintSpeedTestStatErrors; //Number of errors in packets recieved in speed test mode
-    quint32 gintSpeedTestStatSuccess; //Number of successful packets received in speed test mode
-    quint32 gintSpeedTestStatPacketsSent; //Numbers of packets sent in speed test mode
-    quint32 gintSpeedTestStatPacketsReceived; //Number of packets received in speed test mode
+    quint32 gintSpeedTestChunkSize; //Number of bytes to send per chunk when speed testing (from the SpeedTestChunkSize setting)
+    quint32 gintSpeedTestLowWater; //When there are less than this number of bytes in the output buffer it will be topped up with another chunk (from the SpeedTestLowWater setting)
+    QByteArray gbaSpeedSendBuffer; //Prebuilt chunk of repeated test data (or packets) which is written with a single call
+    quint32 gintSpeedSendBufferPackets; //Number of copies of the test data in gbaSpeedSendBuffer
+    quint32 gintSpeedRateLimit; //Target rate (in bytes per second) to send speed test data at, 0 sends as fast as possible
+    double gdblSpeedRateTokens; //Number of bytes which may be sent now at the target rate (token bucket)
+    qint64 gintSpeedRateLastTime; //Time (in ns since the start of the test) that the token bucket was last updated
+    QTimer gtmrSpeedRateTimer; //Precise timer that updates the token bucket and sends data when sending at a target rate
+    bool gbSpeedSweepRunning; //True whilst a rate sweep is searching for the highest loss-free rate
+    bool gbSpeedSweepHolding; //True once the settle time has elapsed and the current rate sweep step is being measured
+    quint32 gintSpeedSweepMax; //Highest rate tried in a rate sweep
+    quint32 gintSpeedSweepLow; //Highest rate which has passed in a rate sweep (0 if none)
+    quint32 gintSpeedSweepHigh; //Lowest rate which has failed in a rate sweep
+    quint64 gintSpeedSweepErrors; //Error count at the start of the current rate sweep step
+    quint64 gintSpeedSweepReceived; //Bytes received at the start of the current rate sweep step
+    quint64 gintSpeedSweepSent; //Bytes sent at the start of the current rate sweep step
+    QTimer gtmrSpeedSweepTimer; //Timer for the settle and hold periods of each rate sweep step
+    QString gstrSpeedSweepResult; //Result of the last rate sweep
+    QString gstrSpeedSweepSteps; //Result of each step of the last rate sweep (for the speed test report)
+    bool gbSpeedMatrixRunning; //True whilst a baud rate matrix test is running
+    unsigned char gchSpeedMatrixStage; //Current stage of the baud rate matrix test
+    QStringList glstSpeedMatrixBauds; //Baud rates to test in the baud rate matrix test
+    QList<int> glstSpeedMatrixTypes; //Speed test data types to test at each baud rate in the baud rate matrix test
+    int gintSpeedMatrixBaudIndex; //Index of the baud rate currently being tested
+    int gintSpeedMatrixTypeIndex; //Index of the data type currently being tested
+    int gintSpeedMatrixDuration; //Time (in seconds) to run each test for
+    bool gbSpeedMatrixConfigure; //True if the module baud rate is changed with AT+CFG 520 before each baud rate
+    bool gbSpeedMatrixExit; //True if UwTerminalX should exit once the baud rate matrix test has finished (command line)
+    bool gbSpeedMatrixFailed; //True if any test in the baud rate matrix test could not be run
+    QString gstrSpeedMatrixOutput; //Filename to write the baud rate matrix results to as CSV (command line, empty for none)
+    QStringList glstSpeedMatrixResults; //Results of each baud rate matrix test (CSV rows)
+    QTimer gtmrSpeedMatrixTimer; //Timer for each stage of the baud rate matrix test
+    quint64 gintSpeedTestStatErrors; //Number of errors in packets recieved in speed test mode
+    quint64 gintSpeedTestStatSuccess; //Number of successful packets received in speed test mode
+    quint64 gintSpeedTestStatPacketsSent; //Numbers of packets sent in speed test mode
+    quint64 gintSpeedTestStatPacketsReceived; //Number of packets received in speed test mode
+    QByteArray gbaSpeedLatencyPacket; //Latency speed test packet which is sent (header is updated in place for each packet)
+    QByteArray gbaSpeedPacketBuffer; //Partially received packets in latency speed test mode
+    quint32 gintSpeedLatencySequence; //Sequence number of the last latency speed test packet sent
+    qint64 gintSpeedLatencySentTime; //Time (in us) that the outstanding latency speed test packet was sent (-1 if none are outstanding)
+    quint64 gintSpeedLatencyTimeouts; //Number of latency speed test packets which were not returned in time
+    LrdHistogram ghstSpeedLatency; //Histogram of round-trip times (in us) in latency speed test mode
+    QByteArray gbaSpeedPacket; //CRC32 speed test packet which is sent (sequence number and CRC are updated in place for each packet)
+    quint32 gintSpeedPacketSequence; //Sequence number of the last CRC32 speed test packet sent
+    quint32 gintSpeedPacketNextSequence; //Sequence number of the next expected CRC32 speed test packet
+    bool gbSpeedPacketFirst; //True until the first valid CRC32 speed test packet has been received
+    bool gbSpeedPacketSynced; //False whilst searching for the start of a CRC32 speed test packet after an error
+    quint64 gintSpeedPacketCorruptPending; //Corrupt packets since the last valid packet (these are not counted again as lost)
+    quint64 gintSpeedPacketLost; //Number of CRC32 speed test packets which were never received
+    quint64 gintSpeedPacketCorrupt; //Number of CRC32 speed test packets which failed the CRC check
+    quint64 gintSpeedPacketDuplicate; //Number of CRC32 speed test packets which were received more than once
+    quint64 gintSpeedPacketOutOfOrder; //Number of CRC32 speed test packets which were received after a later packet
+    quint64 gintSpeedPacketSeen[SpeedTestPacketWindow/64]; //Bitmap of sequence numbers received within the window below gintSpeedPacketNextSequence
+    quint64 gintSpeedPacketLostMap[SpeedTestPacketWindow/64]; //Bitmap of skipped sequence numbers within the window which were counted as lost (rather than as corrupt)
+    LrdPrbs gprbSpeedPrbs; //PRBS generator and verifier in PRBS speed test mode
+    LrdDataVerifier gdvSpeedVerifier; //Verifier for received data in string matching speed test mode
+    QByteArray gbaSpeedPrbsData; //Buffer that PRBS data is generated into before sending
+    LrdTimeSeries gtsSpeedSeries; //Per-interval speed test samples used for the graph and export
+    quint64 gintSpeedSeriesLastRx; //Bytes received when the previous time series sample was taken
+    quint64 gintSpeedSeriesLastTx; //Bytes sent when the previous time series sample was taken
+    quint64 gintSpeedSeriesLastPackets; //Packets received when the previous time series sample was taken
+    quint64 gintSpeedSeriesLastErrors; //Errors detected when the previous time series sample was taken
+    qint64 gintSpeedSeriesLastTime; //Time (in ms) the previous time series sample was taken
 
 protected:
     void dragEnterEvent(
@@ -26,6 +26,7 @@
 /******************************************************************************/
 #include "UwxScripting.h"
 #include "ui_UwxScripting.h"
+#include <algorithm>
 
 /******************************************************************************/
 // Local Functions or Private Members
@@ -54,9 +55,24 @@ UwxScripting::UwxScripting(QWidget *parent) : QDialog(parent), ui(new Ui::UwxScr
     //Create highlighter object
     mhlHighlighter = new LrdHighlighter(ui->edit_Script->document());
 
-    //Setup pause timer
-    mtmrPauseTimer.setSingleShot(true);
-    connect(&mtmrPauseTimer, SIGNAL(timeout()), this, SLOT(AdvanceLine()));
+    //Setup script executor, sent data is passed straight on to the main form
+    connect(&mexeScript, SIGNAL(SendData(QByteArray)), this, SIGNAL(SendData(QByteArray)));
+    connect(&mexeScript, SIGNAL(LineChanged(int)), this, SLOT(ScriptLineChanged(int)));
+    connect(&mexeScript, SIGNAL(StatusChanged()), this, SLOT(ScriptStatusChanged()));
+    connect(&mexeScript, SIGNAL(ScriptFinished(bool,QString)), this, SLOT(ScriptExecutionFinished(bool,QString)));
+
+    //Setup fast run mode update timer
+    mbFastRun = false;
+    mtmrFastRunTimer.setInterval(ScriptingFastRunInterval);
+    connect(&mtmrFastRunTimer, SIGNAL(timeout()), this, SLOT(FastRunUpdate()));
+
+    //Setup JavaScript engine
+    mbJavaScript = false;
+    mbJavaScriptEditor = false;
+    connect(&mjsScriptEngine, SIGNAL(SendData(QByteArray)), this, SLOT(JsSendData(QByteArray)));
+    connect(&mjsScriptEngine, SIGNAL(LogMessage(QString)), this, SLOT(JsLogMessage(QString)));
+    connect(&mjsScriptEngine, SIGNAL(ScriptFinished(bool,QString,int)), this, SLOT(JsScriptFinished(bool,QString,int)));
+    connect(ui->edit_Script, SIGNAL(textChanged()), this, SLOT(ScriptTextChanged()));
 
     //Setup status bar update timer
     mtmrUpdateTimer.setSingleShot(false);
@@ -64,7 +80,9 @@ UwxScripting::UwxScripting(QWidget *parent) : QDialog(parent), ui(new Ui::UwxScr
 
     //Script is not currently running or waiting for a data match
     mbIsRunning = false;
-    mbWaitingForReceive = false;
+    mbProfiling = false;
+    mintProfileLine = -1;
+    mintTableRow = -1;
 
     //Set pattern matching for character escaping
 //    reESeq.setPattern("[\\\\]([0-9A-Fa-f]{2})");
@@ -105,6 +123,14 @@ UwxScripting::UwxScripting(QWidget *parent) : QDialog(parent), ui(new Ui::UwxScr
     gpOptionsMenu->addAction("Change Font")->setData(MenuActionChangeFont);
     gpSOptionsMenu1 = gpOptionsMenu->addMenu("Export to");
     gpSOptionsMenu1->addAction("String Player")->setData(MenuActionExportStringPlayer);
+    gpSOptionsMenu1->addAction("Line Profile (CSV)")->setData(MenuActionExportProfile);
+    QAction *qaProfile = gpOptionsMenu->addAction("Profile Lines");
+    qaProfile->setData(MenuActionProfile);
+    qaProfile->setCheckable(true);
+    QAction *qaFastRun = gpOptionsMenu->addAction("Fast Run (Throttle Display Updates)");
+    qaFastRun->setData(MenuActionFastRun);
+    qaFastRun->setCheckable(true);
+    gpOptionsMenu->addAction("Run With Parameter Table (CSV)...")->setData(MenuActionRunTable);
 
     //Connect signals
     connect(gpOptionsMenu, SIGNAL(triggered(QAction*)), this, SLOT(MenuSelected(QAction*)));
@@ -130,7 +156,15 @@ UwxScripting::~UwxScripting(
     )
 {
     //On dialogue deletion
-    disconnect(&mtmrPauseTimer, SIGNAL(timeout()), this, SLOT(AdvanceLine()));
+    disconnect(&mexeScript, SIGNAL(SendData(QByteArray)), this, SIGNAL(SendData(QByteArray)));
+    disconnect(&mexeScript, SIGNAL(LineChanged(int)), this, SLOT(ScriptLineChanged(int)));
+    disconnect(&mexeScript, SIGNAL(StatusChanged()), this, SLOT(ScriptStatusChanged()));
+    disconnect(&mexeScript, SIGNAL(ScriptFinished(bool,QString)), this, SLOT(ScriptExecutionFinished(bool,QString)));
+    disconnect(&mtmrFastRunTimer, SIGNAL(timeout()), this, SLOT(FastRunUpdate()));
+    disconnect(&mjsScriptEngine, SIGNAL(SendData(QByteArray)), this, SLOT(JsSendData(QByteArray)));
+    disconnect(&mjsScriptEngine, SIGNAL(LogMessage(QString)), this, SLOT(JsLogMessage(QString)));
+    disconnect(&mjsScriptEngine, SIGNAL(ScriptFinished(bool,QString,int)), this, SLOT(JsScriptFinished(bool,QString,int)));
+    disconnect(ui->edit_Script, SIGNAL(textChanged()), this, SLOT(ScriptTextChanged()));
     disconnect(gpOptionsMenu, SIGNAL(triggered(QAction*)), this, SLOT(MenuSelected(QAction*)));
     disconnect(qaKeyShortcuts[0], SIGNAL(activated()), this, SLOT(on_btn_Save_clicked()));
     disconnect(qaKeyShortcuts[1], SIGNAL(activated()), this, SLOT(on_btn_Load_clicked()));
@@ -239,58 +273,45 @@ bool
 UwxScripting::on_btn_Compile_clicked(
     )
 {
-    //Compile script
+    //Compile script into the instruction list that is executed
     ui->edit_Script->ClearBadLines();
     mintCLine = -1;
     ui->edit_Script->SetExecutionLine(mintCLine);
-    unsigned int i = 0;
-    bool bFailed = false;
-    if (ui->edit_Script->document()->lineCount() > 0)
+
+    mbJavaScript = LrdScriptCompiler::IsJavaScript(ui->edit_Script->document()->firstBlock().text());
+    if (mbJavaScript == true)
     {
-        //At least one line of data
-        QTextBlock tbCurrentBlock = ui->edit_Script->document()->firstBlock();
-        while (tbCurrentBlock.isValid())
+        //JavaScript script, checked for syntax errors by the engine
+        int intErrorLine = -1;
+        QString strError;
+        bool bFailed = !LrdJsScriptEngine::Compile(ui->edit_Script->toPlainText(), &intErrorLine, &strError);
+        if (bFailed == true && intErrorLine >= 0)
         {
-            int iLineLength = tbCurrentBlock.text().length();
-            if (iLineLength == 1)
-            {
-                //Fail
-                ui->edit_Script->AddBadLine(i);
-                bFailed = true;
-            }
-            else if (iLineLength > 1)
-            {
-                //Check the command
-                if (tbCurrentBlock.text().at(0) == ScriptingWaitTime)
-                {
-                    //Check if the time value is valid or not
-                    bool bConverted = false;
-                    int intConv = tbCurrentBlock.text().right(tbCurrentBlock.text().length()-1).toInt(&bConverted);
-                    if (bConverted == false)
-                    {
-                        //Invalid number
-                        ui->edit_Script->AddBadLine(i);
-                        bFailed = true;
-                    }
-                    else if (intConv <= 0)
-                    {
-                        //Time value is 0 or negative
-                        ui->edit_Script->AddBadLine(i);
-                        bFailed = true;
-                    }
-                }
-                else if (!(tbCurrentBlock.text().at(0) == ScriptingDataOut) && !(tbCurrentBlock.text().at(0) == ScriptingDataIn) && !(tbCurrentBlock.text().at(0) == ScriptingWaitTime) && !(tbCurrentBlock.text().left(2) == ScriptingComment) && QString(tbCurrentBlock.text()).replace("\t", "").replace(" ", "").length() > 0)
-                {
-                    //Text present that isn't space/tab or a valid command
-                    ui->edit_Script->AddBadLine(i);
-                    bFailed = true;
-                }
-            }
-
-            //Progrss to next block
-            tbCurrentBlock = tbCurrentBlock.next();
-            ++i;
+            //Mark invalid line
+            ui->edit_Script->AddBadLine(intErrorLine);
         }
+        msbStatusBar->showMessage((bFailed == false ? QString("JavaScript compile successful: no errors.") : QString("JavaScript compile failed: ").append(strError)));
+        ui->edit_Script->repaint();
+        return bFailed;
+    }
+
+    //Build the line list from the text blocks so that line numbers match block numbers (toPlainText() would also split lines at line separators)
+    QStringList lstLines;
+    QTextBlock tbCurrentBlock = ui->edit_Script->document()->firstBlock();
+    while (tbCurrentBlock.isValid())
+    {
+        lstLines.append(tbCurrentBlock.text());
+        tbCurrentBlock = tbCurrentBlock.next();
+    }
+
+    QList<int> lstBadLines;
+    bool bFailed = !LrdScriptCompiler::Compile(lstLines, &mvecProgram, &lstBadLines);
+    int i = 0;
+    while (i < lstBadLines.count())
+    {
+        //Mark invalid lines
+        ui->edit_Script->AddBadLine(lstBadLines.at(i));
+        ++i;
     }
 
     //Show status bar message
@@ -373,15 +394,15 @@ UwxScripting::SerialPortData(
     )
 {
     //Serial port data received
-    if (mbIsRunning == true)
+    if (mbIsRunning == true && mbJavaScript == true)
     {
-        //Append data
-        mbaRecvData.append(*Data);
-        if (mbWaitingForReceive == true)
-        {
-            //Check if there is a match for this line
-            AdvanceLine();
-        }
+        //Pass to JavaScript engine
+        mjsScriptEngine.DataReceived(*Data);
+    }
+    else if (mbIsRunning == true)
+    {
+        //Pass to script executor, this checks for a match if a line is waiting for data
+        mexeScript.DataReceived(*Data);
     }
 }
 
@@ -394,43 +415,77 @@ UwxScripting::on_btn_Stop_clicked(
     //Stop execution
     if (mbIsRunning == true)
     {
-        //Stop execution and timer
-        mbIsRunning = false;
-        if (mtmrPauseTimer.isActive())
-        {
-            mtmrPauseTimer.stop();
-        }
-
-        //Stop update timer update if running
-        if (mtmrUpdateTimer.isActive())
-        {
-            mtmrUpdateTimer.stop();
-        }
-
-        //Clear buffers
-        mbaRecvData.clear();
-        mbaMatchData.clear();
-        mbWaitingForReceive = false;
+        //Stop execution and timers
+        StopExecution();
 
         //Disable read only mode of editor
         SetButtonStatus(true);
 
-        if (gtmrRecTimer.isValid())
-        {
-            //Invalidate receive timer
-            gtmrRecTimer.invalidate();
-        }
-
         //Show script stopped message
         msbStatusBar->showMessage(QString("Script stopped after ~").append(QString::number(((double)gtmrScriptTimer.elapsed()/1000.0), 'f', 1)).append(" seconds"));
         gtmrScriptTimer.invalidate();
         ui->edit_Script->SetExecutionLineStatus(true);
 
+        if (mintTableRow >= 0)
+        {
+            //Remaining parameter table rows are not run
+            mintTableRow = -1;
+            ShowTableSummary();
+        }
+
         //Notify main form that script is no longer executing
         emit ScriptFinished();
     }
 }
 
+//=============================================================================
+//=============================================================================
+void
+UwxScripting::StopExecution(
+    )
+{
+    //Stops execution and clears the run state, without changing the editor or notifying the main form
+    mbIsRunning = false;
+    mjsScriptEngine.Stop();
+    mexeScript.Stop();
+    ui->btn_Pause->setEnabled(true);
+
+    //Stop update timer update if running
+    if (mtmrUpdateTimer.isActive())
+    {
+        mtmrUpdateTimer.stop();
+    }
+
+    //Include the line that was running in the profile
+    ProfileFinish();
+
+    if (mtmrFastRunTimer.isActive())
+    {
+        //Stop fast run updates and show the line execution stopped on
+        mtmrFastRunTimer.stop();
+        ui->edit_Script->SetExecutionLine(mintCLine);
+    }
+}
+
+//=============================================================================
+//=============================================================================
+void
+UwxScripting::FailScript(
+    const QString &strReason
+    )
+{
+    //Stops the script because it failed on the current line, a parameter table run continues with the next row
+    QString strMessage = QString("Script failed (").append(strReason).append(") after ~").append(QString::number(((double)gtmrScriptTimer.elapsed()/1000.0), 'f', 1)).append(" seconds");
+    if (NextTableRow(false, strReason) == true)
+    {
+        //Next row has been started
+        return;
+    }
+    on_btn_Stop_clicked();
+    ui->edit_Script->SetExecutionLineStatus(true);
+    msbStatusBar->showMessage(strMessage);
+}
+
 //=============================================================================
 //=============================================================================
 void
@@ -438,7 +493,13 @@ UwxScripting::ExportToStringPlayer(
     )
 {
     //Export to stringplayer
-    if (on_btn_Compile_clicked() == false)
+    bool bFailed = on_btn_Compile_clicked();
+    if (bFailed == false && mbJavaScript == true)
+    {
+        //Not possible for JavaScript
+        msbStatusBar->showMessage("StringPlayer export is not available for JavaScript scripts.");
+    }
+    else if (bFailed == false)
     {
         //Compile successful
         QString strSaveFile = QFileDialog::getSaveFileName(this, tr("Save File"), "", "StringPlayer Files (*.sub)");
@@ -474,10 +535,29 @@ UwxScripting::ExportToStringPlayer(
                         //Receive
                         tsDataStream << "WAITRESPEX [vWaitTime] [vPort] \"" << tbCurrentBlock.text().right(tbCurrentBlock.text().length()-1) << "\"\r\n";
                     }
+                    else if (tbCurrentBlock.text().at(0) == ScriptingControl)
+                    {
+                        //Loops, counters and conditions are not supported
+                        tsDataStream << "//Statement not exported: " << tbCurrentBlock.text() << "\r\n";
+                    }
+                    else if (tbCurrentBlock.text().at(0) == ScriptingRegexIn)
+                    {
+                        //Regular expression receive is not supported
+                        tsDataStream << "//Regular expression receive not exported: " << tbCurrentBlock.text().right(tbCurrentBlock.text().length()-1) << "\r\n";
+                    }
                     else if (tbCurrentBlock.text().at(0) == ScriptingWaitTime)
                     {
-                        //Wait for
-                        tsDataStream << "DELAY \"" << tbCurrentBlock.text().right(tbCurrentBlock.text().length()-1) << "\"\r\n";
+                        //Wait for (StringPlayer delays are in ms)
+                        QString strDelay = tbCurrentBlock.text().mid(1).trimmed();
+                        if (strDelay.endsWith("us", Qt::CaseInsensitive))
+                        {
+                            strDelay = QString::number((strDelay.left(strDelay.length()-2).trimmed().toLongLong() + 999)/1000);
+                        }
+                        else if (strDelay.endsWith("ms", Qt::CaseInsensitive))
+                        {
+                            strDelay = strDelay.left(strDelay.length()-2).trimmed();
+                        }
+                        tsDataStream << "DELAY \"" << strDelay << "\"\r\n";
                     }
                     else if (tbCurrentBlock.text().length() == 0)
                     {
@@ -512,123 +592,73 @@ UwxScripting::ExportToStringPlayer(
 //=============================================================================
 //=============================================================================
 void
-UwxScripting::AdvanceLine(
+UwxScripting::ScriptLineChanged(
+    int intLine
     )
 {
-    //Executes the next script line
-    if (mtmrUpdateTimer.isActive() && ucLastAct != ScriptingActionDataIn)
+    //A script line has started executing
+    mintCLine = intLine;
+    if (mbFastRun == false)
     {
-        //Stop pause update timer
-        mtmrUpdateTimer.stop();
+        //Show the line being run, in fast run mode this is left to the fast run timer
+        ui->edit_Script->SetExecutionLine(mintCLine);
     }
 
-    while (mtbExecutionBlock.isValid())
+    if (mbProfiling == true)
     {
-        //Execution block exists
-        ui->edit_Script->SetExecutionLine(mintCLine);
+        //This also ends the timing of the previous instruction
+        ProfileInstruction(intLine);
+    }
+}
 
-        if (mbIsRunning == false)
-        {
-            //Cancelled
-            return;
-        }
-        else if (ui->btn_Pause->isChecked())
+//=============================================================================
+//=============================================================================
+void
+UwxScripting::ScriptStatusChanged(
+    )
+{
+    //The executor has started sending, receiving or waiting, the status bar is updated periodically whilst waiting for data or for a period of time
+    if (mexeScript.Action() == ScriptingActionDataIn && mexeScript.IsWaitingForReceive() == true)
+    {
+        if (!mtmrUpdateTimer.isActive() || mtmrUpdateTimer.interval() != 500)
         {
-            //Execution is paused
-            return;
+            mtmrUpdateTimer.start(500);
         }
+    }
+    else if (mexeScript.Action() == ScriptingActionWaitTime)
+    {
+        mtmrUpdateTimer.start(1000);
+    }
+    else if (mtmrUpdateTimer.isActive())
+    {
+        mtmrUpdateTimer.stop();
+    }
+    UpdateExecutionStatus();
+}
 
-        if (mtbExecutionBlock.text().length() > 0)
-        {
-            //Some data is present
-            if (mtbExecutionBlock.text().at(0) == ScriptingDataOut)
-            {
-                //Clear receive buffer and send data out
-                mbaRecvData.clear();
-                QString strTmpDat(mtbExecutionBlock.text().right(mtbExecutionBlock.text().length()-1));
-                UwxEscape::EscapeCharacters(&strTmpDat);
-
-                //Set the number of bytes remaining to be written to the length of the string (only used if the WaitForWrite checkout is enabled)
-                mbBytesWriteRemain = strTmpDat.length();
-
-                //Pass the data back to the main form
-                emit SendData(strTmpDat, false, true);
-
-                ucLastAct = ScriptingActionDataOut;
-
-                if (ui->check_WaitForWrite->isChecked() == true)
-                {
-                    //Wait for data to leave the buffer
-                    UpdateStatusBar();
-                    return;
-                }
-            }
-            else if (mtbExecutionBlock.text().at(0) == ScriptingDataIn)
-            {
-                //Receive
-                QString strTmpDat = mtbExecutionBlock.text().right(mtbExecutionBlock.text().length()-1);
-                UwxEscape::EscapeCharacters(&strTmpDat);
-                mbaMatchData = strTmpDat.toUtf8();
-                ucLastAct = ScriptingActionDataIn;
-                if (!gtmrRecTimer.isValid())
-                {
-                    //Start timer
-                    gtmrRecTimer.start();
-                    mtmrUpdateTimer.start(500);
-                }
-                if (CheckRecvMatchBuffers() == false)
-                {
-                    //Waiting on a match
-                    if (mbaRecvData.length() > ui->spin_MaxRecBufSize->value())
-                    {
-                        //Buffer is too big, clear and fail the script
-                        QString strMsg = QString("Script failed (expected data not found after ").append(ui->spin_MaxRecBufSize->text()).append(" bytes (").append(QString::number(mbaRecvData.length())).append(" bytes in buffer) after ");
-                        ui->edit_Script->SetExecutionLineStatus(true);
-                        on_btn_Stop_clicked();
-                        strMsg.append(msbStatusBar->currentMessage().right(msbStatusBar->currentMessage().length()-21));
-                        msbStatusBar->showMessage(strMsg);
-                        return;
-                    }
-                    mbWaitingForReceive = true;
-                    UpdateStatusBar();
-                    return;
-                }
-
-                if (gtmrRecTimer.isValid())
-                {
-                    //Stop timer and invalidate it
-                    gtmrRecTimer.invalidate();
-                    mtmrUpdateTimer.stop();
-                }
-            }
-            else if (mtbExecutionBlock.text().at(0) == ScriptingWaitTime)
-            {
-                //Wait for a specified period of time
-                mtmrPauseTimer.start(mtbExecutionBlock.text().right(mtbExecutionBlock.text().length()-1).toUInt());
-                mtbExecutionBlock = mtbExecutionBlock.next();
-                ++mintCLine;
-                ucLastAct = ScriptingActionWaitTime;
-                UpdateStatusBar();
-                mtmrUpdateTimer.start(1000);
-                return;
-            }
-            else
-            {
-                //Comment line
-                ucLastAct = ScriptingActionOther;
-            }
-        }
-        else
-        {
-            //Blank line
-            ucLastAct = ScriptingActionOther;
-        }
-        UpdateStatusBar();
-        mtbExecutionBlock = mtbExecutionBlock.next();
-        ++mintCLine;
+//=============================================================================
+//=============================================================================
+void
+UwxScripting::ScriptExecutionFinished(
+    bool bPassed,
+    const QString &strMessage
+    )
+{
+    //Script has run to completion or failed on the current line
+    if (bPassed == false)
+    {
+        FailScript(strMessage);
+        return;
     }
 
-    //Means execution has finished
+    if (NextTableRow(true, QString()) == true)
+    {
+        //Next parameter table row has been started
+        return;
+    }
+    mtmrFastRunTimer.stop();
+    mtmrUpdateTimer.stop();
+    ProfileFinish();
     mintCLine = -1;
     ui->edit_Script->SetExecutionLine(mintCLine);
     mbIsRunning = false;
@@ -636,8 +666,9 @@ UwxScripting::AdvanceLine(
     //Disable read only mode of editor
     SetButtonStatus(true);
 
-    //Update status bar
-    msbStatusBar->showMessage(QString("Script complete after ~").append(QString::number(((double)gtmrScriptTimer.elapsed()/1000.0), 'f', 1)).append(" seconds"));
+    //Update status bar, with how late waits finished
+    const LrdHistogram *phstWaitJitter = &mexeScript.WaitJitter();
+    msbStatusBar->showMessage(QString("Script complete after ~").append(QString::number(((double)gtmrScriptTimer.elapsed()/1000.0), 'f', 1)).append(" seconds").append(phstWaitJitter->Count() > 0 ? QString(", wait jitter (").append(QString::number(phstWaitJitter->Count())).append(" waits): mean ").append(QString::number(phstWaitJitter->Mean(), 'f', 1)).append("us, p99 ").append(QString::number(phstWaitJitter->Percentile(99.0))).append("us, max ").append(QString::number(phstWaitJitter->Max())).append("us") : QString()));
     gtmrScriptTimer.invalidate();
 
     //Notify main form that script is no longer executing
@@ -651,7 +682,7 @@ UwxScripting::on_btn_Help_clicked(
     )
 {
     //Display help
-    QString strMessage = "UwTerminalX Scripting: This is a simple scripting language for sending/receiving data and waiting for specific periods of time. Each line must begin directly with a valid command and the parameter for that command. Commands are:\r\n    >  Send data out\r\n    <  Wait to receive data\r\n    ~  Wait for a period (in ms)\r\n    // A null-operation comment (used for describing the code)\r\n\r\nValid commands will be highlighed in red and comments in green. Use the check button (yellow warning icon) to check for syntax errors in a script before running it.\r\n\r\nTo the left side of the editor are individual line colours which will change to indicate the following:\r\n    Red:   Syntax error with line (compile failed)\r\n    Green: Currently executing line\r\n    Black: Script execution failed on this line";
+    QString strMessage = "UwTerminalX Scripting: This is a simple scripting language for sending/receiving data and waiting for specific periods of time. Each line must begin directly with a valid command and the parameter for that command. Commands are:\r\n    >  Send data out, ${name} is replaced with the value of a variable\r\n    <  Wait to receive data\r\n    ?  Wait to receive data matching a regular expression, capture groups are stored in variables ${1}, ${2}... and named groups (?<name>...) in ${name}\r\n    ~  Wait for a period (in ms, or in us with a us suffix e.g. ~500us). Consecutive waits are scheduled from the previous deadline so timing errors do not build up\r\n    // A null-operation comment (used for describing the code)\r\n\r\nLoops, counters and conditions:\r\n    #LOOP <count> [name]  Repeat the lines up to #ENDLOOP, ${name} is the iteration number (from 1)\r\n    #BREAK  Leave the current loop\r\n    #IF <value> <==, !=, <, <=, > or >=> <value>  Run the lines up to #ELSE/#ENDIF if true (numbers are compared numerically)\r\n    #ELSE / #ENDIF\r\n    #SET <name> <value>  Set a variable\r\n    #INC <name> [amount] / #DEC <name> [amount]  Add to/subtract from a variable\r\n    #WAITANY <name> <data>|<data>...  Wait to receive whichever alternative arrives first, ${name} is set to its number (from 1), use \\7C for a | in the data\r\n    #PARAM <name> [default]  Declare a parameter, set from each row of a parameter table (CSV file with a header row of names) using Options -> Run With Parameter Table\r\n\r\nValid commands will be highlighed in red and comments in green. Use the check button (yellow warning icon) to check for syntax errors in a script before running it.\r\n\r\nTo the left side of the editor are individual line colours which will change to indicate the following:\r\n    Red:   Syntax error with line (compile failed)\r\n    Green: Currently executing line\r\n    Black: Script execution failed on this line\r\n\r\nJavaScript: scripts starting with a //javascript line are compiled and run by a JavaScript engine with these functions:\r\n    send(data)  Send a string or ArrayBuffer\r\n    expect(pattern[, timeout ms])  Promise resolved with the matched string (or match array for a RegExp) when the data is received. Data is matched as UTF-8 bytes, in a RegExp . and character classes match single bytes\r\n    sleep(ms)  Promise resolved after a period\r\n    log(message)  Show a message in the status bar\r\nReturn the promise chain (e.g. return expect(\"00\").then(...)) so the script finishes, and fails, with it.";
     mFormAuto->SetMessage(&strMessage);
     mFormAuto->show();
 }
@@ -669,115 +700,235 @@ UwxScripting::SetUwTerminalXVersion(
 
 //=============================================================================
 //=============================================================================
-bool
-UwxScripting::CheckRecvMatchBuffers(
+void
+UwxScripting::UpdateExecutionStatus(
+    )
+{
+    //Updates the status bar with the current action, in fast run mode this is left to the fast run timer
+    if (mbFastRun == false)
+    {
+        UpdateStatusBar();
+    }
+}
+
+//=============================================================================
+//=============================================================================
+void
+UwxScripting::FastRunUpdate(
+    )
+{
+    //Shows the current position of the script in fast run mode
+    ui->edit_Script->SetExecutionLine(mintCLine);
+    if (mexeScript.Action() != ScriptingActionDataIn || mexeScript.IsWaitingForReceive() == true)
+    {
+        //Status bar is only updated for receives that are still waiting
+        UpdateStatusBar();
+    }
+}
+
+//=============================================================================
+//=============================================================================
+void
+UwxScripting::JsSendData(
+    const QByteArray &baData
+    )
+{
+    //Data sent by a JavaScript script, pass it back to the main form
+    emit SendData(baData);
+}
+
+//=============================================================================
+//=============================================================================
+void
+UwxScripting::JsLogMessage(
+    const QString &strMessage
+    )
+{
+    //Message logged by a JavaScript script
+    msbStatusBar->showMessage(QString("Script: ").append(strMessage));
+}
+
+//=============================================================================
+//=============================================================================
+void
+UwxScripting::JsScriptFinished(
+    bool bPassed,
+    const QString &strMessage,
+    int intLine
     )
 {
-    //Check if the receive buffer contains the match data
-    if (mbaRecvData.length() >= mbaMatchData.length())
+    //JavaScript script has finished
+    mbIsRunning = false;
+    SetButtonStatus(true);
+    ui->btn_Pause->setEnabled(true);
+    if (bPassed == true)
+    {
+        msbStatusBar->showMessage(QString("Script complete after ~").append(QString::number(((double)gtmrScriptTimer.elapsed()/1000.0), 'f', 1)).append(" seconds"));
+    }
+    else
     {
-        //Length of receive buffer is greater than or equal to the match string, perform search
-        int intPos = mbaRecvData.indexOf(mbaMatchData);
-        if (intPos != -1)
+        if (intLine >= 0)
         {
-            //Data found
-            if (intPos < ui->spin_MaxRecBufSize->value())
-            {
-                //Position OK: shift array and progress to next line
-                mbaRecvData = mbaRecvData.right(mbaRecvData.length() - intPos - mbaMatchData.length());
-                mbWaitingForReceive = false;
-                return true;
-            }
-            else
-            {
-                //Text found but after buffer size limit, return failure
-                return false;
-            }
+            //Show the line that failed
+            mintCLine = intLine;
+            ui->edit_Script->SetExecutionLine(mintCLine);
+            ui->edit_Script->SetExecutionLineStatus(true);
         }
+        msbStatusBar->showMessage(QString("Script failed (").append(strMessage).append(") after ~").append(QString::number(((double)gtmrScriptTimer.elapsed()/1000.0), 'f', 1)).append(" seconds"));
     }
+    gtmrScriptTimer.invalidate();
 
-    //Buffer doesn't contain requested data
-    return false;
+    //Notify main form that script is no longer executing
+    emit ScriptFinished();
 }
 
 //=============================================================================
 //=============================================================================
 void
-UwxScripting::SerialPortWritten(
-    int iWritten
+UwxScripting::ScriptTextChanged(
     )
 {
-    //Serial bytes have been written
-    if (mbIsRunning == true && ui->check_WaitForWrite->isChecked() == true)
+    //Highlight the whole script again if it has changed between a JavaScript and a line script
+    bool bJavaScript = LrdScriptCompiler::IsJavaScript(ui->edit_Script->document()->firstBlock().text());
+    if (bJavaScript != mbJavaScriptEditor)
     {
-        //Remove from the expected number of bytes
-        mbBytesWriteRemain = mbBytesWriteRemain - iWritten;
+        mbJavaScriptEditor = bJavaScript;
+        mhlHighlighter->rehighlight();
+    }
+}
 
-        if (mbBytesWriteRemain <= 0)
-        {
-            //Bytes have been fully written, advance to next line
-            mtbExecutionBlock = mtbExecutionBlock.next();
-            ++mintCLine;
+//=============================================================================
+//=============================================================================
+void
+UwxScripting::ProfileInstruction(
+    int intLine
+    )
+{
+    //Records the time taken by the previous instruction and starts timing the next one. For receive lines this is the response latency of the device
+    qint64 intNow = mtmrProfileTimer.nsecsElapsed();
+    if (mintProfileLine != -1)
+    {
+        mhashProfile[mintProfileLine].Record((quint64)(intNow - mintProfileStart)/1000);
+    }
+    mintProfileLine = intLine;
+    mintProfileStart = intNow;
+}
 
-            //Run the next line
-            AdvanceLine();
-        }
+//=============================================================================
+//=============================================================================
+void
+UwxScripting::ProfileFinish(
+    )
+{
+    //Ends profiling of the last instruction and shows the time spent on each line as a heatmap
+    if (mbProfiling == false)
+    {
+        return;
+    }
+
+    if (mintProfileLine != -1)
+    {
+        mhashProfile[mintProfileLine].Record((quint64)(mtmrProfileTimer.nsecsElapsed() - mintProfileStart)/1000);
+        mintProfileLine = -1;
+    }
+
+    //Scale by the line with the most total time
+    double dblMaxTotal = 0;
+    QHash<int, LrdHistogram>::const_iterator itProfile = mhashProfile.constBegin();
+    while (itProfile != mhashProfile.constEnd())
+    {
+        dblMaxTotal = qMax(dblMaxTotal, itProfile.value().Mean()*itProfile.value().Count());
+        ++itProfile;
+    }
+
+    QHash<int, double> hashHeat;
+    itProfile = mhashProfile.constBegin();
+    while (itProfile != mhashProfile.constEnd())
+    {
+        hashHeat.insert(itProfile.key(), (dblMaxTotal > 0 ? itProfile.value().Mean()*itProfile.value().Count()/dblMaxTotal : 0.0));
+        ++itProfile;
     }
+    ui->edit_Script->SetLineHeat(hashHeat);
 }
 
 //=============================================================================
 //=============================================================================
 void
-UwxScripting::on_btn_Pause_toggled(
-    bool
+UwxScripting::ExportProfile(
     )
 {
-    //Pause status has been changed
-    if (mbIsRunning == true && !ui->btn_Pause->isChecked())
+    //Exports the line profile of the last run as CSV
+    if (mhashProfile.isEmpty())
     {
-        if (ucLastAct == ScriptingActionDataIn)
-        {
-            //Waiting for data to be received
-            AdvanceLine();
-        }
-        else if (ucLastAct == ScriptingActionDataOut)
-        {
-            //Waiting for data to be written
-            if (ui->check_WaitForWrite->isChecked() == true)
-            {
-                if (mbBytesWriteRemain <= 0)
-                {
-                    //Bytes have been fully written, advance to next line
-                    mtbExecutionBlock = mtbExecutionBlock.next();
-                    ++mintCLine;
+        //Nothing to export
+        QString strMessage = tr("No line profile to export: enable Profile Lines in the options menu and run the script first.");
+        mFormAuto->SetMessage(&strMessage);
+        mFormAuto->show();
+        return;
+    }
 
-                    //Run the next line
-                    AdvanceLine();
-                }
-            }
-            else
-            {
-                //Recheck
-                AdvanceLine();
-            }
-        }
-        else if (ucLastAct == ScriptingActionWaitTime)
+    QString strSaveFile = QFileDialog::getSaveFileName(this, tr("Save File"), "", "CSV Files (*.csv)");
+    if (strSaveFile.length() > 1)
+    {
+        //File was selected
+        QFile fileExport(strSaveFile);
+        if (fileExport.open(QFile::WriteOnly | QFile::Text))
         {
-            //Waiting for timer to end
-            if (!mtmrPauseTimer.isActive())
+            //Output a row for each line that was run, in line order
+            QTextStream tsDataStream(&fileExport);
+            tsDataStream << "line,command,hits,total_us,min_us,mean_us,p50_us,p90_us,p99_us,max_us\n";
+            QList<int> lstLines = mhashProfile.keys();
+            std::sort(lstLines.begin(), lstLines.end());
+            int i = 0;
+            while (i < lstLines.count())
             {
-                //Recheck
-                AdvanceLine();
+                const LrdHistogram *phstLine = &mhashProfile[lstLines.at(i)];
+                tsDataStream << (lstLines.at(i) + 1) << ",\"" << ui->edit_Script->document()->findBlockByNumber(lstLines.at(i)).text().replace("\"", "\"\"") << "\"," << phstLine->Count() << "," << QString::number(phstLine->Mean()*phstLine->Count(), 'f', 0) << "," << phstLine->Min() << "," << QString::number(phstLine->Mean(), 'f', 1) << "," << phstLine->Percentile(50.0) << "," << phstLine->Percentile(90.0) << "," << phstLine->Percentile(99.0) << "," << phstLine->Max() << "\n";
+                ++i;
             }
+            fileExport.close();
+
+            //Show message
+            msbStatusBar->showMessage("Line profile export successful!");
         }
         else
         {
-            //Recheck
-            AdvanceLine();
+            //Failed to open file
+            QString strMessage = tr("Error during line profile export: Access to selected file is denied: ").append(strSaveFile);
+            mFormAuto->SetMessage(&strMessage);
+            mFormAuto->show();
         }
     }
 }
 
+//=============================================================================
+//=============================================================================
+void
+UwxScripting::SerialPortWritten(
+    int iWritten
+    )
+{
+    //Serial bytes have been written, the executor runs the next line once all of the sent data has been written (if the WaitForWrite checkbox is enabled)
+    if (mbIsRunning == true && mbJavaScript == false)
+    {
+        mexeScript.DataWritten(iWritten);
+    }
+}
+
+//=============================================================================
+//=============================================================================
+void
+UwxScripting::on_btn_Pause_toggled(
+    bool
+    )
+{
+    //Pause status has been changed, the line being waited on carries on and the script continues from the next line when unpaused
+    if (mbIsRunning == true && mbJavaScript == false)
+    {
+        mexeScript.SetPaused(ui->btn_Pause->isChecked());
+    }
+}
+
 //=============================================================================
 //=============================================================================
 void
@@ -785,30 +936,18 @@ UwxScripting::UpdateStatusBar(
     )
 {
     //Updates status bar with current action
-    if (ucLastAct == ScriptingActionDataIn)
+    if (mexeScript.Action() == ScriptingActionDataIn)
     {
-        //Receiving data
-        double dblRecTimeSec = gtmrRecTimer.nsecsElapsed()/1000000000.0;
-        if ((int)dblRecTimeSec >= ui->spin_MaxRecTime->value())
-        {
-            //Time has expired
-            on_btn_Stop_clicked();
-            msbStatusBar->showMessage(QString("Script failed (expected data not found after ").append(ui->spin_MaxRecTime->text()).append(" seconds)."));
-            ui->edit_Script->SetExecutionLineStatus(true);
-        }
-        else
-        {
-            //Time left
-            msbStatusBar->showMessage(QString("#").append(QString::number(mintCLine+1)).append(": Waiting to receive data (").append(QString::number(mbaRecvData.length())).append(" bytes received in ").append(QString::number(dblRecTimeSec, 'f', 1)).append(" seconds)").append("..."));
-        }
+        //Receiving data, the executor fails the script if it is not received in time
+        msbStatusBar->showMessage(QString("#").append(QString::number(mintCLine+1)).append(": Waiting to receive data (").append(QString::number(mexeScript.ReceiveLength())).append(" bytes received in ").append(QString::number((double)mexeScript.ReceiveElapsed()/1000.0, 'f', 1)).append(" seconds)").append("..."));
     }
-    else if (ucLastAct == ScriptingActionDataOut)
+    else if (mexeScript.Action() == ScriptingActionDataOut)
     {
         //Data output
         if (ui->check_WaitForWrite->isChecked() == true)
         {
             //Sending data and waiting for it to be flushed
-            msbStatusBar->showMessage(QString("#").append(QString::number(mintCLine+1)).append(": Waiting to data to be flushed (").append(QString::number(mbBytesWriteRemain)).append(" bytes remaining)..."));
+            msbStatusBar->showMessage(QString("#").append(QString::number(mintCLine+1)).append(": Waiting to data to be flushed (").append(QString::number(mexeScript.BytesWriteRemaining())).append(" bytes remaining)..."));
         }
         else
         {
@@ -816,10 +955,11 @@ UwxScripting::UpdateStatusBar(
             msbStatusBar->showMessage(QString("#").append(QString::number(mintCLine+1)).append(": Outputting data..."));
         }
     }
-    else if (ucLastAct == ScriptingActionWaitTime)
+    else if (mexeScript.Action() == ScriptingActionWaitTime)
     {
         //Wait period
-        msbStatusBar->showMessage(QString("#").append(QString::number(mintCLine)).append(": Wait period ").append(QString::number(mtmrPauseTimer.interval())).append("ms (").append(QString::number(mtmrPauseTimer.remainingTime())).append("ms left)..."));
+        qint64 intWaitTime = mexeScript.WaitTime();
+        msbStatusBar->showMessage(QString("#").append(QString::number(mintCLine+1)).append(": Wait period ").append(intWaitTime % 1000 == 0 ? QString::number(intWaitTime/1000).append("ms") : QString::number(intWaitTime).append("us")).append(" (").append(QString::number(mexeScript.WaitRemaining())).append("ms left)..."));
     }
     else
     {
@@ -876,6 +1016,43 @@ UwxScripting::MenuSelected(
         //Export to string player
         ExportToStringPlayer();
     }
+    else if (intItem == MenuActionProfile)
+    {
+        //Enable or disable line profiling, results are kept until the next run
+        mbProfiling = qaAction->isChecked();
+        if (mbProfiling == false)
+        {
+            ui->edit_Script->SetLineHeat(QHash<int, double>());
+        }
+    }
+    else if (intItem == MenuActionFastRun)
+    {
+        //Enable or disable fast run mode
+        mbFastRun = qaAction->isChecked();
+        if (mbIsRunning == true)
+        {
+            //Script is running, apply the change immediately
+            if (mbFastRun == true)
+            {
+                mtmrFastRunTimer.start();
+            }
+            else
+            {
+                mtmrFastRunTimer.stop();
+                ui->edit_Script->SetExecutionLine(mintCLine);
+            }
+        }
+    }
+    else if (intItem == MenuActionExportProfile)
+    {
+        //Export line profile
+        ExportProfile();
+    }
+    else if (intItem == MenuActionRunTable)
+    {
+        //Run with a parameter table
+        RunParameterTable();
+    }
 }
 
 //=============================================================================
@@ -958,37 +1135,244 @@ UwxScripting::ScriptStartResult(
     )
 {
     //Result from main window if script execution can begin
-    if (bStatus == true)
+    if (bStatus == true && on_btn_Compile_clicked() == true)
     {
-        //OK to start script execution
-        mintCLine = 0;
-        mtbExecutionBlock = ui->edit_Script->document()->firstBlock();
+        //Script has been changed and no longer compiles (or was started from the command line without being compiled)
+        mintTableRow = -1;
+        emit ScriptFinished();
+    }
+    else if (bStatus == true && mbJavaScript == true)
+    {
+        //OK to start JavaScript execution, pausing is not possible
         mbIsRunning = true;
-
-        //Clear data buffers
-        mbaRecvData.clear();
-        mbaMatchData.clear();
-        mbWaitingForReceive = false;
-
-        //Set editor to be read only
+        mintCLine = -1;
+        mintProfileLine = -1;
         SetButtonStatus(false);
-
-        //Start timer
+        ui->btn_Pause->setEnabled(false);
         gtmrScriptTimer.start();
-
-        //Show start message
-        msbStatusBar->showMessage(QString("Beginning script execution... ").append(QString::number(ui->edit_Script->document()->blockCount())).append(" lines."));
-
-        //Advance to the next (first) line
-        AdvanceLine();
+        msbStatusBar->showMessage("Beginning JavaScript execution...");
+        mjsScriptEngine.Run(ui->edit_Script->toPlainText(), ui->spin_MaxRecTime->value()*1000, ui->spin_MaxRecBufSize->value());
+    }
+    else if (bStatus == true)
+    {
+        //OK to start script execution
+        StartExecution();
     }
     else
     {
         //Terminal is busy or script cannot run now
+        mintTableRow = -1;
         msbStatusBar->showMessage(QString("Failed to start script").append((ucReason == ScriptingReasonPortClosed ? ": Serial port is not open." : (ucReason == ScriptingReasonTermBusy ? ": Terminal currently busy." : QString(", error code: ").append(QString::number(ucReason))))));
     }
 }
 
+//=============================================================================
+//=============================================================================
+void
+UwxScripting::StartExecution(
+    )
+{
+    //Starts running the compiled script from the first instruction
+    mintCLine = 0;
+    mbIsRunning = true;
+
+    //Set the variables and clear the profile
+    QHash<QByteArray, QByteArray> hashVariables;
+    if (mintTableRow >= 0)
+    {
+        //Set the parameters from the parameter table row, escape sequences are processed as in script lines
+        int i = 0;
+        while (i < mlstTableColumns.count())
+        {
+            QByteArray baValue = mlstTableRows.at(mintTableRow).at(i).toUtf8();
+            UwxEscape::EscapeCharacters(&baValue);
+            hashVariables.insert(mlstTableColumns.at(i).toLatin1(), baValue);
+            ++i;
+        }
+    }
+    mhashProfile.clear();
+    mintProfileLine = -1;
+    mtmrProfileTimer.start();
+    ui->edit_Script->SetLineHeat(QHash<int, double>());
+
+    //Set editor to be read only
+    SetButtonStatus(false);
+
+    //Start timer
+    gtmrScriptTimer.start();
+
+    if (mbFastRun == true)
+    {
+        //Execution line and status bar are updated periodically
+        mtmrFastRunTimer.start();
+    }
+
+    //Show start message
+    msbStatusBar->showMessage(QString("Beginning script execution").append(mintTableRow >= 0 ? QString(" (parameter table row ").append(QString::number(mintTableRow + 1)).append(" of ").append(QString::number(mlstTableRows.count())).append(")") : QString()).append("... ").append(QString::number(ui->edit_Script->document()->blockCount())).append(" lines, ").append(QString::number(mvecProgram.count())).append(" instructions."));
+
+    //Run up to the first line that has to wait, the options cannot be changed whilst the script is running
+    mexeScript.SetReceiveLimits(ui->spin_MaxRecTime->value(), ui->spin_MaxRecBufSize->value());
+    mexeScript.SetWaitForWrite(ui->check_WaitForWrite->isChecked());
+    mexeScript.SetPaused(ui->btn_Pause->isChecked());
+    mexeScript.Start(mvecProgram, hashVariables);
+}
+
+//=============================================================================
+//=============================================================================
+void
+UwxScripting::RunParameterTable(
+    )
+{
+    //Runs the script once for each row of a parameter table (CSV file), the script is compiled once and the row values are set as variables before each run
+    if (mbSerialStatus == false)
+    {
+        msbStatusBar->showMessage("Cannot run script: serial port is not open.");
+        return;
+    }
+    else if (on_btn_Compile_clicked() == true)
+    {
+        //Compile failed
+        return;
+    }
+    else if (mbJavaScript == true)
+    {
+        msbStatusBar->showMessage("Parameter tables can only be used with line scripts.");
+        return;
+    }
+
+    QString strFilename = QFileDialog::getOpenFileName(this, "Open Parameter Table", "", "CSV Files (*.csv);;All Files (*.*)");
+    if (strFilename.isEmpty())
+    {
+        return;
+    }
+
+    QString strError;
+    if (LrdScriptCompiler::LoadParameterTable(strFilename, &mlstTableColumns, &mlstTableRows, &strError) == true)
+    {
+        //Parameters without a default value must be in the table
+        int i = 0;
+        while (i < mvecProgram.count())
+        {
+            if (mvecProgram.at(i).ucOpcode == ScriptingOpParam && mvecProgram.at(i).intValue == 0 && !mlstTableColumns.contains(QString(mvecProgram.at(i).baName)))
+            {
+                strError.append(strError.isEmpty() ? "Parameter table does not have a column for parameter(s): " : ", ").append(mvecProgram.at(i).baName);
+            }
+            ++i;
+        }
+    }
+    if (!strError.isEmpty())
+    {
+        mFormAuto->SetMessage(&strError);
+        mFormAuto->show();
+        return;
+    }
+
+    //Rows are run one after another without returning to the main form
+    mstrTableFilename = QFileInfo(strFilename).fileName();
+    mlstTableResults.clear();
+    mintTableRow = 0;
+    msbStatusBar->showMessage("Script execution request pending...");
+    emit ScriptStartRequest();
+}
+
+//=============================================================================
+//=============================================================================
+bool
+UwxScripting::NextTableRow(
+    bool bPassed,
+    const QString &strMessage
+    )
+{
+    //Records the result of a parameter table row when it finishes. Returns true if the next row has been started, otherwise the run is finished as normal and the summary is shown
+    if (mintTableRow < 0)
+    {
+        //Not running a parameter table
+        return false;
+    }
+
+    TableResult trResult;
+    trResult.bPassed = bPassed;
+    trResult.intTime = gtmrScriptTimer.elapsed();
+    trResult.intLine = (bPassed == true ? -1 : mintCLine);
+    trResult.strMessage = strMessage;
+    mlstTableResults.append(trResult);
+
+    ++mintTableRow;
+    if (mintTableRow >= mlstTableRows.count())
+    {
+        //All rows have been run, show the summary once the last run has finished
+        mintTableRow = -1;
+        QTimer::singleShot(0, this, SLOT(ShowTableSummary()));
+        return false;
+    }
+
+    //Clear the run state and start the next row from the event loop
+    StopExecution();
+    mbIsRunning = true;
+    QTimer::singleShot(0, this, SLOT(StartTableRow()));
+    return true;
+}
+
+//=============================================================================
+//=============================================================================
+void
+UwxScripting::StartTableRow(
+    )
+{
+    //Runs the next parameter table row (unless the script was stopped)
+    if (mbIsRunning == true && mintTableRow >= 0)
+    {
+        StartExecution();
+    }
+}
+
+//=============================================================================
+//=============================================================================
+void
+UwxScripting::ShowTableSummary(
+    )
+{
+    //Shows the result and time of each parameter table row
+    int intPassed = 0;
+    qint64 intTotalTime = 0;
+    QString strSummary = QString("Parameter table: ").append(mstrTableFilename).append("\r\n\r\nRow\tResult\tTime (s)\tParameters\r\n");
+    int i = 0;
+    while (i < mlstTableRows.count())
+    {
+        strSummary.append(QString::number(i + 1)).append("\t");
+        if (i < mlstTableResults.count())
+        {
+            const TableResult *trResult = &mlstTableResults.at(i);
+            intPassed += (trResult->bPassed == true ? 1 : 0);
+            intTotalTime += trResult->intTime;
+            strSummary.append(trResult->bPassed == true ? "PASS" : "FAIL").append("\t").append(QString::number((double)trResult->intTime/1000.0, 'f', 3)).append("\t");
+        }
+        else
+        {
+            strSummary.append("NOT RUN\t-\t");
+        }
+
+        int j = 0;
+        while (j < mlstTableColumns.count())
+        {
+            strSummary.append(j > 0 ? ", " : "").append(mlstTableColumns.at(j)).append("=").append(mlstTableRows.at(i).at(j));
+            ++j;
+        }
+        if (i < mlstTableResults.count() && mlstTableResults.at(i).bPassed == false)
+        {
+            strSummary.append("\r\n\t\tline ").append(QString::number(mlstTableResults.at(i).intLine + 1)).append(": ").append(mlstTableResults.at(i).strMessage);
+        }
+        strSummary.append("\r\n");
+        ++i;
+    }
+
+    QString strResult = QString("Parameter table ").append(mlstTableResults.count() == mlstTableRows.count() ? "complete: " : "stopped: ").append(QString::number(intPassed)).append(" of ").append(QString::number(mlstTableRows.count())).append(" rows passed in ~").append(QString::number((double)intTotalTime/1000.0, 'f', 1)).append(" seconds");
+    strSummary.append("\r\n").append(strResult).append(".");
+    msbStatusBar->showMessage(strResult);
+    mFormAuto->SetMessage(&strSummary);
+    mFormAuto->show();
+}
+
 //=============================================================================
 //=============================================================================
 void
@@ -29,6 +29,7 @@
 #include <QDialog>
 #include <QFileDialog>
 #include <QFile>
+#include <QFileInfo>
 #include "LrdHighlighter.h"
 #include <QSerialPort>
 #include <QTimer>
@@ -43,23 +44,25 @@
 #include <QKeySequence>
 #include <QShortcut>
 #include "UwxEscape.h"
+#include "LrdScriptCompiler.h"
+#include "LrdScriptExecutor.h"
+#include <QHash>
+#include "LrdHistogram.h"
+#include "LrdJsScriptEngine.h"
 
 /******************************************************************************/
 // Defines
 /******************************************************************************/
-#define ScriptingDataIn                '<'   //Command that waits for data to be received
-#define ScriptingDataOut               '>'   //Command that sends data out to module
-#define ScriptingWaitTime              '~'   //Command that waits for a period of time (in ms)
-#define ScriptingComment               "//"  //A null-function command that is used to explain/comment code
-#define ScriptingActionDataIn          1     //Action ID when waiting to receive data
-#define ScriptingActionDataOut         2     //Action ID when sending data out
-#define ScriptingActionWaitTime        3     //Action ID when waiting for a period of time
-#define ScriptingActionOther           4     //Action ID when doing no action (empty line/comment)
 #define MenuActionChangeFont           1     //Menu action ID for changing font
 #define MenuActionExportStringPlayer   2     //Menu action ID for exporting to string player
+#define MenuActionProfile              3     //Menu action ID for enabling/disabling line profiling
+#define MenuActionExportProfile        4     //Menu action ID for exporting line profile results
+#define MenuActionFastRun              5     //Menu action ID for enabling/disabling fast run mode
+#define MenuActionRunTable             6     //Menu action ID for running the script with a parameter table
 #define ScriptingReasonOK              0     //Return code for no error
 #define ScriptingReasonPortClosed      1     //Return code if serial port is not open
 #define ScriptingReasonTermBusy        2     //Return code if terminal is busy
+#define ScriptingFastRunInterval       33    //Time (in ms) between execution line and status bar updates in fast run mode (~30Hz)
 
 /******************************************************************************/
 // Forward declaration of Class, Struct & Unions
@@ -153,13 +156,19 @@ private slots:
     ExportToStringPlayer(
         );
     void
-    AdvanceLine(
+    ScriptLineChanged(
+        int intLine
         );
     void
-    on_btn_Help_clicked(
+    ScriptStatusChanged(
         );
-    bool
-    CheckRecvMatchBuffers(
+    void
+    ScriptExecutionFinished(
+        bool bPassed,
+        const QString &strMessage
+        );
+    void
+    on_btn_Help_clicked(
         );
     void
     on_btn_Pause_toggled(
@@ -178,26 +187,100 @@ private slots:
     void
     on_btn_Clear_clicked(
         );
+    void
+    FastRunUpdate(
+        );
+    void
+    JsSendData(
+        const QByteArray &baData
+        );
+    void
+    JsLogMessage(
+        const QString &strMessage
+        );
+    void
+    JsScriptFinished(
+        bool bPassed,
+        const QString &strMessage,
+        int intLine
+        );
+    void
+    ScriptTextChanged(
+        );
+    void
+    StartTableRow(
+        );
+    void
+    ShowTableSummary(
+        );
 
 private:
+    struct TableResult
+    {
+        bool bPassed; //True if the script passed with this row
+        qint64 intTime; //Time (in ms) the script took to run
+        int intLine; //Line (0-based) the script failed on
+        QString strMessage; //Reason the script failed
+    };
+    void
+    StopExecution(
+        );
+    void
+    StartExecution(
+        );
+    void
+    FailScript(
+        const QString &strReason
+        );
+    void
+    RunParameterTable(
+        );
+    bool
+    NextTableRow(
+        bool bPassed,
+        const QString &strMessage
+        );
+    void
+    UpdateExecutionStatus(
+        );
+    void
+    ProfileInstruction(
+        int intLine
+        );
+    void
+    ProfileFinish(
+        );
+    void
+    ExportProfile(
+        );
+
     Ui::UwxScripting *ui;
     PopupMessage *mFormAuto; //Holds handle of error message dialogue
     LrdHighlighter *mhlHighlighter; //Handle for text highlighter
     int mintCLine; //Current line number
-    QTimer mtmrPauseTimer; //Timer used for wait commands
-    QTextBlock mtbExecutionBlock; //Holds the current execution block from the editor
+    QVector<LrdScriptInstruction> mvecProgram; //Compiled script being executed
+    LrdScriptExecutor mexeScript; //Executes the compiled script (shared with the command line runner)
     bool mbIsRunning; //Set to true if the script is running
     QString mstrUwTerminalXVersion; //String containing the UwTerminalX version
-    bool mbWaitingForReceive; //Set to true if waiting in a receive data command for data to arrive
-    QByteArray mbaMatchData; //Buffer containing data that is matched against data received from the module (awating a match)
-    QByteArray mbaRecvData; //Buffer containing data received from the module (awating a match)
-    int mbBytesWriteRemain; //Number of bytes remaining to be written from the buffer (when specific mode is enabled)
+    bool mbProfiling; //True if the time spent on each line is recorded
+    bool mbFastRun; //True if the execution line and status bar are only updated periodically (fast run mode) rather than on every line
+    QTimer mtmrFastRunTimer; //Updates the execution line and status bar in fast run mode
+    LrdJsScriptEngine mjsScriptEngine; //Runs JavaScript scripts
+    bool mbJavaScript; //True if the script was last compiled (and is run) as JavaScript
+    bool mbJavaScriptEditor; //True if the editor contains a JavaScript script (highlighted as such)
+    QString mstrTableFilename; //Filename (without path) of the parameter table being run
+    QStringList mlstTableColumns; //Parameter names (columns) of the parameter table
+    QList<QStringList> mlstTableRows; //Parameter values of each row of the parameter table
+    int mintTableRow; //Parameter table row being run (-1 if not running a parameter table)
+    QList<TableResult> mlstTableResults; //Result of each parameter table row that has been run
+    QHash<int, LrdHistogram> mhashProfile; //Time (in us) spent each time a line was run, by line number
+    QElapsedTimer mtmrProfileTimer; //Times instructions when profiling
+    int mintProfileLine; //Line of the instruction currently being profiled (-1 if none)
+    qint64 mintProfileStart; //Time (in ns) the instruction currently being profiled started
     QStatusBar *msbStatusBar; //Pointer to scripting status bar
     bool mbSerialStatus; //True if serial port is open in main window
-    unsigned char ucLastAct; //Which action is currently being executed
     QTimer mtmrUpdateTimer; //Runs every second when waiting for data or waiting for a timer to elapse to update status bar text
     QElapsedTimer gtmrScriptTimer; //Times how long the script took to execute
-    QElapsedTimer gtmrRecTimer; //Times how long a receive took
     QMenu *gpOptionsMenu; //Options menu
     QMenu *gpSOptionsMenu1; //Options export sub-menu
     QShortcut *qaKeyShortcuts[5]; //Shortcut object handles for various keyboard shortcuts
@@ -208,9 +291,7 @@ signals:
     void ScriptStartRequest(
         );
     void SendData(
-        QString strDataString,
-        bool bEscapeString,
-        bool bFromScripting
+        const QByteArray &baData
         );
 };
 
@@ -26,7 +26,11 @@
 /******************************************************************************/
 #include "UwxMainWindow.h"
 #include <QApplication>
+#include <QCoreApplication>
 #include <QCommandLineParser>
+#ifndef SKIPSCRIPTINGFORM
+#include "LrdScriptRunner.h"
+#endif
 #if TARGET_OS_MAC
 #include <QStyleFactory>
 #endif
@@ -39,6 +43,20 @@ main(
     char *argv[]
     )
 {    
+#ifndef SKIPSCRIPTINGFORM
+    if (LrdScriptRunner::IsHeadless(argc, argv) == true)
+    {
+        //Run a script against a port without creating any widgets and exit with the result
+        QCoreApplication a(argc, argv);
+        LrdScriptRunner srRunner;
+        if (srRunner.Start(QCoreApplication::arguments()) == true)
+        {
+            a.exec();
+        }
+        return srRunner.ExitCode();
+    }
+#endif
+
     QApplication a(argc, argv);
 #if TARGET_OS_MAC
     //Fix for Mac to stop bad styling
@@ -0,0 +1,19 @@
+#LrdDataVerifier QtTest benchmark, feeds 1GB of data through the speed test data verifier
+#Build and run with: qmake && make && make check
+
+QT       += testlib
+QT       -= gui
+
+CONFIG   += console testcase
+CONFIG   -= app_bundle
+
+TARGET = LrdDataVerifierBenchmark
+TEMPLATE = app
+
+INCLUDEPATH += ../..
+
+SOURCES += tst_LrdDataVerifierBenchmark.cpp \
+    ../../LrdDataVerifier.cpp
+
+HEADERS += \
+    ../../LrdDataVerifier.h
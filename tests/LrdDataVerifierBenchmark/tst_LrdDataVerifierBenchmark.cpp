@@ -0,0 +1,138 @@
+/******************************************************************************
+** Copyright (C) 2016 Laird
+**
+** Project: UwTerminalX
+**
+** Module: tst_LrdDataVerifierBenchmark.cpp
+**
+** Notes:
+**
+** License: This program is free software: you can redistribute it and/or
+**          modify it under the terms of the GNU General Public License as
+**          published by the Free Software Foundation, version 3.
+**
+**          This program is distributed in the hope that it will be useful,
+**          but WITHOUT ANY WARRANTY; without even the implied warranty of
+**          MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+**          GNU General Public License for more details.
+**
+**          You should have received a copy of the GNU General Public License
+**          along with this program.  If not, see http://www.gnu.org/licenses/
+**
+*******************************************************************************/
+
+/******************************************************************************/
+// Include Files
+/******************************************************************************/
+#include <QtTest>
+#include "LrdDataVerifier.h"
+
+/******************************************************************************/
+// Defines
+/******************************************************************************/
+#define BenchmarkTotalSize                1073741824 //Amount of data (1GB) fed through the verifier
+#define BenchmarkReadSize                 4096    //Size of each read passed to the verifier, as from the serial port
+#define BenchmarkMatchData                "UwTerminalX speed test data 0123456789\r\n" //Match data, the length does not divide the read size so matches span reads
+
+/******************************************************************************/
+// Class definitions
+/******************************************************************************/
+class LrdDataVerifierBenchmark : public QObject
+{
+    Q_OBJECT
+
+private:
+    QByteArray
+    RepeatedData(
+        qint64 intLength
+        );
+
+private slots:
+    void
+    Mismatches(
+        );
+    void
+    Verify1GB(
+        );
+};
+
+/******************************************************************************/
+// Local Functions or Private Members
+/******************************************************************************/
+QByteArray
+LrdDataVerifierBenchmark::RepeatedData(
+    qint64 intLength
+    )
+{
+    //Returns the match data repeated to fill the length
+    QByteArray baMatchData(BenchmarkMatchData);
+    QByteArray baData;
+    baData.reserve(intLength + baMatchData.length());
+    while (baData.length() < intLength)
+    {
+        baData.append(baMatchData);
+    }
+    baData.truncate(intLength);
+    return baData;
+}
+
+//=============================================================================
+//=============================================================================
+void
+LrdDataVerifierBenchmark::Mismatches(
+    )
+{
+    //Corrupt bytes are counted once each and the verifier resynchronises on the next copy of the match data
+    QByteArray baMatchData(BenchmarkMatchData);
+    QByteArray baData = RepeatedData(baMatchData.length()*10);
+    baData[baMatchData.length()*2 + 5] = '#';
+    baData[baMatchData.length()*7] = '#';
+
+    LrdDataVerifier dvVerifier;
+    dvVerifier.SetMatchData(baMatchData);
+    QList<LrdDataMismatch> lstMismatches;
+    quint64 intMatched = 0;
+    quint64 intErrors = dvVerifier.Verify(baData.constData(), baData.length(), &intMatched, &lstMismatches);
+    QCOMPARE(intErrors, (quint64)2);
+    QCOMPARE(intMatched, (quint64)8);
+    QCOMPARE(lstMismatches.count(), 2);
+    QCOMPARE(lstMismatches.at(0).baExpected, baMatchData);
+}
+
+//=============================================================================
+//=============================================================================
+void
+LrdDataVerifierBenchmark::Verify1GB(
+    )
+{
+    //Feeds 1GB of good data through the verifier in serial port sized reads. The data is reused for each read so only the verifier is measured, reads cycle through a length which is a multiple of both the read size and the match data length so the data stays continuous
+    QByteArray baMatchData(BenchmarkMatchData);
+    QByteArray baData = RepeatedData((baMatchData.length() + 1)*BenchmarkReadSize);
+    LrdDataVerifier dvVerifier;
+    dvVerifier.SetMatchData(baMatchData);
+    quint64 intMatched = 0;
+    quint64 intErrors = 0;
+
+    QBENCHMARK_ONCE
+    {
+        qint64 intFed = 0;
+        qint64 intOffset = 0;
+        while (intFed < BenchmarkTotalSize)
+        {
+            intErrors += dvVerifier.Verify(baData.constData() + intOffset, BenchmarkReadSize, &intMatched);
+            intFed += BenchmarkReadSize;
+            intOffset = (intOffset + BenchmarkReadSize) % (baData.length() - BenchmarkReadSize);
+        }
+    }
+
+    QCOMPARE(intErrors, (quint64)0);
+    QCOMPARE(intMatched, (quint64)(BenchmarkTotalSize/baMatchData.length()));
+}
+
+QTEST_APPLESS_MAIN(LrdDataVerifierBenchmark)
+
+#include "tst_LrdDataVerifierBenchmark.moc"
+
+/******************************************************************************/
+// END OF FILE
+/******************************************************************************/